@@ -0,0 +1,105 @@
+#ifndef X_BENCH_H
+#define X_BENCH_H
+
+#include <stddef.h>  // size_t
+#include <algorithm> // std::max
+#include <chrono>    // std::chrono::steady_clock
+#include <cstdio>    // std::printf, std::snprintf
+#include <string>    // std::string
+#include <thread>    // std::thread::hardware_concurrency
+#include <vector>    // std::vector
+
+// each case runs its body repeatedly for at least xbenchMinSeconds and reports the fastest run,
+// the one least disturbed by the rest of the machine. a benchmark program takes an optional
+// substring as its first argument and then runs only the cases whose name contains it.
+inline const char* xbenchFilter = nullptr;
+inline double xbenchMinSeconds = 0.25;
+
+inline void xbenchInit(int argc, char** argv)
+{
+    if (argc > 1) xbenchFilter = argv[1];
+    std::printf("%-48s %12s %10s\n", "case", "time", "GB/s");
+}
+
+// keeps the compiler from dropping the computation of value
+template<typename T>
+inline void xbenchKeep(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// a single run of body, in seconds, for a case that has to set up its state before every run
+template<typename Body>
+double xbenchOnce(Body&& body)
+{
+    using clock = std::chrono::steady_clock;
+    const clock::time_point start = clock::now();
+    body();
+    return std::chrono::duration<double>(clock::now() - start).count();
+}
+
+// the fastest of at least three runs of body, in seconds
+template<typename Body>
+double xbenchTime(Body&& body)
+{
+    double best = 1e300, total = 0;
+    for (size_t run = 0; run < 3 || total < xbenchMinSeconds; ++run)
+    {
+        const double seconds = xbenchOnce(body);
+        best = seconds < best ? seconds : best;
+        total += seconds;
+    }
+    return best;
+}
+
+// whether the filter selects the case name
+inline bool xbenchSelected(const std::string& name)
+{
+    return !xbenchFilter || name.find(xbenchFilter) != std::string::npos;
+}
+
+// prints one result, with the bandwidth when a run moves bytes bytes
+inline void xbenchReport(const std::string& name, double seconds, double bytes = 0)
+{
+    if (seconds >= 1e-3) std::printf("%-48s %9.3f ms", name.c_str(), seconds * 1e3);
+    else std::printf("%-48s %9.3f us", name.c_str(), seconds * 1e6);
+    if (bytes > 0) std::printf(" %10.2f", bytes / seconds / 1e9);
+    std::printf("\n");
+}
+
+// times body as the case name and reports it
+template<typename Body>
+double xbench(const std::string& name, double bytes, Body&& body)
+{
+    if (!xbenchSelected(name)) return 0;
+
+    const double seconds = xbenchTime(body);
+    xbenchReport(name, seconds, bytes);
+    return seconds;
+}
+
+// thread counts for a scaling benchmark: 1, 2, 4, ... below the hardware's count, then that count
+inline std::vector<size_t> xbenchThreadCounts()
+{
+    const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> counts;
+    for (size_t threads = 1; threads < hardware; threads *= 2) counts.push_back(threads);
+    counts.push_back(hardware);
+    return counts;
+}
+
+// a case name built from parameters, printf style
+template<typename... Args>
+std::string xbenchName(const char* format, Args... args)
+{
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), format, args...);
+    return buffer;
+}
+
+#endif // X_BENCH_H
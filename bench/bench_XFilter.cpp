@@ -0,0 +1,64 @@
+#include <xvc/XFilter.h>
+#include "XBench.h"
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // int8_t, int32_t, uint64_t
+#include <algorithm> // std::remove_if
+
+using xvc::XVector;
+
+// erase_if, the bitmask filter and the erase-remove idiom over 16 MiB at a range of
+// selectivities, from keeping nothing to keeping everything, with random rejections. every run
+// filters a fresh copy of the input, so the copy alone is its own case to subtract.
+template<typename T>
+void benchFilter(const char* type)
+{
+    const size_t bytes = size_t(16) << 20;
+    const size_t n = bytes / sizeof(T);
+    for (unsigned keepPercent : { 0u, 1u, 50u, 90u, 99u, 100u })
+    {
+        XVector<T> input;
+        XVector<uint64_t> mask((n + 63) / 64, 0);
+        input.reserve(n);
+        uint64_t state = 0x9e3779b97f4a7c15ull;
+        for (size_t i = 0; i < n; ++i)
+        {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            const bool keep = (state >> 33) % 100 < keepPercent;
+            input.push_back(T(keep ? 1 : 0));
+            mask[i / 64] |= uint64_t(keep) << (i % 64);
+        }
+        XVector<T> work;
+        auto reject = [](const T& x) { return x == T(0); };
+
+        xbench(xbenchName("copy %u%% kept %s", keepPercent, type), double(bytes), [&] {
+            work = input;
+            xbenchKeep(work);
+        });
+        xbench(xbenchName("std::remove_if %u%% kept %s", keepPercent, type), double(bytes), [&] {
+            work = input;
+            work.erase(std::remove_if(work.begin(), work.end(), reject), work.end());
+            xbenchKeep(work);
+        });
+        xbench(xbenchName("erase_if %u%% kept %s", keepPercent, type), double(bytes), [&] {
+            work = input;
+            xvc::erase_if(work, reject);
+            xbenchKeep(work);
+        });
+        xbench(xbenchName("filter mask %u%% kept %s", keepPercent, type), double(bytes), [&] {
+            work = input;
+            xvc::filter(work, mask);
+            xbenchKeep(work);
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    xbenchInit(argc, argv);
+
+    benchFilter<int8_t>("int8_t");
+    benchFilter<int32_t>("int32_t");
+    benchFilter<double>("double");
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <xvc/XHash.h>
+#include "XBench.h"
+
+#include <stddef.h>      // size_t
+#include <stdint.h>      // uint32_t, uint64_t
+#include <functional>    // std::hash
+#include <string_view>   // std::string_view
+#include <unordered_set> // std::unordered_set
+
+using xvc::XVector;
+
+// what hashing an XVector<uint32_t> key cost before: std::hash of every element, combined
+struct ElementHash
+{
+    size_t operator()(const XVector<uint32_t>& vec) const noexcept
+    {
+        size_t h = vec.size();
+        for (uint32_t x : vec) h ^= std::hash<uint32_t>{}(x) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+        return h;
+    }
+};
+
+// hash_bytes over every piece of a 64 KiB buffer, at key sizes from a few bytes to a whole page,
+// against the element-wise combine and std::hash of a string_view over the same bytes
+void benchThroughput()
+{
+    const size_t total = size_t(64) << 10;
+    XVector<uint32_t> buffer;
+    for (size_t i = 0; i < total / sizeof(uint32_t); ++i) buffer.push_back(static_cast<uint32_t>(i * 2654435761u));
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(buffer.data());
+
+    for (size_t length : { 8, 16, 32, 64, 256, 4096 })
+    {
+        xbench(xbenchName("hash_bytes %zu B", length), double(total), [&] {
+            uint64_t h = 0;
+            for (size_t at = 0; at < total; at += length) h ^= xvc::hash_bytes(bytes + at, length);
+            xbenchKeep(h);
+        });
+        xbench(xbenchName("std::hash<string_view> %zu B", length), double(total), [&] {
+            size_t h = 0;
+            for (size_t at = 0; at < total; at += length)
+                h ^= std::hash<std::string_view>{}(std::string_view(reinterpret_cast<const char*>(bytes + at), length));
+            xbenchKeep(h);
+        });
+        xbench(xbenchName("element combine %zu B", length), double(total), [&] {
+            size_t h = 0;
+            const uint32_t* words = buffer.data();
+            for (size_t at = 0; at < total / sizeof(uint32_t); at += length / sizeof(uint32_t))
+            {
+                size_t k = length / sizeof(uint32_t);
+                for (size_t i = 0; i < length / sizeof(uint32_t); ++i)
+                    k ^= std::hash<uint32_t>{}(words[at + i]) + 0x9e3779b97f4a7c15ull + (k << 6) + (k >> 2);
+                h ^= k;
+            }
+            xbenchKeep(h);
+        });
+    }
+}
+
+// looking up every key of a set of 100000 four-element feature tuples, with std::hash<XVector>
+// and with the element-wise hash
+template<typename Hash>
+void benchLookup(const char* name)
+{
+    std::unordered_set<XVector<uint32_t>, Hash> set;
+    XVector<XVector<uint32_t>> keys;
+    for (uint32_t i = 0; i < 100000; ++i)
+    {
+        keys.push_back(XVector<uint32_t>{ i % 7, i / 7, i * 31, 42 });
+        set.insert(keys.back());
+    }
+
+    xbench(xbenchName("lookup 100000 keys %s", name), 0, [&] {
+        size_t found = 0;
+        for (const XVector<uint32_t>& key : keys) found += set.count(key);
+        xbenchKeep(found);
+    });
+}
+
+int main(int argc, char** argv)
+{
+    xbenchInit(argc, argv);
+
+    benchThroughput();
+    benchLookup<std::hash<XVector<uint32_t>>>("std::hash<XVector>");
+    benchLookup<ElementHash>("element combine");
+    return 0;
+}
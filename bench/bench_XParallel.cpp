@@ -0,0 +1,111 @@
+#include <xvc/XParallel.h>
+#include "XBench.h"
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint64_t
+#include <algorithm> // std::for_each, std::transform, std::copy_if, std::stable_partition
+#include <cmath>     // std::sqrt
+#include <iterator>  // std::back_inserter
+#include <string>    // std::string
+
+using xvc::XVector;
+using xvc::ThreadPool;
+
+// a few dozen flops per element, so the threads never wait on memory
+inline double heavy(double x)
+{
+    for (int i = 0; i < 16; ++i) x = std::sqrt(x * x + 1.0) * 0.5;
+    return x;
+}
+
+// parallel_for_each and parallel_transform from 1 to N threads against the serial std algorithm,
+// once compute-bound over 8 MiB and once memory-bound over 256 MiB. the bandwidth counts every
+// element read and written.
+void benchScaling(const char* kind, size_t bytes, double (*f)(double))
+{
+    const size_t n = bytes / sizeof(double);
+    XVector<double> in(n, 1.5), out(n, 0.0);
+
+    xbench(xbenchName("%s for_each std", kind), double(2 * bytes), [&] {
+        std::for_each(in.begin(), in.end(), [f](double& x) { x = f(x); });
+        xbenchKeep(in);
+    });
+    xbench(xbenchName("%s transform std", kind), double(2 * bytes), [&] {
+        std::transform(in.begin(), in.end(), out.begin(), f);
+        xbenchKeep(out);
+    });
+    for (size_t threads : xbenchThreadCounts())
+    {
+        ThreadPool pool(threads - 1);
+        xbench(xbenchName("%s for_each %zu threads", kind, threads), double(2 * bytes), [&] {
+            xvc::parallel_for_each(in, [f](double& x) { x = f(x); }, 0, pool);
+            xbenchKeep(in);
+        });
+        xbench(xbenchName("%s transform %zu threads", kind, threads), double(2 * bytes), [&] {
+            xvc::parallel_transform(in, out, f, 0, pool);
+            xbenchKeep(out);
+        });
+        xbench(xbenchName("%s transform_into %zu threads", kind, threads), double(2 * bytes), [&] {
+            xvc::transform_into(in, out, f, 0, pool);
+            xbenchKeep(out);
+        });
+    }
+}
+
+// parallel_copy_if and parallel_partition from 1 to N threads against std::copy_if and
+// std::stable_partition over 64 MiB of int with half the elements selected at random. every
+// partition run reorders a fresh copy of the input, so the copy alone is its own case.
+void benchFilterScaling()
+{
+    const size_t bytes = size_t(64) << 20;
+    const size_t n = bytes / sizeof(int);
+    XVector<int> in;
+    in.reserve(n);
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+    for (size_t i = 0; i < n; ++i)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        in.push_back(static_cast<int>(state >> 33));
+    }
+    auto odd = [](int x) { return (x & 1) != 0; };
+    XVector<int> out, work;
+    out.reserve(n);
+
+    xbench("copy_if std", double(2 * bytes), [&] {
+        out.clear();
+        std::copy_if(in.begin(), in.end(), std::back_inserter(out), odd);
+        xbenchKeep(out);
+    });
+    xbench("partition copy", double(2 * bytes), [&] {
+        work = in;
+        xbenchKeep(work);
+    });
+    xbench("partition std", double(2 * bytes), [&] {
+        work = in;
+        std::stable_partition(work.begin(), work.end(), odd);
+        xbenchKeep(work);
+    });
+    for (size_t threads : xbenchThreadCounts())
+    {
+        ThreadPool pool(threads - 1);
+        xbench(xbenchName("copy_if %zu threads", threads), double(2 * bytes), [&] {
+            xvc::parallel_copy_if(in, out, odd, 0, pool);
+            xbenchKeep(out);
+        });
+        xbench(xbenchName("partition %zu threads", threads), double(2 * bytes), [&] {
+            work = in;
+            xvc::parallel_partition(work, odd, 0, pool);
+            xbenchKeep(work);
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    xbenchInit(argc, argv);
+
+    benchScaling("compute", size_t(8) << 20, heavy);
+    benchScaling("memory", size_t(256) << 20, [](double x) { return x + 1.0; });
+    benchFilterScaling();
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include <xvc/XReduce.h>
+#include "XBench.h"
+
+#include <stddef.h> // size_t
+#include <stdint.h> // int8_t, int32_t, int64_t
+
+using xvc::XVector;
+
+// every reduction against the plain loop it replaces, in cache and from memory. the scalar float
+// sum cannot be reordered by the compiler, so it is the one the vector kernels win most on.
+template<typename T>
+void benchReduce(const char* type)
+{
+    for (size_t bytes : { size_t(256) << 10, size_t(64) << 20 })
+    {
+        const size_t n = bytes / sizeof(T);
+        XVector<T> v;
+        v.reserve(n);
+        for (size_t i = 0; i < n; ++i) v.push_back(static_cast<T>(i % 97));
+        v.back() = T(100); // argmax searches to the end
+        const T* data = v.data();
+
+        xbench(xbenchName("sum loop %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+            xvc::sum_t<T> total{};
+            for (size_t i = 0; i < n; ++i) total += data[i];
+            xbenchKeep(total);
+        });
+        xbench(xbenchName("sum %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+            xvc::sum_t<T> total = xvc::sum(v);
+            xbenchKeep(total);
+        });
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            xbench(xbenchName("sum pairwise %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+                T total = xvc::sum(v, xvc::Summation::pairwise);
+                xbenchKeep(total);
+            });
+            xbench(xbenchName("sum kahan %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+                T total = xvc::sum(v, xvc::Summation::kahan);
+                xbenchKeep(total);
+            });
+        }
+        xbench(xbenchName("min loop %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+            T lo = data[0];
+            for (size_t i = 1; i < n; ++i) lo = data[i] < lo ? data[i] : lo;
+            xbenchKeep(lo);
+        });
+        xbench(xbenchName("min %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+            T lo = xvc::min(v);
+            xbenchKeep(lo);
+        });
+        xbench(xbenchName("minmax loop %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+            T lo = data[0], hi = data[0];
+            for (size_t i = 1; i < n; ++i)
+            {
+                lo = data[i] < lo ? data[i] : lo;
+                hi = data[i] > hi ? data[i] : hi;
+            }
+            xbenchKeep(lo);
+            xbenchKeep(hi);
+        });
+        xbench(xbenchName("minmax %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+            std::pair<T, T> both = xvc::minmax(v);
+            xbenchKeep(both);
+        });
+        xbench(xbenchName("argmax loop %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+            size_t at = 0;
+            for (size_t i = 1; i < n; ++i)
+                if (data[i] > data[at]) at = i;
+            xbenchKeep(at);
+        });
+        xbench(xbenchName("argmax %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+            size_t at = xvc::argmax(v);
+            xbenchKeep(at);
+        });
+        xbench(xbenchName("sum par %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+            xvc::sum_t<T> total = xvc::sum(xvc::par, v);
+            xbenchKeep(total);
+        });
+        xbench(xbenchName("minmax par %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+            std::pair<T, T> both = xvc::minmax(xvc::par, v);
+            xbenchKeep(both);
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    xbenchInit(argc, argv);
+
+    benchReduce<int8_t>("int8_t");
+    benchReduce<int32_t>("int32_t");
+    benchReduce<int64_t>("int64_t");
+    benchReduce<float>("float");
+    benchReduce<double>("double");
+    return 0;
+}
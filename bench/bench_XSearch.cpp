@@ -0,0 +1,69 @@
+#include <xvc/XSearch.h>
+#include "XBench.h"
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint8_t, int16_t, int32_t, uint64_t
+#include <algorithm> // std::find, std::find_if, std::count
+
+using xvc::XVector;
+
+// a full scan by each search against its std algorithm over data(), with the value only in the
+// last element, from a buffer that fits L1 to one that streams from memory
+template<typename T>
+void benchSearch(const char* type)
+{
+    for (size_t bytes : { size_t(4) << 10, size_t(256) << 10, size_t(64) << 20 })
+    {
+        const size_t n = bytes / sizeof(T);
+        XVector<T> v(n, T(1));
+        v.back() = T(2);
+        const T* first = v.data();
+        const T* last = v.data() + n;
+
+        xbench(xbenchName("find %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+            const T* p = xvc::find(v, T(2));
+            xbenchKeep(p);
+        });
+        xbench(xbenchName("std::find %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+            const T* p = std::find(first, last, T(2));
+            xbenchKeep(p);
+        });
+        xbench(xbenchName("count %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+            size_t c = xvc::count(v, T(1));
+            xbenchKeep(c);
+        });
+        xbench(xbenchName("std::count %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+            auto c = std::count(first, last, T(1));
+            xbenchKeep(c);
+        });
+        xbench(xbenchName("find_if_equal 4 %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+            const T* p = xvc::find_if_equal(v, { T(2), T(3), T(4), T(5) });
+            xbenchKeep(p);
+        });
+        xbench(xbenchName("std::find_if 4 %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+            const T* p = std::find_if(first, last, [](T x) { return x == T(2) || x == T(3) || x == T(4) || x == T(5); });
+            xbenchKeep(p);
+        });
+        xbench(xbenchName("find_first_not_of %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+            const T* p = xvc::find_first_not_of(v, T(1));
+            xbenchKeep(p);
+        });
+        xbench(xbenchName("std::find_if != %zu KiB %s", bytes >> 10, type), double(bytes), [&] {
+            const T* p = std::find_if(first, last, [](T x) { return x != T(1); });
+            xbenchKeep(p);
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    xbenchInit(argc, argv);
+
+    benchSearch<uint8_t>("uint8_t");
+    benchSearch<int16_t>("int16_t");
+    benchSearch<int32_t>("int32_t");
+    benchSearch<uint64_t>("uint64_t");
+    benchSearch<float>("float");
+    benchSearch<double>("double");
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include <xvc/XSort.h>
+#include "XBench.h"
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint16_t, int32_t, uint32_t, int64_t, uint64_t
+#include <algorithm>  // std::sort, std::stable_sort
+#include <functional> // std::greater
+
+using xvc::XVector;
+using xvc::ThreadPool;
+
+// pseudo-random values over the full range of T, the same on every run
+template<typename T>
+XVector<T> randomValues(size_t n)
+{
+    XVector<T> v;
+    v.reserve(n);
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+    for (size_t i = 0; i < n; ++i)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        if constexpr (std::is_floating_point_v<T>)
+            v.push_back(static_cast<T>(static_cast<int64_t>(state)) * T(1e-9));
+        else
+            v.push_back(static_cast<T>(state ^ (state >> 29)));
+    }
+    return v;
+}
+
+// radix_sort against std::sort at sizes on both sides of the digit width switches. every run
+// sorts a fresh copy of the input, so the copy alone is its own case to subtract.
+template<typename T>
+void benchSort(const char* type)
+{
+    for (size_t n : { size_t(1) << 10, size_t(1) << 16, size_t(1) << 22 })
+    {
+        const XVector<T> input = randomValues<T>(n);
+        XVector<T> work;
+        XVector<T> scratch;
+        const double bytes = double(n * sizeof(T));
+
+        xbench(xbenchName("copy %zu %s", n, type), bytes, [&] {
+            work = input;
+            xbenchKeep(work);
+        });
+        xbench(xbenchName("std::sort %zu %s", n, type), bytes, [&] {
+            work = input;
+            std::sort(work.begin(), work.end());
+            xbenchKeep(work);
+        });
+        xbench(xbenchName("radix_sort %zu %s", n, type), bytes, [&] {
+            work = input;
+            xvc::radix_sort(work, scratch);
+            xbenchKeep(work);
+        });
+    }
+}
+
+struct Record
+{
+    uint32_t key;
+    uint32_t payload[3];
+};
+
+// records by key, where the comparison sort has to be stable to match
+void benchSortByKey()
+{
+    for (size_t n : { size_t(1) << 10, size_t(1) << 16, size_t(1) << 22 })
+    {
+        const XVector<uint32_t> keys = randomValues<uint32_t>(n);
+        XVector<Record> input;
+        input.reserve(n);
+        for (size_t i = 0; i < n; ++i) input.push_back({ keys[i], { uint32_t(i), 0, 0 } });
+        XVector<Record> work;
+        XVector<Record> scratch;
+        const double bytes = double(n * sizeof(Record));
+
+        xbench(xbenchName("std::stable_sort records %zu", n), bytes, [&] {
+            work = input;
+            std::stable_sort(work.begin(), work.end(), [](const Record& a, const Record& b) { return a.key < b.key; });
+            xbenchKeep(work);
+        });
+        xbench(xbenchName("radix_sort records %zu", n), bytes, [&] {
+            work = input;
+            xvc::radix_sort(work, [](const Record& r) { return r.key; }, scratch);
+            xbenchKeep(work);
+        });
+    }
+}
+
+// parallel_sort and parallel_stable_sort from 1 to N threads against std::sort and
+// std::stable_sort, on 2^24 elements: int32_t under std::less takes the parallel radix sort,
+// std::greater and double the run sorts and merges
+template<typename T, typename Compare>
+void benchParallelScaling(const char* kind, Compare comp)
+{
+    const size_t n = size_t(1) << 24;
+    const XVector<T> input = randomValues<T>(n);
+    XVector<T> work;
+    XVector<T> scratch;
+    const double bytes = double(n * sizeof(T));
+
+    xbench(xbenchName("%s std::sort", kind), bytes, [&] {
+        work = input;
+        std::sort(work.begin(), work.end(), comp);
+        xbenchKeep(work);
+    });
+    xbench(xbenchName("%s std::stable_sort", kind), bytes, [&] {
+        work = input;
+        std::stable_sort(work.begin(), work.end(), comp);
+        xbenchKeep(work);
+    });
+    for (size_t threads : xbenchThreadCounts())
+    {
+        ThreadPool pool(threads - 1);
+        xbench(xbenchName("%s parallel_sort %zu threads", kind, threads), bytes, [&] {
+            work = input;
+            xvc::parallel_sort(work, scratch, comp, pool);
+            xbenchKeep(work);
+        });
+        xbench(xbenchName("%s parallel_stable_sort %zu threads", kind, threads), bytes, [&] {
+            work = input;
+            xvc::parallel_stable_sort(work, scratch, comp, pool);
+            xbenchKeep(work);
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    xbenchInit(argc, argv);
+
+    benchSort<uint16_t>("uint16_t");
+    benchSort<int32_t>("int32_t");
+    benchSort<uint64_t>("uint64_t");
+    benchSort<float>("float");
+    benchSort<double>("double");
+    benchSortByKey();
+    benchParallelScaling<int32_t>("int32_t less", std::less<>());
+    benchParallelScaling<int32_t>("int32_t greater", std::greater<>());
+    benchParallelScaling<double>("double less", std::less<>());
+    return 0;
+}
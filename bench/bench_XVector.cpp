@@ -0,0 +1,356 @@
+#include <xvc/XVector.h>
+#include "XBench.h"
+
+#include <stddef.h>     // size_t, ptrdiff_t
+#include <stdint.h>     // uint8_t, uint16_t, int32_t, uint32_t, uint64_t
+#include <algorithm>    // std::fill, std::min, std::lexicographical_compare
+#include <cstring>      // std::memcpy
+#include <deque>        // std::deque
+#include <forward_list> // std::forward_list
+#include <iterator>     // std::input_iterator_tag
+#include <list>         // std::list
+#include <string>       // std::string, std::to_string
+#include <utility>      // std::pair
+#include <vector>       // std::vector
+
+using xvc::XVector;
+
+template<typename T>
+T makeValue(size_t i)
+{
+    if constexpr (std::is_same_v<T, std::string>)
+        return std::string(24, 'b') + std::to_string(i);
+    else if constexpr (std::is_same_v<T, XVector<int>>)
+        return XVector<int>(i % 16 + 1, static_cast<int>(i));
+    else
+        return static_cast<T>(i);
+}
+
+template<typename Vec>
+Vec makeVector(size_t count)
+{
+    Vec v;
+    v.reserve(count);
+    for (size_t i = 0; i < count; ++i) v.push_back(makeValue<typename Vec::value_type>(i));
+    return v;
+}
+
+// single and range inserts into the middle and range erases, each run starting from a copy
+template<typename Vec>
+void benchInsertErase(const char* type)
+{
+    using T = typename Vec::value_type;
+    const size_t n = 100000;
+    const Vec base = makeVector<Vec>(n);
+    const Vec batch = makeVector<Vec>(n / 10);
+    const T value = makeValue<T>(7);
+
+    xbench(xbenchName("insert 1000 x1 mid %s", type), 0, [&] {
+        Vec v = base;
+        for (size_t i = 0; i < 1000; ++i) v.insert(v.begin() + v.size() / 2, value);
+        xbenchKeep(v);
+    });
+    xbench(xbenchName("insert range %zu mid %s", batch.size(), type), 0, [&] {
+        Vec v = base;
+        v.insert(v.begin() + n / 2, batch.begin(), batch.end());
+        xbenchKeep(v);
+    });
+    xbench(xbenchName("erase 1000 x1 front %s", type), 0, [&] {
+        Vec v = base;
+        for (size_t i = 0; i < 1000; ++i) v.erase(v.begin());
+        xbenchKeep(v);
+    });
+    xbench(xbenchName("erase range %zu mid %s", n / 2, type), 0, [&] {
+        Vec v = base;
+        v.erase(v.begin() + n / 4, v.begin() + 3 * n / 4);
+        xbenchKeep(v);
+    });
+}
+
+// a fill loop into reserved capacity: the checked push_back keeps a reallocation call in the loop,
+// the unchecked appends and the BackWriter let the compiler vectorize it
+void benchUncheckedFill()
+{
+    const size_t n = size_t(1) << 20;
+    const double bytes = n * sizeof(int);
+
+    xbench("fill push_back std::vector<int>", bytes, [n] {
+        std::vector<int> v;
+        v.reserve(n);
+        for (size_t i = 0; i < n; ++i) v.push_back(static_cast<int>(i * 3));
+        xbenchKeep(v);
+    });
+    xbench("fill push_back XVector<int>", bytes, [n] {
+        XVector<int> v;
+        v.reserve(n);
+        for (size_t i = 0; i < n; ++i) v.push_back(static_cast<int>(i * 3));
+        xbenchKeep(v);
+    });
+    xbench("fill unchecked_push_back XVector<int>", bytes, [n] {
+        XVector<int> v;
+        v.reserve(n);
+        for (size_t i = 0; i < n; ++i) v.unchecked_push_back(static_cast<int>(i * 3));
+        xbenchKeep(v);
+    });
+    xbench("fill back_writer XVector<int>", bytes, [n] {
+        XVector<int> v;
+        {
+            XVector<int>::BackWriter out = v.back_writer(n);
+            for (size_t i = 0; i < n; ++i) out.push_back(static_cast<int>(i * 3));
+        }
+        xbenchKeep(v);
+    });
+}
+
+// an iterator that only allows a single pass over a pointer range
+struct SinglePass
+{
+    using iterator_category = std::input_iterator_tag;
+    using value_type = int;
+    using difference_type = ptrdiff_t;
+    using pointer = const int*;
+    using reference = const int&;
+
+    const int* p;
+    reference operator*() const { return *p; }
+    SinglePass& operator++() { ++p; return *this; }
+    bool operator==(const SinglePass& other) const { return p == other.p; }
+    bool operator!=(const SinglePass& other) const { return p != other.p; }
+};
+
+// the range constructor from each iterator category, against std::vector's
+template<typename Vec>
+void benchRangeConstructor(const char* type)
+{
+    const size_t n = size_t(1) << 20;
+    const std::vector<int> vec = makeVector<std::vector<int>>(n);
+    const std::deque<int> deque(vec.begin(), vec.end());
+    const std::list<int> list(vec.begin(), vec.end());
+    const std::forward_list<int> forward(vec.begin(), vec.end());
+    const double bytes = n * sizeof(int);
+
+    xbench(xbenchName("construct from pointers %s", type), bytes, [&] { Vec v(vec.data(), vec.data() + n); xbenchKeep(v); });
+    xbench(xbenchName("construct from vector iterators %s", type), bytes, [&] { Vec v(vec.begin(), vec.end()); xbenchKeep(v); });
+    xbench(xbenchName("construct from deque %s", type), bytes, [&] { Vec v(deque.begin(), deque.end()); xbenchKeep(v); });
+    xbench(xbenchName("construct from list %s", type), bytes, [&] { Vec v(list.begin(), list.end()); xbenchKeep(v); });
+    xbench(xbenchName("construct from forward_list %s", type), bytes, [&] { Vec v(forward.begin(), forward.end()); xbenchKeep(v); });
+    xbench(xbenchName("construct from input iterators %s", type), bytes, [&] {
+        Vec v(SinglePass{ vec.data() }, SinglePass{ vec.data() + n });
+        xbenchKeep(v);
+    });
+}
+
+// assign(count, value) through the broadcast fill kernels against std::fill over a std::vector,
+// from cache-sized to streaming-sized buffers
+template<typename T>
+void benchFill(const char* type)
+{
+    for (size_t bytes : { size_t(4) << 10, size_t(256) << 10, size_t(8) << 20, size_t(64) << 20 })
+    {
+        const size_t n = bytes / sizeof(T);
+        XVector<T> x(n, T(1));
+        std::vector<T> s(n, T(1));
+        xbench(xbenchName("fill %zu KiB XVector<%s>::assign", bytes >> 10, type), double(bytes), [&] {
+            x.assign(n, T(3));
+            xbenchKeep(x);
+        });
+        xbench(xbenchName("fill %zu KiB std::fill %s", bytes >> 10, type), double(bytes), [&] {
+            std::fill(s.begin(), s.end(), T(3));
+            xbenchKeep(s);
+        });
+    }
+}
+
+// operator== and operator< over two equal vectors, against the element loop and the
+// std::lexicographical_compare they used before. for integers == was already a memcmp.
+template<typename T>
+void benchCompare(const char* type)
+{
+    for (size_t bytes : { size_t(256) << 10, size_t(64) << 20 })
+    {
+        const size_t n = bytes / sizeof(T);
+        const XVector<T> a(n, T(1)), b(n, T(1));
+        const double both = 2.0 * double(bytes);
+
+        xbench(xbenchName("== loop %zu KiB %s", bytes >> 10, type), both, [&] {
+            bool equal = true;
+            for (size_t i = 0; i < n && equal; ++i) equal = a[i] == b[i];
+            xbenchKeep(equal);
+        });
+        xbench(xbenchName("== %zu KiB %s", bytes >> 10, type), both, [&] {
+            bool equal = a == b;
+            xbenchKeep(equal);
+        });
+        xbench(xbenchName("< std::lexicographical_compare %zu KiB %s", bytes >> 10, type), both, [&] {
+            bool less = std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+            xbenchKeep(less);
+        });
+        xbench(xbenchName("< %zu KiB %s", bytes >> 10, type), both, [&] {
+            bool less = a < b;
+            xbenchKeep(less);
+        });
+    }
+}
+
+// a 64 MiB copy with and without streaming stores, then how long one pass over a 1 MiB working
+// set takes right after it: a cached copy evicts the working set, a streamed one leaves it in place
+void benchStreamCopy()
+{
+    const size_t n = (size_t(64) << 20) / sizeof(uint64_t);
+    const XVector<uint64_t> src(n, 5);
+    std::vector<uint64_t> hot((size_t(1) << 20) / sizeof(uint64_t), 1);
+
+    const std::pair<xvc::StreamMode, const char*> modes[] = { { xvc::StreamMode::never, "cached" },
+                                                              { xvc::StreamMode::always, "streamed" } };
+    for (const auto& [mode, label] : modes)
+    {
+        XVector<uint64_t> from = src;
+        from.set_stream_mode(mode);
+        xbench(xbenchName("copy 64 MiB %s", label), double(n * sizeof(uint64_t)), [&] {
+            XVector<uint64_t> copy(from);
+            xbenchKeep(copy);
+        });
+
+        const std::string name = xbenchName("1 MiB pass after copy 64 MiB %s", label);
+        if (!xbenchSelected(name)) continue;
+        double best = 1e300;
+        for (int round = 0; round < 10; ++round)
+        {
+            uint64_t sum = 0;
+            for (uint64_t x : hot) sum += x; // warms the working set
+            {
+                XVector<uint64_t> copy(from);
+                xbenchKeep(copy);
+            }
+            const double seconds = xbenchOnce([&] {
+                for (uint64_t& x : hot) sum += x++;
+                xbenchKeep(sum);
+            });
+            best = seconds < best ? seconds : best;
+        }
+        xbenchReport(name, best, double(hot.size() * sizeof(uint64_t)));
+    }
+}
+
+// tearing down a vector of nested containers serially and split across the pool, each of the
+// three runs building its vector first
+template<typename T>
+void benchDestroy(const char* type, size_t count)
+{
+    const size_t savedThreshold = xvc::parallel_destroy_threshold;
+    for (size_t threshold : { size_t(0), size_t(1) })
+    {
+        const std::string name = xbenchName("destroy %zu %s %s", count, type, threshold ? "parallel" : "serial");
+        if (!xbenchSelected(name)) continue;
+
+        xvc::parallel_destroy_threshold = threshold;
+        double best = 1e300;
+        for (int run = 0; run < 3; ++run)
+        {
+            auto* v = new XVector<T>();
+            v->reserve(count);
+            for (size_t i = 0; i < count; ++i) v->push_back(makeValue<T>(i));
+            const double seconds = xbenchOnce([v] { delete v; });
+            best = seconds < best ? seconds : best;
+        }
+        xbenchReport(name, best);
+    }
+    xvc::parallel_destroy_threshold = savedThreshold;
+}
+
+// copy and fill bandwidth from 1 to N threads. the parallel bulk operations always use the global
+// pool, so the steps in between split the same work over a pool of that size, one chunk per
+// thread. the last rows are XVector itself with parallel_threshold off and on.
+void benchScaling()
+{
+    const size_t n = (size_t(256) << 20) / sizeof(uint64_t);
+    const double bytes = double(n * sizeof(uint64_t));
+    const XVector<uint64_t> src(n, 5);
+    XVector<uint64_t> dest(n, 0);
+
+    for (size_t threads : xbenchThreadCounts())
+    {
+        xvc::ThreadPool pool(threads - 1);
+        const size_t step = (n + threads - 1) / threads;
+        xbench(xbenchName("copy 256 MiB %zu threads", threads), bytes, [&] {
+            pool.run(threads, [&](size_t i) {
+                const size_t first = std::min(n, i * step), last = std::min(n, first + step);
+                std::memcpy(dest.data() + first, src.data() + first, (last - first) * sizeof(uint64_t));
+            });
+            xbenchKeep(dest);
+        });
+        xbench(xbenchName("fill 256 MiB %zu threads", threads), bytes, [&] {
+            pool.run(threads, [&](size_t i) {
+                const size_t first = std::min(n, i * step), last = std::min(n, first + step);
+                xvc::simd::fillTrivial(dest.data() + first, last - first, uint64_t(3));
+            });
+            xbenchKeep(dest);
+        });
+    }
+
+    const size_t savedThreshold = xvc::parallel_threshold;
+    for (size_t threshold : { size_t(0), size_t(1) })
+    {
+        xvc::parallel_threshold = threshold;
+        const char* label = threshold ? "parallel" : "serial";
+        xbench(xbenchName("XVector copy 256 MiB %s", label), bytes, [&] { dest = src; xbenchKeep(dest); });
+        xbench(xbenchName("XVector fill 256 MiB %s", label), bytes, [&] { dest.assign(n, 3); xbenchKeep(dest); });
+    }
+    xvc::parallel_threshold = savedThreshold;
+}
+
+// each execution policy overload with seq and par over 64 MiB of ints
+template<typename Policy>
+void benchPolicies(Policy policy, const char* label)
+{
+    const size_t n = (size_t(64) << 20) / sizeof(int);
+    const double bytes = double(n * sizeof(int));
+    const XVector<int> src = makeVector<XVector<int>>(n);
+    const XVector<int> same = src;
+    XVector<int> target(n, 0);
+
+    xbench(xbenchName("policy %s copy construct", label), bytes, [&] { XVector<int> v(policy, src); xbenchKeep(v); });
+    xbench(xbenchName("policy %s construct from range", label), bytes, [&] {
+        XVector<int> v(policy, src.begin(), src.end());
+        xbenchKeep(v);
+    });
+    xbench(xbenchName("policy %s construct fill", label), bytes, [&] { XVector<int> v(policy, n, 7); xbenchKeep(v); });
+    xbench(xbenchName("policy %s assign", label), bytes, [&] { target.assign(policy, n, 9); xbenchKeep(target); });
+    xbench(xbenchName("policy %s concatenate", label), bytes, [&] {
+        XVector<int> v;
+        v.concatenate(policy, src);
+        xbenchKeep(v);
+    });
+    xbench(xbenchName("policy %s equal", label), 2 * bytes, [&] {
+        bool equal = xvc::equal(policy, src, same);
+        xbenchKeep(equal);
+    });
+}
+
+int main(int argc, char** argv)
+{
+    xbenchInit(argc, argv);
+
+    benchInsertErase<XVector<int>>("XVector<int>");
+    benchInsertErase<std::vector<int>>("std::vector<int>");
+    benchInsertErase<XVector<std::string>>("XVector<string>");
+    benchInsertErase<std::vector<std::string>>("std::vector<string>");
+    benchUncheckedFill();
+    benchRangeConstructor<XVector<int>>("XVector<int>");
+    benchRangeConstructor<std::vector<int>>("std::vector<int>");
+    benchFill<uint8_t>("uint8_t");
+    benchFill<uint16_t>("uint16_t");
+    benchFill<uint32_t>("uint32_t");
+    benchFill<uint64_t>("uint64_t");
+    benchCompare<uint8_t>("uint8_t");
+    benchCompare<int32_t>("int32_t");
+    benchCompare<float>("float");
+    benchCompare<double>("double");
+    benchStreamCopy();
+    benchDestroy<std::string>("XVector<string>", size_t(1) << 22);
+    benchDestroy<XVector<int>>("XVector<XVector<int>>", size_t(1) << 22);
+    benchScaling();
+    benchPolicies(xvc::seq, "seq");
+    benchPolicies(xvc::par, "par");
+    return 0;
+}
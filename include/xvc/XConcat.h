@@ -0,0 +1,148 @@
+#ifndef X_CONCAT_H
+#define X_CONCAT_H
+
+#include "XVector.h"
+
+#include <stddef.h>    // size_t
+#include <stdint.h>    // SIZE_MAX
+#include <array>       // std::array
+#include <type_traits> // std::is_trivially_copyable_v, std::is_same_v
+#include <cstring>     // std::memcpy
+#include <algorithm>   // std::min, std::max
+
+namespace xvc {
+
+// trivially copyable concatenations of at least this many bytes are copied on the thread pool.
+// like parallel_threshold this is opt-in, the default SIZE_MAX keeps every copy on the calling thread.
+inline size_t concat_parallel_threshold = SIZE_MAX;
+
+// ConcatExpr is the lazy result of a + b + c ... over XVectors. it only records the operands,
+// and materializing it sizes the result once, allocates once and copies each operand into place.
+// the operands must outlive the expression, so keep it to the full expression or convert it
+// to an XVector right away.
+template<typename T, size_t N>
+class ConcatExpr
+{
+private:
+    // member variables
+    std::array<const XVector<T>*, N> parts_;
+
+    // private methods
+    void copyParallel(T* dest, size_t total) const;
+
+    template<typename U, size_t M>
+    friend class ConcatExpr;
+
+public:
+    explicit ConcatExpr(const std::array<const XVector<T>*, N>& parts) noexcept : parts_(parts) {}
+
+    [[nodiscard]] size_t size() const noexcept;
+    [[nodiscard]] XVector<T> eval() const;
+    operator XVector<T>() const { return eval(); }
+
+    ConcatExpr<T, N + 1> operator+(const XVector<T>&) const noexcept;
+    template<size_t M>
+    ConcatExpr<T, N + M> operator+(const ConcatExpr<T, M>&) const noexcept;
+
+    friend ConcatExpr<T, N + 1> operator+(const XVector<T>& left, const ConcatExpr<T, N>& right) noexcept {
+        std::array<const XVector<T>*, N + 1> parts{};
+        parts[0] = &left;
+        for (size_t i = 0; i < N; ++i) parts[i + 1] = right.parts_[i];
+        return ConcatExpr<T, N + 1>(parts);
+    }
+};
+
+template<typename T, size_t N>
+size_t ConcatExpr<T, N>::size() const noexcept
+{
+    size_t total = 0;
+    for (const XVector<T>* part : parts_) total += part->size_;
+    return total;
+}
+
+template<typename T, size_t N>
+void ConcatExpr<T, N>::copyParallel(T* dest, size_t total) const
+{
+    // every chunk copies the element range [begin, end) of the result, which may span several parts
+    detail::parallelChunks(total, detail::parallelMinChunk<T>(), [this, dest](size_t begin, size_t end) {
+        size_t offset = 0;
+        for (const XVector<T>* part : parts_)
+        {
+            const size_t lo = std::max(begin, offset);
+            const size_t hi = std::min(end, offset + part->size_);
+            if (lo < hi) std::memcpy(dest + lo, part->data_ + (lo - offset), (hi - lo) * sizeof(T));
+            offset += part->size_;
+            if (offset >= end) break;
+        }
+    });
+}
+
+template<typename T, size_t N>
+XVector<T> ConcatExpr<T, N>::eval() const
+{
+    const size_t total = size();
+    XVector<T> result(detail::WithCapacity{}, total);
+
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        if (total * sizeof(T) >= concat_parallel_threshold)
+        {
+            copyParallel(result.data_, total);
+        }
+        else
+        {
+            for (const XVector<T>* part : parts_)
+            {
+                if (part->size_) std::memcpy(result.data_ + result.size_, part->data_, part->size_ * sizeof(T));
+                result.size_ += part->size_;
+            }
+        }
+        result.size_ = total;
+    }
+    else
+    {
+        // size_ tracks the finished parts, so a throwing copy only has to unwind the current one
+        for (const XVector<T>* part : parts_)
+        {
+            XVector<T>::uninitCopy(result.data_ + result.size_, part->data_, part->size_);
+            result.size_ += part->size_;
+        }
+    }
+    return result;
+}
+
+template<typename T, size_t N>
+ConcatExpr<T, N + 1> ConcatExpr<T, N>::operator+(const XVector<T>& right) const noexcept
+{
+    std::array<const XVector<T>*, N + 1> parts{};
+    for (size_t i = 0; i < N; ++i) parts[i] = parts_[i];
+    parts[N] = &right;
+    return ConcatExpr<T, N + 1>(parts);
+}
+
+template<typename T, size_t N>
+template<size_t M>
+ConcatExpr<T, N + M> ConcatExpr<T, N>::operator+(const ConcatExpr<T, M>& right) const noexcept
+{
+    std::array<const XVector<T>*, N + M> parts{};
+    for (size_t i = 0; i < N; ++i) parts[i] = parts_[i];
+    for (size_t i = 0; i < M; ++i) parts[N + i] = right.parts_[i];
+    return ConcatExpr<T, N + M>(parts);
+}
+
+template<typename T>
+ConcatExpr<T, 2> operator+(const XVector<T>& left, const XVector<T>& right) noexcept
+{
+    return ConcatExpr<T, 2>({ &left, &right });
+}
+
+template<typename T, typename... Rest>
+ConcatExpr<T, 1 + sizeof...(Rest)> concat(const XVector<T>& first, const Rest&... rest) noexcept
+{
+    static_assert((std::is_same_v<Rest, XVector<T>> && ...), "concat expects XVectors of the same type");
+    return ConcatExpr<T, 1 + sizeof...(Rest)>({ &first, &rest... });
+}
+
+} // namespace xvc
+
+#endif // X_CONCAT_H
@@ -0,0 +1,1056 @@
+#ifndef X_DEVECTOR_H
+#define X_DEVECTOR_H
+
+#include "XVector.h"
+
+#include <stddef.h>    // size_t
+#include <initializer_list> // std::initializer_list
+#include <stdexcept>   // std::out_of_range
+#include <utility>     // std::exchange, std::forward, std::swap
+#include <type_traits> // std::is_nothrow_move_constructible_v, std::is_trivially_copyable_v, std::is_trivially_destructible_v
+#include <new>         // ::operator new, ::operator delete
+#include <iterator>    // std::reverse_iterator
+#include <cstring>     // std::memcpy, std::memmove, std::memcmp
+#include <algorithm>   // std::min, std::move, std::move_backward, std::rotate
+#include <limits>      // std::numeric_limits
+
+namespace xvc {
+
+// XDevector keeps one contiguous buffer with spare capacity on both sides of the elements,
+// so push_front and push_back are both amortized O(1) while data() stays a plain array.
+// layout: [ front_ free slots | size_ elements | capacity_ - front_ - size_ free slots ]
+template<typename T>
+class XDevector
+{
+private:
+    // member variables
+    size_t front_;
+    size_t size_;
+    size_t capacity_;
+    T* buffer_;
+
+    // private methods
+    static void moveInto(T* dest, T* src, size_t count);
+    template<typename It>
+    static void copyInto(T* dest, It src, size_t count);
+    static void fillInto(T* dest, size_t count, const T& value);
+    static void destroy(T* first, size_t count) noexcept;
+    static void slide(T* src, size_t count, T* dest) noexcept;
+    void relocate(size_t newCap, size_t newFront);
+    size_t backSpace() const noexcept;
+    size_t centredFront() const noexcept;
+    void recentre() noexcept;
+    template<typename... Args>
+    void growAndEmplaceBack(Args&&...);
+    template<typename... Args>
+    void growAndEmplaceFront(Args&&...);
+    template<typename Fill>
+    T* insertGap(size_t idx, size_t count, Fill&& fill);
+
+public:
+    // type aliases for STL compatibility
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // constructors and destructor
+    XDevector() noexcept;
+    explicit XDevector(size_t, const T& = T{});
+    template<size_t N>
+    XDevector(T (&a)[N]);
+    XDevector(const XDevector<T>&);
+    XDevector(XDevector<T>&&) noexcept;
+    XDevector(std::initializer_list<T> init);
+    template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    XDevector(InputIt first, InputIt last);
+    ~XDevector();
+
+    // assignment operator
+    XDevector<T>& operator=(const XDevector<T>&);
+    XDevector<T>& operator=(XDevector<T>&&) noexcept;
+
+    // element access
+    T& operator[](size_t) noexcept;
+    const T& operator[](size_t) const noexcept;
+    [[nodiscard]] T& at(size_t n);
+    [[nodiscard]] const T& at(size_t n) const;
+    T& front() noexcept;
+    const T& front() const noexcept;
+    T& back() noexcept;
+    const T& back() const noexcept;
+    [[nodiscard]] T* data() noexcept;
+    [[nodiscard]] const T* data() const noexcept;
+
+    // iterators
+    T* begin() noexcept;
+    const T* begin() const noexcept;
+    T* end() noexcept;
+    const T* end() const noexcept;
+    std::reverse_iterator<T*> rbegin() noexcept;
+    std::reverse_iterator<const T*> rbegin() const noexcept;
+    std::reverse_iterator<T*> rend() noexcept;
+    std::reverse_iterator<const T*> rend() const noexcept;
+
+    // capacity
+    [[nodiscard]] size_t size() const noexcept;
+    [[nodiscard]] size_t max_size() const noexcept;
+    [[nodiscard]] size_t capacity() const noexcept;
+    [[nodiscard]] size_t front_capacity() const noexcept;
+    [[nodiscard]] size_t back_capacity() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+
+    // modifiers
+    void append(const T&);
+    void append(T&&);
+    void push_back(const T&);
+    void push_back(T&&);
+    void pop_back();
+    void push_front(const T&);
+    void push_front(T&&);
+    void pop_front();
+    void concatenate(const XDevector<T>&);
+    void clear() noexcept;
+    void swap(XDevector<T>& other) noexcept;
+    void reserve(size_t);
+    void reserve_front(size_t);
+    void resize(size_t, const T& = T{});
+    void shrink_to_fit();
+    template<typename... Args>
+    void emplace_back(Args&&...);
+    template<typename... Args>
+    void emplace_front(Args&&...);
+    T* insert(const T* pos, const T&);
+    T* insert(const T* pos, T&&);
+    T* insert(const T* pos, size_t count, const T&);
+    template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    T* insert(const T* pos, InputIt first, InputIt last);
+    T* insert(const T* pos, std::initializer_list<T>);
+    template<typename... Args>
+    T* emplace(const T* pos, Args&&...);
+    T* erase(const T* pos);
+    T* erase(const T* first, const T* last);
+
+    friend bool operator==(const XDevector<T>& left, const XDevector<T>& right) {
+        if (left.size_ != right.size_) return false;
+
+        if constexpr (std::has_unique_object_representations_v<T>)
+        {
+            return left.size_ == 0 || std::memcmp(left.data(), right.data(), left.size_ * sizeof(T)) == 0;
+        }
+        else
+        {
+            const T* l = left.data();
+            const T* r = right.data();
+            for (size_t i = 0; i < left.size_; ++i)
+            {
+                if (!(l[i] == r[i])) return false;
+            }
+            return true;
+        }
+    }
+
+    friend bool operator!=(const XDevector<T>& left, const XDevector<T>& right) {
+        return !(left == right);
+    }
+};
+
+template<typename T>
+void XDevector<T>::moveInto(T* dest, T* src, size_t count)
+{
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        if (count) std::memcpy(dest, src, count * sizeof(T));
+    }
+    else if constexpr (std::is_nothrow_move_constructible_v<T>)
+    {
+        for (size_t i = 0; i < count; ++i)
+            new (&dest[i]) T(std::move(src[i]));
+    }
+    else
+    {
+        size_t i = 0;
+        try
+        {
+            for (; i < count; ++i)
+                new (&dest[i]) T(std::move(src[i]));
+        }
+        catch (...)
+        {
+            destroy(dest, i);
+            throw;
+        }
+    }
+}
+
+template<typename T>
+template<typename It>
+void XDevector<T>::copyInto(T* dest, It src, size_t count)
+{
+    if constexpr (std::is_trivially_copyable_v<T> && std::is_pointer_v<It>)
+    {
+        if (count) std::memcpy(dest, src, count * sizeof(T));
+    }
+    else
+    {
+        size_t i = 0;
+        try
+        {
+            for (; i < count; ++i, ++src)
+                new (&dest[i]) T(*src);
+        }
+        catch (...)
+        {
+            destroy(dest, i);
+            throw;
+        }
+    }
+}
+
+template<typename T>
+void XDevector<T>::fillInto(T* dest, size_t count, const T& value)
+{
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        simd::fillTrivial(dest, count, value);
+    }
+    else
+    {
+        size_t i = 0;
+        try
+        {
+            for (; i < count; ++i)
+                new (&dest[i]) T(value);
+        }
+        catch (...)
+        {
+            destroy(dest, i);
+            throw;
+        }
+    }
+}
+
+template<typename T>
+void XDevector<T>::destroy(T* first, size_t count) noexcept
+{
+    if constexpr (!std::is_trivially_destructible_v<T>)
+    {
+        for (size_t i = 0; i < count; ++i)
+            first[i].~T();
+    }
+}
+
+// relocates count elements from src to dest within the buffer, the ranges may overlap. only
+// called with count > 0 for types whose move cannot throw.
+template<typename T>
+void XDevector<T>::slide(T* src, size_t count, T* dest) noexcept
+{
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        if (count) std::memmove(dest, src, count * sizeof(T));
+    }
+    else if (dest < src)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            new (&dest[i]) T(std::move(src[i]));
+            src[i].~T();
+        }
+    }
+    else
+    {
+        for (size_t i = count; i-- > 0;)
+        {
+            new (&dest[i]) T(std::move(src[i]));
+            src[i].~T();
+        }
+    }
+}
+
+template<typename T>
+void XDevector<T>::relocate(size_t newCap, size_t newFront)
+{
+    T* newBuffer = static_cast<T*>(::operator new(newCap * sizeof(T)));
+
+    try
+    {
+        moveInto(newBuffer + newFront, data(), size_);
+    }
+    catch (...)
+    {
+        ::operator delete(newBuffer);
+        throw;
+    }
+
+    destroy(data(), size_);
+    ::operator delete(buffer_);
+
+    buffer_ = newBuffer;
+    front_ = newFront;
+    capacity_ = newCap;
+}
+
+template<typename T>
+size_t XDevector<T>::backSpace() const noexcept
+{
+    return capacity_ - front_ - size_;
+}
+
+// where the elements start when the free slots are split evenly between both ends
+template<typename T>
+size_t XDevector<T>::centredFront() const noexcept
+{
+    return (capacity_ - size_) / 2;
+}
+
+// slides the elements to centredFront() within the buffer, for types whose move cannot throw
+template<typename T>
+void XDevector<T>::recentre() noexcept
+{
+    slide(data(), size_, buffer_ + centredFront());
+    front_ = centredFront();
+}
+
+// a buffer at most half full that runs out of room at one end, like a queue pushing at one end
+// and popping at the other, has its elements centred again instead of doubling. that costs
+// size_ moves for at least capacity_ / 4 pushes, so the capacity stays bounded and pushes stay
+// amortized O(1). types whose move can throw get a new buffer of the same capacity instead.
+template<typename T>
+template<typename... Args>
+void XDevector<T>::growAndEmplaceBack(Args&&... args)
+{
+    // otherwise the front gap is kept as is, all growth goes to the back
+    size_t newCap = capacity_ ? capacity_ * 2 : 1;
+    size_t newFront = front_;
+    if (size_ < capacity_ / 2)
+    {
+        if constexpr (std::is_nothrow_move_constructible_v<T>)
+        {
+            T item(std::forward<Args>(args)...); // args may refer to an element that moves
+            recentre();
+            new (&buffer_[front_ + size_]) T(std::move(item));
+            ++size_;
+            return;
+        }
+        newCap = capacity_;
+        newFront = centredFront();
+    }
+    T* newBuffer = static_cast<T*>(::operator new(newCap * sizeof(T)));
+
+    // construct the new element first so args may alias an existing element
+    try
+    {
+        new (&newBuffer[newFront + size_]) T(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        ::operator delete(newBuffer);
+        throw;
+    }
+
+    try
+    {
+        moveInto(newBuffer + newFront, data(), size_);
+    }
+    catch (...)
+    {
+        destroy(newBuffer + newFront + size_, 1);
+        ::operator delete(newBuffer);
+        throw;
+    }
+
+    destroy(data(), size_);
+    ::operator delete(buffer_);
+
+    buffer_ = newBuffer;
+    capacity_ = newCap;
+    front_ = newFront;
+    ++size_;
+}
+
+template<typename T>
+template<typename... Args>
+void XDevector<T>::growAndEmplaceFront(Args&&... args)
+{
+    // recentred like growAndEmplaceBack, otherwise the back gap is kept as is and all growth goes
+    // to the front
+    size_t newCap = capacity_ ? capacity_ * 2 : 1;
+    size_t newFront = newCap - backSpace() - size_;
+    if (size_ < capacity_ / 2)
+    {
+        if constexpr (std::is_nothrow_move_constructible_v<T>)
+        {
+            T item(std::forward<Args>(args)...);
+            recentre();
+            new (&buffer_[front_ - 1]) T(std::move(item));
+            --front_;
+            ++size_;
+            return;
+        }
+        newCap = capacity_;
+        newFront = centredFront();
+    }
+    T* newBuffer = static_cast<T*>(::operator new(newCap * sizeof(T)));
+
+    try
+    {
+        new (&newBuffer[newFront - 1]) T(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        ::operator delete(newBuffer);
+        throw;
+    }
+
+    try
+    {
+        moveInto(newBuffer + newFront, data(), size_);
+    }
+    catch (...)
+    {
+        destroy(newBuffer + newFront - 1, 1);
+        ::operator delete(newBuffer);
+        throw;
+    }
+
+    destroy(data(), size_);
+    ::operator delete(buffer_);
+
+    buffer_ = newBuffer;
+    capacity_ = newCap;
+    front_ = newFront - 1;
+    ++size_;
+}
+
+// opens count uninitialized slots at idx and lets fill construct them, fill must clean up after
+// itself if it throws. the shorter side of idx slides out of the way if its end has room, the
+// longer one if only that end has room, and a new buffer is built when neither has. types whose
+// move can throw only slide when nothing has to move, so a throw leaves the elements untouched.
+template<typename T>
+template<typename Fill>
+T* XDevector<T>::insertGap(size_t idx, size_t count, Fill&& fill)
+{
+    if (count == 0) return data() + idx;
+
+    constexpr bool slides = std::is_trivially_copyable_v<T> || std::is_nothrow_move_constructible_v<T>;
+    const bool frontFits = front_ >= count && (slides || idx == 0);
+    const bool backFits = backSpace() >= count && (slides || idx == size_);
+
+    if (frontFits && (idx < size_ - idx || !backFits))
+    {
+        T* first = buffer_ + front_;
+        slide(first, idx, first - count);
+        try
+        {
+            fill(first - count + idx);
+        }
+        catch (...)
+        {
+            slide(first - count, idx, first); // close the gap again
+            throw;
+        }
+        front_ -= count;
+    }
+    else if (backFits)
+    {
+        T* at = buffer_ + front_ + idx;
+        slide(at, size_ - idx, at + count);
+        try
+        {
+            fill(at);
+        }
+        catch (...)
+        {
+            slide(at + count, size_ - idx, at);
+            throw;
+        }
+    }
+    else
+    {
+        const size_t newCap = detail::nextPowerOf2(front_ + size_ + count);
+        T* newBuffer = static_cast<T*>(::operator new(newCap * sizeof(T)));
+        T* dest = newBuffer + front_;
+
+        // fill first, the source of the new elements may still point into the old buffer
+        try
+        {
+            fill(dest + idx);
+        }
+        catch (...)
+        {
+            ::operator delete(newBuffer);
+            throw;
+        }
+
+        size_t moved = 0;
+        try
+        {
+            moveInto(dest, data(), idx);
+            moved = idx;
+            moveInto(dest + idx + count, data() + idx, size_ - idx);
+        }
+        catch (...)
+        {
+            destroy(dest, moved);
+            destroy(dest + idx, count);
+            ::operator delete(newBuffer);
+            throw;
+        }
+
+        destroy(data(), size_);
+        ::operator delete(buffer_);
+
+        buffer_ = newBuffer;
+        capacity_ = newCap;
+    }
+
+    size_ += count;
+    return data() + idx;
+}
+
+template<typename T>
+XDevector<T>::XDevector() noexcept
+    : front_(0), size_(0), capacity_(0), buffer_(nullptr) {}
+
+template<typename T>
+XDevector<T>::XDevector(size_t count, const T& value)
+    : front_(0), size_(0), capacity_(detail::nextPowerOf2(count)), buffer_(static_cast<T*>(::operator new(capacity_ * sizeof(T))))
+{
+    try
+    {
+        fillInto(buffer_, count, value);
+    }
+    catch (...)
+    {
+        ::operator delete(buffer_);
+        throw;
+    }
+    size_ = count;
+}
+
+template<typename T>
+template<size_t N>
+XDevector<T>::XDevector(T (&a)[N])
+    : front_(0), size_(N), capacity_(detail::nextPowerOf2(N)), buffer_(static_cast<T*>(::operator new(capacity_ * sizeof(T))))
+{
+    try
+    {
+        copyInto(buffer_, static_cast<const T*>(a), N);
+    }
+    catch (...)
+    {
+        ::operator delete(buffer_);
+        throw;
+    }
+}
+
+template<typename T>
+XDevector<T>::XDevector(const XDevector<T>& other)
+    : front_(other.front_), size_(other.size_), capacity_(other.capacity_),
+      buffer_(capacity_ ? static_cast<T*>(::operator new(capacity_ * sizeof(T))) : nullptr)
+{
+    try
+    {
+        copyInto(buffer_ + front_, other.data(), size_);
+    }
+    catch (...)
+    {
+        ::operator delete(buffer_);
+        throw;
+    }
+}
+
+template<typename T>
+XDevector<T>::XDevector(XDevector<T>&& other) noexcept
+    : front_(std::exchange(other.front_, 0)), size_(std::exchange(other.size_, 0)),
+      capacity_(std::exchange(other.capacity_, 0)), buffer_(std::exchange(other.buffer_, nullptr)) {}
+
+template<typename T>
+XDevector<T>::XDevector(std::initializer_list<T> init)
+    : front_(0), size_(init.size()), capacity_(detail::nextPowerOf2(init.size())),
+      buffer_(static_cast<T*>(::operator new(capacity_ * sizeof(T))))
+{
+    try
+    {
+        copyInto(buffer_, init.begin(), size_);
+    }
+    catch (...)
+    {
+        ::operator delete(buffer_);
+        throw;
+    }
+}
+
+template<typename T>
+template<typename InputIt, typename>
+XDevector<T>::XDevector(InputIt first, InputIt last)
+    : XDevector()
+{
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
+
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+        // multi-pass iterators can pre-calculate size
+        const size_t count = static_cast<size_t>(std::distance(first, last));
+        capacity_ = detail::nextPowerOf2(count);
+        buffer_ = static_cast<T*>(::operator new(capacity_ * sizeof(T)));
+        try {
+            copyInto(buffer_, first, count);
+        } catch (...) {
+            ::operator delete(buffer_);
+            throw;
+        }
+        size_ = count;
+    } else {
+        // other iterators grow as we go
+        try {
+            for (; first != last; ++first)
+                emplace_back(*first);
+        } catch (...) {
+            destroy(data(), size_);
+            ::operator delete(buffer_);
+            throw;
+        }
+    }
+}
+
+template<typename T>
+XDevector<T>::~XDevector()
+{
+    destroy(data(), size_);
+    ::operator delete(buffer_);
+}
+
+template<typename T>
+XDevector<T>& XDevector<T>::operator=(const XDevector<T>& other)
+{
+    if (this != &other)
+    {
+        if (other.size_ <= capacity_)
+        {
+            // reuse the buffer, centering the elements in it
+            clear();
+            front_ = (capacity_ - other.size_) / 2;
+            copyInto(buffer_ + front_, other.data(), other.size_);
+            size_ = other.size_;
+        }
+        else
+        {
+            XDevector<T> tmp(other); // for exception safety
+            swap(tmp);
+        }
+    }
+    return *this;
+}
+
+template<typename T>
+XDevector<T>& XDevector<T>::operator=(XDevector<T>&& other) noexcept
+{
+    if (this != &other)
+    {
+        destroy(data(), size_);
+        ::operator delete(buffer_);
+
+        front_ = std::exchange(other.front_, 0);
+        size_ = std::exchange(other.size_, 0);
+        capacity_ = std::exchange(other.capacity_, 0);
+        buffer_ = std::exchange(other.buffer_, nullptr);
+    }
+    return *this;
+}
+
+template<typename T>
+T& XDevector<T>::operator[](size_t idx) noexcept {
+    XVECTOR_BOUNDS_CHECK(idx);
+    return buffer_[front_ + idx]; // no bounds checking for performance
+}
+
+template<typename T>
+const T& XDevector<T>::operator[](size_t idx) const noexcept {
+    XVECTOR_BOUNDS_CHECK(idx);
+    return buffer_[front_ + idx];
+}
+
+template<typename T>
+T& XDevector<T>::at(size_t idx)
+{
+    if (idx >= size_) throw std::out_of_range("XDevector index out of bounds.");
+
+    return buffer_[front_ + idx];
+}
+
+template<typename T>
+const T& XDevector<T>::at(size_t idx) const
+{
+    if (idx >= size_) throw std::out_of_range("XDevector index out of bounds.");
+
+    return buffer_[front_ + idx];
+}
+
+template<typename T>
+T& XDevector<T>::front() noexcept {
+    XVECTOR_EMPTY_CHECK();
+    return buffer_[front_];
+}
+
+template<typename T>
+const T& XDevector<T>::front() const noexcept {
+    XVECTOR_EMPTY_CHECK();
+    return buffer_[front_];
+}
+
+template<typename T>
+T& XDevector<T>::back() noexcept {
+    XVECTOR_EMPTY_CHECK();
+    return buffer_[front_ + size_ - 1];
+}
+
+template<typename T>
+const T& XDevector<T>::back() const noexcept {
+    XVECTOR_EMPTY_CHECK();
+    return buffer_[front_ + size_ - 1];
+}
+
+template<typename T>
+T* XDevector<T>::data() noexcept { return (buffer_ ? buffer_ + front_ : nullptr); }
+
+template<typename T>
+const T* XDevector<T>::data() const noexcept { return (buffer_ ? buffer_ + front_ : nullptr); }
+
+template<typename T>
+T* XDevector<T>::begin() noexcept { return data(); }
+
+template<typename T>
+const T* XDevector<T>::begin() const noexcept { return data(); }
+
+template<typename T>
+T* XDevector<T>::end() noexcept { return (buffer_ ? buffer_ + front_ + size_ : nullptr); }
+
+template<typename T>
+const T* XDevector<T>::end() const noexcept { return (buffer_ ? buffer_ + front_ + size_ : nullptr); }
+
+template<typename T>
+std::reverse_iterator<T*> XDevector<T>::rbegin() noexcept { return std::reverse_iterator<T*>(end()); }
+
+template<typename T>
+std::reverse_iterator<const T*> XDevector<T>::rbegin() const noexcept { return std::reverse_iterator<const T*>(end()); }
+
+template<typename T>
+std::reverse_iterator<T*> XDevector<T>::rend() noexcept { return std::reverse_iterator<T*>(begin()); }
+
+template<typename T>
+std::reverse_iterator<const T*> XDevector<T>::rend() const noexcept { return std::reverse_iterator<const T*>(begin()); }
+
+template<typename T>
+size_t XDevector<T>::size() const noexcept { return size_; }
+
+template<typename T>
+size_t XDevector<T>::max_size() const noexcept { return std::numeric_limits<size_t>::max() / sizeof(T); }
+
+template<typename T>
+size_t XDevector<T>::capacity() const noexcept { return capacity_; }
+
+template<typename T>
+size_t XDevector<T>::front_capacity() const noexcept { return front_ + size_; }
+
+template<typename T>
+size_t XDevector<T>::back_capacity() const noexcept { return capacity_ - front_; }
+
+template<typename T>
+bool XDevector<T>::empty() const noexcept
+{
+    return (size_ == 0);
+}
+
+template<typename T>
+void XDevector<T>::append(const T& item) { emplace_back(item); }
+
+template<typename T>
+void XDevector<T>::append(T&& item) { emplace_back(std::move(item)); }
+
+template<typename T>
+void XDevector<T>::push_back(const T& item) { emplace_back(item); }
+
+template<typename T>
+void XDevector<T>::push_back(T&& item) { emplace_back(std::move(item)); }
+
+template<typename T>
+void XDevector<T>::pop_back()
+{
+    XVECTOR_EMPTY_CHECK();
+    --size_;
+    destroy(buffer_ + front_ + size_, 1); // no check for performance
+}
+
+template<typename T>
+void XDevector<T>::push_front(const T& item) { emplace_front(item); }
+
+template<typename T>
+void XDevector<T>::push_front(T&& item) { emplace_front(std::move(item)); }
+
+template<typename T>
+void XDevector<T>::pop_front()
+{
+    XVECTOR_EMPTY_CHECK();
+    destroy(buffer_ + front_, 1); // no check for performance
+    ++front_;
+    --size_;
+}
+
+template<typename T>
+void XDevector<T>::concatenate(const XDevector<T>& other)
+{
+    if (other.empty()) return;
+
+    const size_t newSize = size_ + other.size_;
+    if (newSize > back_capacity())
+    {
+        XDevector<T> tmp;
+        tmp.capacity_ = detail::nextPowerOf2(front_ + newSize);
+        tmp.front_ = front_;
+        tmp.buffer_ = static_cast<T*>(::operator new(tmp.capacity_ * sizeof(T)));
+        copyInto(tmp.buffer_ + front_ + size_, other.data(), other.size_); // tmp owns the buffer if this throws
+        try
+        {
+            moveInto(tmp.buffer_ + front_, data(), size_);
+        }
+        catch (...)
+        {
+            destroy(tmp.buffer_ + front_ + size_, other.size_);
+            throw;
+        }
+        tmp.size_ = newSize;
+        swap(tmp);
+    }
+    else
+    {
+        copyInto(end(), other.data(), other.size_);
+        size_ = newSize;
+    }
+}
+
+template<typename T>
+void XDevector<T>::clear() noexcept
+{
+    destroy(data(), size_);
+    size_ = 0;
+}
+
+template<typename T>
+void XDevector<T>::swap(XDevector<T>& other) noexcept {
+    std::swap(front_, other.front_);
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(buffer_, other.buffer_);
+}
+
+template<typename T>
+void XDevector<T>::reserve(size_t space)
+{
+    if (space > back_capacity())
+        relocate(detail::nextPowerOf2(front_ + space), front_);
+}
+
+template<typename T>
+void XDevector<T>::reserve_front(size_t space)
+{
+    if (space > front_capacity())
+    {
+        const size_t newCap = detail::nextPowerOf2(space + backSpace());
+        relocate(newCap, space - size_);
+    }
+}
+
+template<typename T>
+void XDevector<T>::resize(size_t newSize, const T& value)
+{
+    if (newSize > size_)
+    {
+        // growing may move the elements, and value may be one of them
+        insert(end(), newSize - size_, value);
+        return;
+    }
+    else if (newSize < size_)
+    {
+        destroy(data() + newSize, size_ - newSize);
+    }
+    size_ = newSize;
+}
+
+template<typename T>
+void XDevector<T>::shrink_to_fit()
+{
+    const size_t newCap = detail::nextPowerOf2(size_);
+    if (newCap < capacity_) relocate(newCap, (newCap - size_) / 2); // shrink if we can reduce capacity
+}
+
+template<typename T>
+template<typename... Args>
+void XDevector<T>::emplace_back(Args&&... args)
+{
+    if (front_ + size_ >= capacity_)
+    {
+        growAndEmplaceBack(std::forward<Args>(args)...);
+        return;
+    }
+    new (&buffer_[front_ + size_]) T(std::forward<Args>(args)...);
+    ++size_;
+}
+
+template<typename T>
+template<typename... Args>
+void XDevector<T>::emplace_front(Args&&... args)
+{
+    if (front_ == 0)
+    {
+        growAndEmplaceFront(std::forward<Args>(args)...);
+        return;
+    }
+    new (&buffer_[front_ - 1]) T(std::forward<Args>(args)...);
+    --front_;
+    ++size_;
+}
+
+template<typename T>
+T* XDevector<T>::insert(const T* pos, const T& value)
+{
+    return insert(pos, 1, value);
+}
+
+template<typename T>
+T* XDevector<T>::insert(const T* pos, T&& value)
+{
+    const size_t idx = pos - data();
+    if (&value >= data() && &value < end()) // value would be moved along with its neighbours
+    {
+        T tmp(std::move(value));
+        return insertGap(idx, 1, [&tmp](T* dest) { new (dest) T(std::move(tmp)); });
+    }
+    return insertGap(idx, 1, [&value](T* dest) { new (dest) T(std::move(value)); });
+}
+
+template<typename T>
+T* XDevector<T>::insert(const T* pos, size_t count, const T& value)
+{
+    const size_t idx = pos - data();
+    if (&value >= data() && &value < end())
+    {
+        const T tmp(value);
+        return insertGap(idx, count, [&tmp, count](T* dest) { fillInto(dest, count, tmp); });
+    }
+    return insertGap(idx, count, [&value, count](T* dest) { fillInto(dest, count, value); });
+}
+
+template<typename T>
+template<typename InputIt, typename>
+T* XDevector<T>::insert(const T* pos, InputIt first, InputIt last)
+{
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
+    const size_t idx = pos - data();
+
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>)
+    {
+        // multi-pass iterators can pre-calculate size, so there is at most one reallocation
+        const size_t count = static_cast<size_t>(std::distance(first, last));
+        return insertGap(idx, count, [&first, count](T* dest) { copyInto(dest, first, count); });
+    }
+    else
+    {
+        // single pass, so append and rotate the new elements into place
+        const size_t oldSize = size_;
+        try
+        {
+            for (; first != last; ++first)
+                emplace_back(*first);
+        }
+        catch (...)
+        {
+            while (size_ > oldSize) pop_back();
+            throw;
+        }
+        std::rotate(data() + idx, data() + oldSize, end());
+        return data() + idx;
+    }
+}
+
+template<typename T>
+T* XDevector<T>::insert(const T* pos, std::initializer_list<T> init)
+{
+    return insert(pos, init.begin(), init.end());
+}
+
+template<typename T>
+template<typename... Args>
+T* XDevector<T>::emplace(const T* pos, Args&&... args)
+{
+    const size_t idx = pos - data();
+    if (idx == size_)
+    {
+        emplace_back(std::forward<Args>(args)...);
+        return data() + idx;
+    }
+    if (idx == 0)
+    {
+        emplace_front(std::forward<Args>(args)...);
+        return data();
+    }
+
+    T tmp(std::forward<Args>(args)...); // args may refer to an element that is about to move
+    return insertGap(idx, 1, [&tmp](T* dest) { new (dest) T(std::move(tmp)); });
+}
+
+template<typename T>
+T* XDevector<T>::erase(const T* pos)
+{
+    return erase(pos, pos + 1);
+}
+
+// closes the gap from whichever side has fewer elements to move
+template<typename T>
+T* XDevector<T>::erase(const T* first, const T* last)
+{
+    const size_t idx = first - data();
+    const size_t count = last - first;
+    if (count == 0) return data() + idx;
+
+    T* base = data();
+    const size_t after = size_ - idx - count;
+    if (idx < after)
+    {
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            std::memmove(base + count, base, idx * sizeof(T));
+        }
+        else
+        {
+            std::move_backward(base, base + idx, base + idx + count);
+            destroy(base, count);
+        }
+        front_ += count;
+    }
+    else
+    {
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            std::memmove(base + idx, base + idx + count, after * sizeof(T));
+        }
+        else
+        {
+            std::move(base + idx + count, base + size_, base + idx);
+            destroy(base + size_ - count, count);
+        }
+    }
+
+    size_ -= count;
+    return data() + idx;
+}
+
+} // namespace xvc
+
+#endif // X_DEVECTOR_H
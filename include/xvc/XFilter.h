@@ -0,0 +1,332 @@
+#ifndef X_FILTER_H
+#define X_FILTER_H
+
+#include "XVector.h"
+
+#include <stddef.h>    // size_t
+#include <stdint.h>    // uint8_t, uint64_t
+#include <cstring>     // std::memmove
+#include <algorithm>   // std::min, std::move
+#include <stdexcept>   // std::length_error
+#include <type_traits> // std::is_trivially_copyable_v
+
+namespace xvc {
+
+namespace simd {
+
+// the compaction kernels move the elements of a block of at most 64 whose bit is set in keep to
+// dest, in order, and return how many there were. dest may be src or lie before it: every vector
+// is loaded before anything at or past its position is stored.
+template<typename T>
+size_t compressScalar(const T* src, T* dest, size_t n, uint64_t keep) noexcept
+{
+    size_t out = 0;
+    for (size_t j = 0; j < n; ++j)
+    {
+        dest[out] = src[j]; // written either way, kept only when the bit advances out
+        out += (keep >> j) & 1;
+    }
+    return out;
+}
+
+#if XVECTOR_SIMD_X86
+
+// for each 8-bit mask, the positions of its set bits followed by filler: the permutation that
+// packs the selected 32-bit lanes of a 256-bit vector to the front
+struct CompressTable
+{
+    uint8_t index[256][8];
+};
+
+constexpr CompressTable makeCompressTable() noexcept
+{
+    CompressTable table{};
+    for (unsigned mask = 0; mask < 256; ++mask)
+    {
+        unsigned k = 0;
+        for (unsigned lane = 0; lane < 8; ++lane)
+            if (mask >> lane & 1) table.index[mask][k++] = static_cast<uint8_t>(lane);
+    }
+    return table;
+}
+
+inline constexpr CompressTable compressTable = makeCompressTable();
+
+// AVX-512 compresses bytes and words only with VBMI2, which is not part of Isa::avx512
+inline bool hasVbmi2() noexcept
+{
+    static const bool supported = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx512vbmi2") != 0;
+    }();
+    return supported;
+}
+
+// 32 and 64-bit elements through the permutation table, a 64-bit lane being two 32-bit ones
+template<typename T>
+XVECTOR_TARGET("avx2,popcnt")
+inline size_t compressAvx2(const T* src, T* dest, size_t n, uint64_t keep) noexcept
+{
+    static_assert(sizeof(T) == 4 || sizeof(T) == 8, "AVX2 compaction handles 32 and 64-bit elements");
+    constexpr size_t lanes = 32 / sizeof(T);
+    constexpr unsigned laneMask = (1u << lanes) - 1;
+
+    size_t out = 0;
+    size_t j = 0;
+    for (; j + lanes <= n; j += lanes)
+    {
+        const unsigned bits = static_cast<unsigned>(keep >> j) & laneMask;
+        unsigned select = bits;
+        if constexpr (sizeof(T) == 8)
+            select = (bits & 1) * 3 | (bits & 2) * 6 | (bits & 4) * 12 | (bits & 8) * 24;
+
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + j));
+        const __m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(compressTable.index[select])));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + out), _mm256_permutevar8x32_epi32(v, index));
+        out += static_cast<size_t>(__builtin_popcount(bits));
+    }
+    return out + compressScalar(src + j, dest + out, n - j, j < 64 ? keep >> j : 0);
+}
+
+// 32 and 64-bit elements, whose compress instructions are part of AVX-512F
+template<typename T>
+XVECTOR_TARGET("avx512f,popcnt")
+inline size_t compressAvx512(const T* src, T* dest, size_t n, uint64_t keep) noexcept
+{
+    static_assert(sizeof(T) == 4 || sizeof(T) == 8, "AVX-512F compaction handles 32 and 64-bit elements");
+    constexpr size_t lanes = 64 / sizeof(T);
+    constexpr uint64_t laneMask = (uint64_t(1) << lanes) - 1;
+
+    size_t out = 0;
+    size_t j = 0;
+    for (; j + lanes <= n; j += lanes)
+    {
+        const uint64_t bits = (keep >> j) & laneMask;
+        const __m512i v = _mm512_loadu_si512(src + j);
+        __m512i packed;
+        if constexpr (sizeof(T) == 4)
+            packed = _mm512_maskz_compress_epi32(static_cast<__mmask16>(bits), v);
+        else
+            packed = _mm512_maskz_compress_epi64(static_cast<__mmask8>(bits), v);
+        _mm512_storeu_si512(dest + out, packed);
+        out += static_cast<size_t>(__builtin_popcountll(bits));
+    }
+    return out + compressScalar(src + j, dest + out, n - j, j < 64 ? keep >> j : 0);
+}
+
+// bytes and words, whose compress instructions need VBMI2
+template<typename T>
+XVECTOR_TARGET("avx512f,avx512bw,avx512vbmi2,popcnt")
+inline size_t compressAvx512Vbmi2(const T* src, T* dest, size_t n, uint64_t keep) noexcept
+{
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2, "VBMI2 compaction handles 8 and 16-bit elements");
+    constexpr size_t lanes = 64 / sizeof(T);
+    constexpr uint64_t laneMask = lanes == 64 ? ~uint64_t(0) : (uint64_t(1) << lanes) - 1;
+
+    size_t out = 0;
+    size_t j = 0;
+    for (; j + lanes <= n; j += lanes)
+    {
+        const uint64_t bits = (keep >> j) & laneMask;
+        const __m512i v = _mm512_loadu_si512(src + j);
+        __m512i packed;
+        if constexpr (sizeof(T) == 1)
+            packed = _mm512_maskz_compress_epi8(bits, v);
+        else
+            packed = _mm512_maskz_compress_epi16(static_cast<__mmask32>(bits), v);
+        _mm512_storeu_si512(dest + out, packed);
+        out += static_cast<size_t>(__builtin_popcountll(bits));
+    }
+    return out + compressScalar(src + j, dest + out, n - j, j < 64 ? keep >> j : 0);
+}
+
+#endif // XVECTOR_SIMD_X86
+
+template<typename T>
+using CompressKernel = size_t (*)(const T*, T*, size_t, uint64_t) noexcept;
+
+// the widest compaction kernel the CPU has for T, picked once per call of the drivers below
+template<typename T>
+CompressKernel<T> compressKernel() noexcept
+{
+#if XVECTOR_SIMD_X86
+    const Isa isa = detectIsa();
+    if constexpr (sizeof(T) >= 4)
+    {
+        if (isa == Isa::avx512) return compressAvx512<T>;
+        if (isa == Isa::avx2) return compressAvx2<T>;
+    }
+    else
+    {
+        if (isa == Isa::avx512 && hasVbmi2()) return compressAvx512Vbmi2<T>;
+    }
+#endif
+    return compressScalar<T>;
+}
+
+} // namespace simd
+
+namespace detail {
+
+// bit j set when pred(block[j]) is true, for a block of at most 64. eight answers at a time are
+// spread one per byte and gathered into eight bits with one multiply, which lets the predicate
+// vectorize.
+template<typename T, typename Pred>
+uint64_t selectBits(const T* block, size_t length, Pred&& pred)
+{
+    uint64_t bits = 0;
+    size_t j = 0;
+    for (; j + 8 <= length; j += 8)
+    {
+        uint64_t bytes = 0;
+        for (size_t q = 0; q < 8; ++q)
+            bytes |= uint64_t(static_cast<bool>(pred(block[j + q]))) << (8 * q);
+        bits |= ((bytes * 0x0102040810204080ull) >> 56) << j;
+    }
+    for (; j < length; ++j)
+        bits |= uint64_t(static_cast<bool>(pred(block[j]))) << j;
+    return bits;
+}
+
+inline size_t popcount64(uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_popcountll(x));
+#else
+    size_t n = 0;
+    for (; x; x &= x - 1) ++n;
+    return n;
+#endif
+}
+
+inline size_t countTrailingZeros64(uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_ctzll(x));
+#else
+    size_t n = 0;
+    for (; !(x & 1); x >>= 1) ++n;
+    return n;
+#endif
+}
+
+// the low length bits
+inline uint64_t lowBits(size_t length) noexcept
+{
+    return length == 64 ? ~uint64_t(0) : (uint64_t(1) << length) - 1;
+}
+
+// keeps the elements of vec whose bit keepBits(block, first, length) sets, 64 at a time, in order.
+// blocks that keep everything before anything has moved are skipped.
+template<typename T, typename KeepBits>
+size_t compressInPlace(XVector<T>& vec, KeepBits&& keepBits)
+{
+    const simd::CompressKernel<T> kernel = simd::compressKernel<T>();
+    T* data = vec.data();
+    const size_t n = vec.size();
+    size_t out = 0;
+    for (size_t i = 0; i < n; i += 64)
+    {
+        const size_t length = std::min<size_t>(64, n - i);
+        const uint64_t keep = keepBits(data + i, i, length);
+        if (out == i && keep == lowBits(length))
+            out += length;
+        else
+            out += kernel(data + i, data + out, length, keep);
+    }
+    const size_t removed = n - out;
+    vec.erase(data + out, data + n);
+    return removed;
+}
+
+// the general case: runs of kept elements move down as a whole, with one memmove each when T
+// is trivially copyable. keep(i) is asked once per element, in order.
+template<typename T, typename Keep>
+size_t compactRuns(XVector<T>& vec, Keep&& keep)
+{
+    T* data = vec.data();
+    const size_t n = vec.size();
+    size_t i = 0;
+    while (i < n && keep(i)) ++i;
+
+    size_t out = i;
+    while (i < n)
+    {
+        ++i; // data[i] was rejected
+        while (i < n && !keep(i)) ++i;
+        if (i == n) break;
+        const size_t run = i++; // data[run] was kept
+        while (i < n && keep(i)) ++i;
+
+        if constexpr (std::is_trivially_copyable_v<T>)
+            std::memmove(data + out, data + run, (i - run) * sizeof(T));
+        else
+            std::move(data + run, data + i, data + out);
+        out += i - run;
+    }
+    const size_t removed = n - out;
+    vec.erase(data + out, data + n);
+    return removed;
+}
+
+} // namespace detail
+
+// removes the elements for which pred is true, keeping the order of the rest, and returns how
+// many went, like std::erase_if. pred is called once per element, in order. arithmetic types
+// build a 64-bit keep mask per block and pack it with the SIMD compaction kernels (AVX2
+// permutation tables or AVX-512F compress for 32 and 64-bit elements, AVX-512 VBMI2 compress
+// for 8 and 16-bit ones).
+template<typename T, typename Pred>
+size_t erase_if(XVector<T>& vec, Pred pred)
+{
+    if constexpr (simd::searchable_v<T>)
+    {
+        return detail::compressInPlace(vec, [&pred](const T* block, size_t, size_t length) {
+            return detail::selectBits(block, length, [&pred](const T& x) { return !pred(x); });
+        });
+    }
+    else
+    {
+        const T* data = vec.data();
+        return detail::compactRuns(vec, [&pred, data](size_t i) { return !pred(data[i]); });
+    }
+}
+
+// removes every element equal to value, like std::erase
+template<typename T>
+size_t erase(XVector<T>& vec, const T& value)
+{
+    const T target = value; // value may be an element that moves
+    return erase_if(vec, [&target](const T& x) { return x == target; });
+}
+
+// keeps only the elements for which keep is true; erase_if with the condition turned around
+template<typename T, typename Keep>
+size_t filter(XVector<T>& vec, Keep keep)
+{
+    return erase_if(vec, [&keep](const T& x) { return !keep(x); });
+}
+
+// keeps only the elements whose bit is set in mask, bit i % 64 of mask[i / 64], for example a
+// mask computed in bulk beforehand. returns how many were removed.
+template<typename T>
+size_t filter(XVector<T>& vec, const XVector<uint64_t>& mask)
+{
+    if (mask.size() < (vec.size() + 63) / 64) throw std::length_error("filter mask is shorter than the XVector.");
+
+    const uint64_t* words = mask.data();
+    if constexpr (simd::searchable_v<T>)
+    {
+        return detail::compressInPlace(vec, [words](const T*, size_t first, size_t length) {
+            return words[first / 64] & detail::lowBits(length);
+        });
+    }
+    else
+    {
+        return detail::compactRuns(vec, [words](size_t i) { return (words[i / 64] >> (i % 64)) & 1; });
+    }
+}
+
+} // namespace xvc
+
+#endif // X_FILTER_H
@@ -0,0 +1,161 @@
+#ifndef X_HASH_H
+#define X_HASH_H
+
+#include "XVector.h"
+
+#include <stddef.h>    // size_t
+#include <stdint.h>    // uint64_t, uint32_t
+#include <cstring>     // std::memcpy
+#include <functional>  // std::hash
+#include <type_traits> // std::has_unique_object_representations_v
+
+namespace xvc {
+
+namespace detail {
+
+// wyhash (final version 4, public domain, by Wang Yi). it reads 16 or 48 bytes per step and mixes
+// them with full 64x64->128 bit multiplies, three independent lanes for long inputs, which keeps
+// the multiplier busy without any instruction set specific code.
+inline constexpr uint64_t hashSecret[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+};
+
+// a * b as 128 bits, low half into a and high half into b
+inline void hashMultiply(uint64_t& a, uint64_t& b) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+    const __uint128_t r = static_cast<__uint128_t>(a) * b;
+    a = static_cast<uint64_t>(r);
+    b = static_cast<uint64_t>(r >> 64);
+#else
+    const uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+    const uint64_t hh = ha * hb, hl = ha * lb, lh = la * hb, ll = la * lb;
+    const uint64_t t = ll + (hl << 32);
+    const uint64_t lo = t + (lh << 32);
+    const uint64_t carry = (t < ll) + (lo < t);
+    a = lo;
+    b = hh + (hl >> 32) + (lh >> 32) + carry;
+#endif
+}
+
+inline uint64_t hashMix(uint64_t a, uint64_t b) noexcept
+{
+    hashMultiply(a, b);
+    return a ^ b;
+}
+
+inline uint64_t hashRead8(const unsigned char* p) noexcept
+{
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+inline uint64_t hashRead4(const unsigned char* p) noexcept
+{
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+// 1 to 3 bytes
+inline uint64_t hashRead3(const unsigned char* p, size_t k) noexcept
+{
+    return (uint64_t(p[0]) << 16) | (uint64_t(p[k >> 1]) << 8) | p[k - 1];
+}
+
+} // namespace detail
+
+// 64-bit hash of bytes bytes at data. fast for both short keys and long buffers, and the same for
+// the same bytes and seed on every run, but not across endianness.
+inline uint64_t hash_bytes(const void* data, size_t bytes, uint64_t seed = 0) noexcept
+{
+    using namespace detail;
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    seed ^= hashMix(seed ^ hashSecret[0], hashSecret[1]);
+
+    uint64_t a = 0, b = 0;
+    if (bytes <= 16)
+    {
+        if (bytes >= 4)
+        {
+            const size_t mid = (bytes >> 3) << 2;
+            a = (hashRead4(p) << 32) | hashRead4(p + mid);
+            b = (hashRead4(p + bytes - 4) << 32) | hashRead4(p + bytes - 4 - mid);
+        }
+        else if (bytes > 0)
+        {
+            a = hashRead3(p, bytes);
+        }
+    }
+    else
+    {
+        size_t i = bytes;
+        if (i > 48)
+        {
+            uint64_t see1 = seed, see2 = seed;
+            do
+            {
+                seed = hashMix(hashRead8(p) ^ hashSecret[1], hashRead8(p + 8) ^ seed);
+                see1 = hashMix(hashRead8(p + 16) ^ hashSecret[2], hashRead8(p + 24) ^ see1);
+                see2 = hashMix(hashRead8(p + 32) ^ hashSecret[3], hashRead8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16)
+        {
+            seed = hashMix(hashRead8(p) ^ hashSecret[1], hashRead8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = hashRead8(p + i - 16);
+        b = hashRead8(p + i - 8);
+    }
+
+    a ^= hashSecret[1];
+    b ^= seed;
+    hashMultiply(a, b);
+    return hashMix(a ^ hashSecret[0] ^ bytes, b ^ hashSecret[1]);
+}
+
+// the contents of vec, whose element type must have unique object representations (equal values
+// are equal bytes), so hashing the buffer agrees with operator==
+template<typename T>
+uint64_t hash_bytes(const XVector<T>& vec, uint64_t seed = 0) noexcept
+{
+    static_assert(std::has_unique_object_representations_v<T>,
+                  "hash_bytes needs a type whose equal values have equal bytes, use std::hash<XVector<T>>");
+    return hash_bytes(vec.data(), vec.size() * sizeof(T), seed);
+}
+
+} // namespace xvc
+
+// XVector as a key of std::unordered_map and friends. element types with unique object
+// representations hash the whole buffer at once, anything else (float, double, strings, ...)
+// combines std::hash of each element, so that for example -0.0 and 0.0 hash the same.
+namespace std {
+
+template<typename T>
+struct hash<xvc::XVector<T>>
+{
+    size_t operator()(const xvc::XVector<T>& vec) const noexcept(std::has_unique_object_representations_v<T>)
+    {
+        if constexpr (std::has_unique_object_representations_v<T>)
+        {
+            return static_cast<size_t>(xvc::hash_bytes(vec));
+        }
+        else
+        {
+            uint64_t h = xvc::detail::hashSecret[0] ^ vec.size();
+            for (const T& x : vec)
+                h = xvc::detail::hashMix(h ^ static_cast<uint64_t>(std::hash<T>{}(x)), xvc::detail::hashSecret[1]);
+            return static_cast<size_t>(xvc::detail::hashMix(h, xvc::detail::hashSecret[2]));
+        }
+    }
+};
+
+} // namespace std
+
+#endif // X_HASH_H
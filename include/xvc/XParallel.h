@@ -0,0 +1,372 @@
+#ifndef X_PARALLEL_H
+#define X_PARALLEL_H
+
+#include "XVector.h"
+#include "XFilter.h"
+
+#include <stddef.h>    // size_t
+#include <stdint.h>    // uint64_t
+#include <cstring>     // std::memcpy
+#include <algorithm>   // std::min
+#include <stdexcept>   // std::length_error
+#include <type_traits> // std::invoke_result_t, std::decay_t, std::is_same_v, std::is_trivially_destructible_v, std::conditional_t
+#include <new>         // placement new
+#include <utility>     // std::move, std::move_if_noexcept, std::exchange
+
+namespace xvc {
+
+// parallel algorithms over XVector (or plain pointer) ranges. the range is cut into tasks of
+// grain elements that run on a ThreadPool, the global one unless another is passed. grain 0
+// picks a few tasks per thread, and task boundaries are rounded to cache lines of the range that
+// is written, so neighbouring tasks never share a line. f is called concurrently, from several
+// threads, and must be safe for that. when calls throw, the other tasks still finish and the
+// first exception is rethrown.
+
+// calls f(element) for every element of [first, last)
+template<typename T, typename F>
+void parallel_for_each(T* first, T* last, F f, size_t grain = 0, ThreadPool& pool = ThreadPool::global())
+{
+    const size_t count = static_cast<size_t>(last - first);
+    const detail::Partition part = detail::alignedPartition(first, count, grain, pool.concurrency());
+    pool.run(part.tasks, [&](size_t task) {
+        for (size_t i = part.first(task); i < part.last(task); ++i)
+            f(first[i]);
+    });
+}
+
+template<typename T, typename F>
+void parallel_for_each(XVector<T>& vec, F f, size_t grain = 0, ThreadPool& pool = ThreadPool::global())
+{
+    parallel_for_each(vec.data(), vec.data() + vec.size(), f, grain, pool);
+}
+
+template<typename T, typename F>
+void parallel_for_each(const XVector<T>& vec, F f, size_t grain = 0, ThreadPool& pool = ThreadPool::global())
+{
+    parallel_for_each(vec.data(), vec.data() + vec.size(), f, grain, pool);
+}
+
+// out[i] = f(first[i]) for every element of [first, last), like std::transform over existing
+// elements. out may be first for an in-place transform.
+template<typename T, typename U, typename F>
+void parallel_transform(const T* first, const T* last, U* out, F f, size_t grain = 0,
+                        ThreadPool& pool = ThreadPool::global())
+{
+    const size_t count = static_cast<size_t>(last - first);
+    const detail::Partition part = detail::alignedPartition(out, count, grain, pool.concurrency());
+    pool.run(part.tasks, [&](size_t task) {
+        for (size_t i = part.first(task); i < part.last(task); ++i)
+            out[i] = f(first[i]);
+    });
+}
+
+template<typename T, typename U, typename F>
+void parallel_transform(const XVector<T>& in, XVector<U>& out, F f, size_t grain = 0,
+                        ThreadPool& pool = ThreadPool::global())
+{
+    if (out.size() < in.size()) throw std::length_error("parallel_transform output is shorter than its input.");
+    parallel_transform(in.data(), in.data() + in.size(), out.data(), f, grain, pool);
+}
+
+// replaces the contents of out with f(in[i]) for every element of in, constructed in place, so U
+// does not need a default constructor. if f or a constructor throws, out is left empty.
+template<typename T, typename U, typename F>
+void transform_into(const XVector<T>& in, XVector<U>& out, F f, size_t grain, ThreadPool& pool)
+{
+    if constexpr (std::is_same_v<T, U>)
+    {
+        if (&in == &out) // clearing out would lose the input
+        {
+            XVector<U> result;
+            transform_into(in, result, f, grain, pool);
+            out = std::move(result);
+            return;
+        }
+    }
+
+    const size_t count = in.size();
+    const T* src = in.data();
+    out.clear();
+    out.reserve(count);
+    U* dest = out.data_;
+
+    const detail::Partition part = detail::alignedPartition(dest, count, grain, pool.concurrency());
+    auto build = [&](size_t task) {
+        const size_t first = part.first(task);
+        const size_t last = part.last(task);
+        size_t i = first;
+        try
+        {
+            for (; i < last; ++i)
+                new (&dest[i]) U(f(src[i]));
+        }
+        catch (...)
+        {
+            if constexpr (!std::is_trivially_destructible_v<U>)
+            {
+                for (size_t j = first; j < i; ++j)
+                    dest[j].~U();
+            }
+            throw;
+        }
+    };
+
+    if constexpr (std::is_trivially_destructible_v<U>)
+    {
+        pool.run(part.tasks, build);
+    }
+    else
+    {
+        // finished tasks are recorded so a throwing one can unwind the others
+        XVector<unsigned char> built(part.tasks, 0);
+        try
+        {
+            pool.run(part.tasks, [&](size_t task) {
+                build(task);
+                built[task] = 1;
+            });
+        }
+        catch (...)
+        {
+            for (size_t task = 0; task < part.tasks; ++task)
+            {
+                if (!built[task]) continue;
+                for (size_t i = part.first(task); i < part.last(task); ++i)
+                    dest[i].~U();
+            }
+            throw;
+        }
+    }
+    out.size_ = count;
+}
+
+template<typename T, typename U, typename F>
+void transform_into(const XVector<T>& in, XVector<U>& out, F f, size_t grain = 0)
+{
+    transform_into(in, out, f, grain, ThreadPool::global());
+}
+
+// transform_into a new XVector of whatever f returns
+template<typename T, typename F>
+XVector<std::decay_t<std::invoke_result_t<F&, const T&>>> parallel_transform(const XVector<T>& in, F f, size_t grain = 0,
+                                                                            ThreadPool& pool = ThreadPool::global())
+{
+    XVector<std::decay_t<std::invoke_result_t<F&, const T&>>> out;
+    transform_into(in, out, f, grain, pool);
+    return out;
+}
+
+namespace detail {
+
+// tasks of the parallel filters: whole cache lines of the selection bitmask, 512 elements, so no
+// two tasks write the same line of it
+inline Partition selectPartition(size_t count, size_t grain, size_t concurrency) noexcept
+{
+    constexpr size_t perTask = 64 * (cacheLineSize / sizeof(uint64_t));
+    if (grain == 0) grain = count / (4 * concurrency);
+    return Partition(count, std::max<size_t>(1, (grain + perTask - 1) / perTask) * perTask);
+}
+
+// the selection of the parallel filters: bit i % 64 of words[i / 64] is set when pred(src[i]), and
+// at[task] is the number of selected elements before the task, an exclusive prefix sum of the
+// per-task counts. returns the total.
+template<typename T, typename Pred>
+size_t selectAll(const T* src, const Partition& part, Pred& pred, uint64_t* words, size_t* at, ThreadPool& pool)
+{
+    pool.run(part.tasks, [&](size_t task) {
+        const size_t last = part.last(task);
+        size_t selected = 0;
+        for (size_t i = part.first(task); i < last; i += 64)
+        {
+            const uint64_t bits = selectBits(src + i, std::min<size_t>(64, last - i), pred);
+            words[i / 64] = bits;
+            selected += popcount64(bits);
+        }
+        at[task] = selected;
+    });
+
+    size_t total = 0;
+    for (size_t task = 0; task < part.tasks; ++task)
+        total += std::exchange(at[task], total);
+    return total;
+}
+
+// constructs the elements whose bit in words ^ flip is set at dest + at[task], every task its own
+// range, in order, copied or (Move) moved out of src. arithmetic types are packed 64 at a time by
+// the compaction kernel into a local buffer first, so that its full-width stores never reach into
+// the range of the next task. if a construction throws, everything built so far is destroyed.
+template<bool Move, typename T>
+void constructSelected(std::conditional_t<Move, T, const T>* src, const Partition& part, const uint64_t* words,
+                       uint64_t flip, const size_t* at, T* dest, ThreadPool& pool)
+{
+    [[maybe_unused]] simd::CompressKernel<T> kernel = nullptr;
+    if constexpr (simd::searchable_v<T>) kernel = simd::compressKernel<T>();
+    auto build = [&](size_t task) -> size_t {
+        const size_t last = part.last(task);
+        T* const begin = dest + at[task];
+        T* out = begin;
+        try
+        {
+            for (size_t i = part.first(task); i < last; i += 64)
+            {
+                const size_t length = std::min<size_t>(64, last - i);
+                uint64_t bits = (words[i / 64] ^ flip) & lowBits(length);
+                if constexpr (simd::searchable_v<T>)
+                {
+                    if (bits == lowBits(length))
+                    {
+                        std::memcpy(out, src + i, length * sizeof(T));
+                        out += length;
+                    }
+                    else if (bits)
+                    {
+                        T packed[64];
+                        const size_t kept = kernel(src + i, packed, length, bits);
+                        std::memcpy(out, packed, kept * sizeof(T));
+                        out += kept;
+                    }
+                }
+                else
+                {
+                    for (; bits; bits &= bits - 1, ++out)
+                    {
+                        auto& x = src[i + countTrailingZeros64(bits)];
+                        if constexpr (Move)
+                            new (out) T(std::move_if_noexcept(x));
+                        else
+                            new (out) T(x);
+                    }
+                }
+            }
+        }
+        catch (...)
+        {
+            for (T* p = begin; p != out; ++p)
+                p->~T();
+            throw;
+        }
+        return static_cast<size_t>(out - begin);
+    };
+
+    if constexpr (std::is_trivially_destructible_v<T>)
+    {
+        pool.run(part.tasks, build);
+    }
+    else
+    {
+        // what finished tasks built is recorded so a throwing one can unwind the others
+        XVector<size_t> built(part.tasks, 0);
+        try
+        {
+            pool.run(part.tasks, [&](size_t task) { built[task] = build(task); });
+        }
+        catch (...)
+        {
+            for (size_t task = 0; task < part.tasks; ++task)
+            {
+                for (size_t i = 0; i < built[task]; ++i)
+                    dest[at[task] + i].~T();
+            }
+            throw;
+        }
+    }
+}
+
+} // namespace detail
+
+// replaces the contents of out with the elements of in for which pred is true, in order, like
+// std::copy_if. every task marks its elements in a bitmask and counts them, an exclusive prefix
+// sum over the counts gives each task where its survivors start, and the tasks then construct them
+// straight into out, which is allocated once for the exact result. pred is called once per element.
+template<typename T, typename Pred>
+void parallel_copy_if(const XVector<T>& in, XVector<T>& out, Pred pred, size_t grain, ThreadPool& pool)
+{
+    if (&in == &out) // clearing out would lose the input
+    {
+        XVector<T> result;
+        parallel_copy_if(in, result, pred, grain, pool);
+        out = std::move(result);
+        return;
+    }
+
+    const size_t count = in.size();
+    const detail::Partition part = detail::selectPartition(count, grain, pool.concurrency());
+    XVector<uint64_t> words;
+    words.resize((count + 63) / 64);
+    XVector<size_t> at;
+    at.resize(part.tasks);
+    const size_t total = detail::selectAll(in.data(), part, pred, words.data(), at.data(), pool);
+
+    out.clear();
+    out.reserve(total);
+    detail::constructSelected<false, T>(in.data(), part, words.data(), 0, at.data(), out.data_, pool);
+    out.size_ = total;
+}
+
+template<typename T, typename Pred>
+void parallel_copy_if(const XVector<T>& in, XVector<T>& out, Pred pred, size_t grain = 0)
+{
+    parallel_copy_if(in, out, pred, grain, ThreadPool::global());
+}
+
+// parallel_copy_if into a new XVector
+template<typename T, typename Pred>
+XVector<T> parallel_copy_if(const XVector<T>& in, Pred pred, size_t grain = 0, ThreadPool& pool = ThreadPool::global())
+{
+    XVector<T> out;
+    parallel_copy_if(in, out, pred, grain, pool);
+    return out;
+}
+
+// reorders vec so the elements for which pred is true come first, each side in its original
+// order, like std::stable_partition, and returns how many there are. parallel_copy_if's counting
+// pass places both sides, the survivors from offset 0 and the rest after them, into one new buffer
+// the elements are moved to. they are copied instead if their move can throw, so vec is left as
+// it was when anything throws.
+template<typename T, typename Pred>
+size_t parallel_partition(XVector<T>& vec, Pred pred, size_t grain, ThreadPool& pool)
+{
+    const size_t count = vec.size();
+    const detail::Partition part = detail::selectPartition(count, grain, pool.concurrency());
+    XVector<uint64_t> words;
+    words.resize((count + 63) / 64);
+    XVector<size_t> at;
+    at.resize(part.tasks);
+    const size_t total = detail::selectAll(static_cast<const T*>(vec.data()), part, pred, words.data(), at.data(), pool);
+
+    // the rest of each task starts after all survivors and the rest of the tasks before it
+    XVector<size_t> restAt;
+    restAt.resize(part.tasks);
+    for (size_t task = 0; task < part.tasks; ++task)
+        restAt[task] = total + part.first(task) - at[task];
+
+    XVector<T> result;
+    result.reserve(count);
+    detail::constructSelected<true, T>(vec.data(), part, words.data(), 0, at.data(), result.data_, pool);
+    try
+    {
+        detail::constructSelected<true, T>(vec.data(), part, words.data(), ~uint64_t(0), restAt.data(), result.data_, pool);
+    }
+    catch (...)
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for (size_t i = 0; i < total; ++i)
+                result.data_[i].~T();
+        }
+        throw;
+    }
+    result.size_ = count;
+    vec = std::move(result);
+    return total;
+}
+
+template<typename T, typename Pred>
+size_t parallel_partition(XVector<T>& vec, Pred pred, size_t grain = 0)
+{
+    return parallel_partition(vec, pred, grain, ThreadPool::global());
+}
+
+} // namespace xvc
+
+#endif // X_PARALLEL_H
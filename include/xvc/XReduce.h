@@ -0,0 +1,573 @@
+#ifndef X_REDUCE_H
+#define X_REDUCE_H
+
+#include "XVector.h"
+#include "XSearch.h"
+
+#include <stddef.h>    // size_t
+#include <stdint.h>    // int64_t, uint64_t
+#include <cstring>     // std::memcpy
+#include <limits>      // std::numeric_limits
+#include <type_traits> // std::conditional_t, std::is_integral_v, std::is_signed_v, std::make_unsigned_t
+#include <utility>     // std::pair, std::move
+
+namespace xvc {
+
+// how sum() adds up floating-point elements. fast keeps several vector accumulators and is
+// usually accurate enough; pairwise sums blocks and combines them in a tree, so the error grows
+// with log n instead of n; kahan carries a compensation term per lane and is the most accurate
+// and the slowest. integer sums are exact either way, wrapping around in 64 bits.
+enum class Summation : unsigned char { fast, pairwise, kahan };
+
+namespace detail {
+
+template<typename T, typename = void>
+struct SumType { using type = T; };
+
+template<typename T>
+struct SumType<T, std::enable_if_t<std::is_integral_v<T>>>
+{
+    using type = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+};
+
+} // namespace detail
+
+// the type sum() returns: the element type for floating point, 64-bit integers for integral types
+template<typename T>
+using sum_t = typename detail::SumType<T>::type;
+
+namespace simd {
+
+template<typename T>
+inline constexpr bool reducible_v = std::is_arithmetic_v<T> && !std::is_same_v<T, bool> &&
+                                    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+// sums are computed over blocks of this many elements before pairwise combining
+inline constexpr size_t pairwiseBlock = 4096;
+
+// integer sums add in the unsigned type, so that an overflowing sum wraps instead of being undefined
+template<typename Acc, typename = void>
+struct Adder { using type = Acc; };
+
+template<typename Acc>
+struct Adder<Acc, std::enable_if_t<std::is_integral_v<Acc>>> { using type = std::make_unsigned_t<Acc>; };
+
+template<typename Acc, typename T>
+Acc sumScalar(const T* data, size_t n)
+{
+    using Add = typename Adder<Acc>::type;
+    Add total{};
+    for (size_t i = 0; i < n; ++i) total += static_cast<Add>(data[i]);
+    return static_cast<Acc>(total);
+}
+
+template<typename Acc, typename T>
+Acc sumKahanScalar(const T* data, size_t n)
+{
+    Acc total{};
+    Acc carry{};
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Acc y = static_cast<Acc>(data[i]) - carry;
+        const Acc t = total + y;
+        carry = (t - total) - y;
+        total = t;
+    }
+    return total;
+}
+
+// the largest (Max) or smallest element, skipping NaN, starting from init
+template<bool Max, typename T>
+T extremeScalar(const T* data, size_t n, T init)
+{
+    for (size_t i = 0; i < n; ++i)
+        if (Max ? data[i] > init : data[i] < init) init = data[i];
+    return init;
+}
+
+#if XVECTOR_SIMD_X86
+
+// the generic bodies below use GCC vector extensions; each one is inlined into the SSE2, AVX2 and
+// AVX-512 kernels that follow, with Width the vector width in bytes. floating-point sums keep four
+// accumulators to hide the add latency, widened integer sums get enough lanes from one.
+template<size_t Width, typename Acc, typename T>
+XVECTOR_ALWAYS_INLINE inline Acc sumBody(const T* data, size_t n) noexcept
+{
+    using Add = typename Adder<Acc>::type;
+    constexpr size_t lanes = Width / sizeof(T);
+    constexpr size_t accs = sizeof(Acc) == sizeof(T) ? 4 : 1;
+    typedef T In __attribute__((vector_size(Width)));
+    typedef Add Wide __attribute__((vector_size(lanes * sizeof(Add))));
+
+    Wide acc[accs] = {};
+    size_t i = 0;
+    for (; i + accs * lanes <= n; i += accs * lanes)
+    {
+        for (size_t a = 0; a < accs; ++a)
+        {
+            In x;
+            std::memcpy(&x, data + i + a * lanes, sizeof(x));
+            acc[a] += __builtin_convertvector(x, Wide);
+        }
+    }
+    for (size_t a = 1; a < accs; ++a) acc[0] += acc[a];
+
+    Add total{};
+    for (size_t j = 0; j < lanes; ++j) total += acc[0][j];
+    for (; i < n; ++i) total += static_cast<Add>(data[i]);
+    return static_cast<Acc>(total);
+}
+
+template<size_t Width, typename T>
+XVECTOR_ALWAYS_INLINE inline T sumKahanBody(const T* data, size_t n) noexcept
+{
+    constexpr size_t lanes = Width / sizeof(T);
+    typedef T V __attribute__((vector_size(Width)));
+
+    V total = {};
+    V carry = {};
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes)
+    {
+        V x;
+        std::memcpy(&x, data + i, sizeof(x));
+        const V y = x - carry;
+        const V t = total + y;
+        carry = (t - total) - y;
+        total = t;
+    }
+
+    // the lane totals, their negated carries and the tail, all through the compensated scalar sum
+    T rest[3 * lanes];
+    const size_t tail = n - i;
+    for (size_t j = 0; j < lanes; ++j)
+    {
+        rest[2 * j] = total[j];
+        rest[2 * j + 1] = -carry[j];
+    }
+    for (size_t j = 0; j < tail; ++j) rest[2 * lanes + j] = data[i + j];
+    return sumKahanScalar<T>(rest, 2 * lanes + tail);
+}
+
+template<size_t Width, bool Max, typename T>
+XVECTOR_ALWAYS_INLINE inline T extremeBody(const T* data, size_t n, T init) noexcept
+{
+    constexpr size_t lanes = Width / sizeof(T);
+    typedef T V __attribute__((vector_size(Width)));
+
+    const V start = V{} + init;
+    V acc[4] = { start, start, start, start };
+
+    // x is only taken when the comparison holds, so NaN elements never replace the accumulator
+    size_t i = 0;
+    for (; i + 4 * lanes <= n; i += 4 * lanes)
+    {
+        for (size_t a = 0; a < 4; ++a)
+        {
+            V x;
+            std::memcpy(&x, data + i + a * lanes, sizeof(x));
+            acc[a] = Max ? (x > acc[a] ? x : acc[a]) : (x < acc[a] ? x : acc[a]);
+        }
+    }
+    for (size_t a = 1; a < 4; ++a)
+        acc[0] = Max ? (acc[a] > acc[0] ? acc[a] : acc[0]) : (acc[a] < acc[0] ? acc[a] : acc[0]);
+
+    for (size_t j = 0; j < lanes; ++j)
+        if (Max ? acc[0][j] > init : acc[0][j] < init) init = acc[0][j];
+    return extremeScalar<Max>(data + i, n - i, init);
+}
+
+template<size_t Width, typename T>
+XVECTOR_ALWAYS_INLINE inline void minMaxBody(const T* data, size_t n, T& lo, T& hi) noexcept
+{
+    constexpr size_t lanes = Width / sizeof(T);
+    typedef T V __attribute__((vector_size(Width)));
+
+    V low[2] = { V{} + lo, V{} + lo };
+    V high[2] = { V{} + hi, V{} + hi };
+
+    size_t i = 0;
+    for (; i + 2 * lanes <= n; i += 2 * lanes)
+    {
+        for (size_t a = 0; a < 2; ++a)
+        {
+            V x;
+            std::memcpy(&x, data + i + a * lanes, sizeof(x));
+            low[a] = x < low[a] ? x : low[a];
+            high[a] = x > high[a] ? x : high[a];
+        }
+    }
+    low[0] = low[1] < low[0] ? low[1] : low[0];
+    high[0] = high[1] > high[0] ? high[1] : high[0];
+
+    for (size_t j = 0; j < lanes; ++j)
+    {
+        if (low[0][j] < lo) lo = low[0][j];
+        if (high[0][j] > hi) hi = high[0][j];
+    }
+    lo = extremeScalar<false>(data + i, n - i, lo);
+    hi = extremeScalar<true>(data + i, n - i, hi);
+}
+
+template<typename Acc, typename T>
+XVECTOR_TARGET("sse2")
+inline Acc sumSse2(const T* data, size_t n) noexcept { return sumBody<16, Acc>(data, n); }
+
+template<typename Acc, typename T>
+XVECTOR_TARGET("avx2")
+inline Acc sumAvx2(const T* data, size_t n) noexcept { return sumBody<32, Acc>(data, n); }
+
+template<typename Acc, typename T>
+XVECTOR_TARGET("avx512f,avx512bw")
+inline Acc sumAvx512(const T* data, size_t n) noexcept { return sumBody<64, Acc>(data, n); }
+
+template<typename T>
+XVECTOR_TARGET("sse2")
+inline T sumKahanSse2(const T* data, size_t n) noexcept { return sumKahanBody<16>(data, n); }
+
+template<typename T>
+XVECTOR_TARGET("avx2")
+inline T sumKahanAvx2(const T* data, size_t n) noexcept { return sumKahanBody<32>(data, n); }
+
+template<typename T>
+XVECTOR_TARGET("avx512f,avx512bw")
+inline T sumKahanAvx512(const T* data, size_t n) noexcept { return sumKahanBody<64>(data, n); }
+
+template<bool Max, typename T>
+XVECTOR_TARGET("sse2")
+inline T extremeSse2(const T* data, size_t n, T init) noexcept { return extremeBody<16, Max>(data, n, init); }
+
+template<bool Max, typename T>
+XVECTOR_TARGET("avx2")
+inline T extremeAvx2(const T* data, size_t n, T init) noexcept { return extremeBody<32, Max>(data, n, init); }
+
+template<bool Max, typename T>
+XVECTOR_TARGET("avx512f,avx512bw")
+inline T extremeAvx512(const T* data, size_t n, T init) noexcept { return extremeBody<64, Max>(data, n, init); }
+
+template<typename T>
+XVECTOR_TARGET("sse2")
+inline void minMaxSse2(const T* data, size_t n, T& lo, T& hi) noexcept { minMaxBody<16>(data, n, lo, hi); }
+
+template<typename T>
+XVECTOR_TARGET("avx2")
+inline void minMaxAvx2(const T* data, size_t n, T& lo, T& hi) noexcept { minMaxBody<32>(data, n, lo, hi); }
+
+template<typename T>
+XVECTOR_TARGET("avx512f,avx512bw")
+inline void minMaxAvx512(const T* data, size_t n, T& lo, T& hi) noexcept { minMaxBody<64>(data, n, lo, hi); }
+
+#endif // XVECTOR_SIMD_X86
+
+template<typename Acc, typename T>
+Acc sumFast(const T* data, size_t n)
+{
+#if XVECTOR_SIMD_X86
+    if constexpr (reducible_v<T>)
+    {
+        switch (detectIsa())
+        {
+            case Isa::avx512: return sumAvx512<Acc>(data, n);
+            case Isa::avx2:   return sumAvx2<Acc>(data, n);
+            case Isa::sse2:   return sumSse2<Acc>(data, n);
+            default: break;
+        }
+    }
+#endif
+    return sumScalar<Acc>(data, n);
+}
+
+template<typename Acc, typename T>
+Acc sumKahan(const T* data, size_t n)
+{
+#if XVECTOR_SIMD_X86
+    if constexpr (reducible_v<T> && std::is_same_v<Acc, T>)
+    {
+        switch (detectIsa())
+        {
+            case Isa::avx512: return sumKahanAvx512(data, n);
+            case Isa::avx2:   return sumKahanAvx2(data, n);
+            case Isa::sse2:   return sumKahanSse2(data, n);
+            default: break;
+        }
+    }
+#endif
+    return sumKahanScalar<Acc>(data, n);
+}
+
+template<typename Acc, typename T>
+Acc sumPairwise(const T* data, size_t n)
+{
+    if (n <= pairwiseBlock) return sumFast<Acc>(data, n);
+    const size_t half = (n / 2 + pairwiseBlock - 1) / pairwiseBlock * pairwiseBlock;
+    return sumPairwise<Acc>(data, half) + sumPairwise<Acc>(data + half, n - half);
+}
+
+template<typename Acc, typename T>
+Acc sum(const T* data, size_t n, Summation mode)
+{
+    if constexpr (std::is_floating_point_v<Acc>)
+    {
+        if (mode == Summation::kahan) return sumKahan<Acc>(data, n);
+        if (mode == Summation::pairwise) return sumPairwise<Acc>(data, n);
+    }
+    return sumFast<Acc>(data, n);
+}
+
+template<bool Max, typename T>
+T extreme(const T* data, size_t n, T init)
+{
+#if XVECTOR_SIMD_X86
+    if constexpr (reducible_v<T>)
+    {
+        switch (detectIsa())
+        {
+            case Isa::avx512: return extremeAvx512<Max>(data, n, init);
+            case Isa::avx2:   return extremeAvx2<Max>(data, n, init);
+            case Isa::sse2:   return extremeSse2<Max>(data, n, init);
+            default: break;
+        }
+    }
+#endif
+    return extremeScalar<Max>(data, n, init);
+}
+
+template<typename T>
+void minMax(const T* data, size_t n, T& lo, T& hi)
+{
+#if XVECTOR_SIMD_X86
+    if constexpr (reducible_v<T>)
+    {
+        switch (detectIsa())
+        {
+            case Isa::avx512: return minMaxAvx512(data, n, lo, hi);
+            case Isa::avx2:   return minMaxAvx2(data, n, lo, hi);
+            case Isa::sse2:   return minMaxSse2(data, n, lo, hi);
+            default: break;
+        }
+    }
+#endif
+    lo = extremeScalar<false>(data, n, lo);
+    hi = extremeScalar<true>(data, n, hi);
+}
+
+} // namespace simd
+
+namespace detail {
+
+// the value the min (Max false) or max reduction of an arithmetic type starts from, every element
+// but NaN replaces it. types without numeric limits start from their first element instead.
+template<bool Max, typename T>
+T extremeInit() noexcept
+{
+    if constexpr (std::numeric_limits<T>::has_infinity)
+        return Max ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+    else
+        return Max ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max();
+}
+
+// the reductions skip NaN, so a result still equal to the start value means either that it is
+// an element, or that there were only NaNs
+template<bool Max, typename T>
+T extremeOrNan(const T* data, size_t n, T result) noexcept
+{
+    if constexpr (std::numeric_limits<T>::has_quiet_NaN)
+    {
+        if (!n || !(result == extremeInit<Max, T>())) return result;
+        size_t idx = 0;
+        if constexpr (simd::searchable_v<T>)
+            idx = simd::findAny(data, n, &result, 1, false);
+        else
+            idx = simd::findAnyScalar(data, n, &result, 1, false);
+        if (idx == n) return std::numeric_limits<T>::quiet_NaN();
+    }
+    return result;
+}
+
+// the per-thread partition for reductions: one task per thread, none below the minimum chunk
+inline Partition reducePartition(size_t count, size_t minChunk) noexcept
+{
+    const size_t threads = ThreadPool::global().concurrency();
+    return Partition(count, std::max(minChunk, (count + threads - 1) / threads));
+}
+
+template<typename Acc, typename T>
+Acc sum(const T* data, size_t n, Summation mode, Exec exec)
+{
+    if (!runsParallel<T>(n, exec)) return simd::sum<Acc>(data, n, mode);
+
+    // the partial sums are combined with the same method, in order
+    const Partition part = reducePartition(n, parallelMinChunk<T>());
+    XVector<Acc> partial(part.tasks, Acc{});
+    ThreadPool::global().run(part.tasks, [&](size_t task) {
+        partial[task] = simd::sum<Acc>(data + part.first(task), part.last(task) - part.first(task), mode);
+    });
+    return simd::sum<Acc>(partial.data(), partial.size(), mode);
+}
+
+// the smallest (Max false) or largest of n elements, skipping NaN, n > 0 unless T is arithmetic
+template<bool Max, typename T>
+T extremeOf(const T* data, size_t n)
+{
+    if constexpr (std::numeric_limits<T>::is_specialized)
+        return simd::extreme<Max>(data, n, extremeInit<Max, T>());
+    else
+        return simd::extremeScalar<Max>(data + 1, n - 1, data[0]);
+}
+
+// both in a single pass, as a pair
+template<typename T>
+std::pair<T, T> minMaxOf(const T* data, size_t n)
+{
+    if constexpr (std::numeric_limits<T>::is_specialized)
+    {
+        std::pair<T, T> result(extremeInit<false, T>(), extremeInit<true, T>());
+        simd::minMax(data, n, result.first, result.second);
+        return result;
+    }
+    else
+    {
+        std::pair<T, T> result(data[0], data[0]);
+        simd::minMax(data + 1, n - 1, result.first, result.second);
+        return result;
+    }
+}
+
+template<bool Max, typename T>
+T extreme(const T* data, size_t n, Exec exec)
+{
+    if (!runsParallel<T>(n, exec)) return extremeOrNan<Max>(data, n, extremeOf<Max>(data, n));
+
+    // every task has elements, so each part can start from its own first one
+    const Partition part = reducePartition(n, parallelMinChunk<T>());
+    XVector<T> partial(part.tasks, data[0]);
+    ThreadPool::global().run(part.tasks, [&](size_t task) {
+        partial[task] = extremeOf<Max>(data + part.first(task), part.last(task) - part.first(task));
+    });
+    return extremeOrNan<Max>(data, n, extremeOf<Max>(partial.data(), partial.size()));
+}
+
+template<typename T>
+std::pair<T, T> minMax(const T* data, size_t n, Exec exec)
+{
+    if (!runsParallel<T>(n, exec))
+    {
+        const std::pair<T, T> result = minMaxOf(data, n);
+        return { extremeOrNan<false>(data, n, result.first), extremeOrNan<true>(data, n, result.second) };
+    }
+
+    const Partition part = reducePartition(n, parallelMinChunk<T>());
+    XVector<T> lows(part.tasks, data[0]), highs(part.tasks, data[0]);
+    ThreadPool::global().run(part.tasks, [&](size_t task) {
+        std::pair<T, T> partial = minMaxOf(data + part.first(task), part.last(task) - part.first(task));
+        lows[task] = std::move(partial.first);
+        highs[task] = std::move(partial.second);
+    });
+    return { extremeOrNan<false>(data, n, extremeOf<false>(lows.data(), lows.size())),
+             extremeOrNan<true>(data, n, extremeOf<true>(highs.data(), highs.size())) };
+}
+
+} // namespace detail
+
+// reductions over XVector. arithmetic element types use vector kernels (SSE2, AVX2 or AVX-512,
+// picked at runtime); sum of any other type with + falls back to a plain loop from T{}, and min
+// and max of any other type with < to one from the first element. like the bulk operations they
+// run on the thread pool above parallel_threshold or with xvc::par. min, max and minmax skip NaN
+// elements and give NaN only when every element is NaN; they expect a non-empty vector. argmin and
+// argmax return the index of the first smallest or largest element, and 0 when the vector is
+// empty.
+
+template<typename T>
+sum_t<T> sum(const XVector<T>& vec, Summation mode = Summation::fast)
+{
+    return detail::sum<sum_t<T>>(vec.data(), vec.size(), mode, detail::Exec::automatic);
+}
+
+template<typename ExecutionPolicy, typename T, typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+sum_t<T> sum(ExecutionPolicy&&, const XVector<T>& vec, Summation mode = Summation::fast)
+{
+    return detail::sum<sum_t<T>>(vec.data(), vec.size(), mode, std::decay_t<ExecutionPolicy>::mode);
+}
+
+template<typename T>
+T min(const XVector<T>& vec)
+{
+    XVECTOR_ASSERT(!vec.empty(), "Operation on empty array");
+    return detail::extreme<false>(vec.data(), vec.size(), detail::Exec::automatic);
+}
+
+template<typename ExecutionPolicy, typename T, typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+T min(ExecutionPolicy&&, const XVector<T>& vec)
+{
+    XVECTOR_ASSERT(!vec.empty(), "Operation on empty array");
+    return detail::extreme<false>(vec.data(), vec.size(), std::decay_t<ExecutionPolicy>::mode);
+}
+
+template<typename T>
+T max(const XVector<T>& vec)
+{
+    XVECTOR_ASSERT(!vec.empty(), "Operation on empty array");
+    return detail::extreme<true>(vec.data(), vec.size(), detail::Exec::automatic);
+}
+
+template<typename ExecutionPolicy, typename T, typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+T max(ExecutionPolicy&&, const XVector<T>& vec)
+{
+    XVECTOR_ASSERT(!vec.empty(), "Operation on empty array");
+    return detail::extreme<true>(vec.data(), vec.size(), std::decay_t<ExecutionPolicy>::mode);
+}
+
+// both in a single pass
+template<typename T>
+std::pair<T, T> minmax(const XVector<T>& vec)
+{
+    XVECTOR_ASSERT(!vec.empty(), "Operation on empty array");
+    return detail::minMax(vec.data(), vec.size(), detail::Exec::automatic);
+}
+
+template<typename ExecutionPolicy, typename T, typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+std::pair<T, T> minmax(ExecutionPolicy&&, const XVector<T>& vec)
+{
+    XVECTOR_ASSERT(!vec.empty(), "Operation on empty array");
+    return detail::minMax(vec.data(), vec.size(), std::decay_t<ExecutionPolicy>::mode);
+}
+
+template<typename T>
+size_t argmin(const XVector<T>& vec)
+{
+    if (vec.empty()) return 0;
+    const T lowest = min(vec);
+    const size_t idx = detail::findIndex(vec, &lowest, 1, false);
+    return idx == vec.size() ? 0 : idx; // only NaNs
+}
+
+template<typename ExecutionPolicy, typename T, typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+size_t argmin(ExecutionPolicy&& policy, const XVector<T>& vec)
+{
+    if (vec.empty()) return 0;
+    const T lowest = min(policy, vec);
+    const size_t idx = detail::findIndex(vec, &lowest, 1, false);
+    return idx == vec.size() ? 0 : idx;
+}
+
+template<typename T>
+size_t argmax(const XVector<T>& vec)
+{
+    if (vec.empty()) return 0;
+    const T highest = max(vec);
+    const size_t idx = detail::findIndex(vec, &highest, 1, false);
+    return idx == vec.size() ? 0 : idx;
+}
+
+template<typename ExecutionPolicy, typename T, typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+size_t argmax(ExecutionPolicy&& policy, const XVector<T>& vec)
+{
+    if (vec.empty()) return 0;
+    const T highest = max(policy, vec);
+    const size_t idx = detail::findIndex(vec, &highest, 1, false);
+    return idx == vec.size() ? 0 : idx;
+}
+
+} // namespace xvc
+
+#endif // X_REDUCE_H
@@ -0,0 +1,574 @@
+#ifndef X_RING_BUFFER_H
+#define X_RING_BUFFER_H
+
+#include "XVector.h"
+
+#include <stddef.h>    // size_t
+#include <stdexcept>   // std::out_of_range
+#include <utility>     // std::exchange, std::forward, std::pair, std::swap
+#include <type_traits> // std::is_trivially_copyable_v, std::is_trivially_destructible_v, std::is_nothrow_move_constructible_v, std::is_nothrow_swappable_v, std::conditional_t
+#include <new>         // ::operator new, ::operator delete
+#include <iterator>    // std::random_access_iterator_tag, std::reverse_iterator
+#include <cstring>     // std::memcpy, std::memmove
+#include <algorithm>   // std::min, std::rotate
+
+namespace xvc {
+
+// what a push does when the buffer is already full
+enum class RingOverflow
+{
+    reject,     // push fails and the buffer is left untouched
+    overwrite   // the oldest element is dropped to make room
+};
+
+// XRingBuffer is a fixed capacity FIFO over a single allocation. the capacity is rounded up
+// with nextPowerOf2 so a logical index wraps with a mask instead of a modulo, and any run of
+// elements occupies at most two contiguous pieces of the buffer.
+template<typename T>
+class XRingBuffer
+{
+private:
+    // member variables
+    size_t head_;   // slot of the oldest element
+    size_t size_;
+    size_t mask_;   // capacity - 1
+    T* data_;
+    RingOverflow overflow_;
+
+    // private methods
+    size_t slot(size_t) const noexcept;
+    void dropFront(size_t) noexcept;
+    void copyFrom(const XRingBuffer<T>&);
+
+    template<bool Const>
+    class Iterator
+    {
+    private:
+        using owner_type = std::conditional_t<Const, const XRingBuffer<T>, XRingBuffer<T>>;
+
+        owner_type* owner_;
+        size_t idx_;
+
+        friend class Iterator<!Const>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        Iterator() noexcept : owner_(nullptr), idx_(0) {}
+        Iterator(owner_type* owner, size_t idx) noexcept : owner_(owner), idx_(idx) {}
+
+        template<bool C = Const, typename = std::enable_if_t<C>>
+        Iterator(const Iterator<false>& other) noexcept : owner_(other.owner_), idx_(other.idx_) {}
+
+        reference operator*() const noexcept { return (*owner_)[idx_]; }
+        pointer operator->() const noexcept { return &(*owner_)[idx_]; }
+        reference operator[](difference_type n) const noexcept { return (*owner_)[idx_ + n]; }
+
+        Iterator& operator++() noexcept { ++idx_; return *this; }
+        Iterator operator++(int) noexcept { Iterator tmp = *this; ++idx_; return tmp; }
+        Iterator& operator--() noexcept { --idx_; return *this; }
+        Iterator operator--(int) noexcept { Iterator tmp = *this; --idx_; return tmp; }
+        Iterator& operator+=(difference_type n) noexcept { idx_ += n; return *this; }
+        Iterator& operator-=(difference_type n) noexcept { idx_ -= n; return *this; }
+        friend Iterator operator+(Iterator it, difference_type n) noexcept { return it += n; }
+        friend Iterator operator+(difference_type n, Iterator it) noexcept { return it += n; }
+        friend Iterator operator-(Iterator it, difference_type n) noexcept { return it -= n; }
+        friend difference_type operator-(const Iterator& a, const Iterator& b) noexcept
+        {
+            return static_cast<difference_type>(a.idx_) - static_cast<difference_type>(b.idx_);
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) noexcept { return a.idx_ == b.idx_; }
+        friend bool operator!=(const Iterator& a, const Iterator& b) noexcept { return a.idx_ != b.idx_; }
+        friend bool operator<(const Iterator& a, const Iterator& b) noexcept { return a.idx_ < b.idx_; }
+        friend bool operator>(const Iterator& a, const Iterator& b) noexcept { return a.idx_ > b.idx_; }
+        friend bool operator<=(const Iterator& a, const Iterator& b) noexcept { return a.idx_ <= b.idx_; }
+        friend bool operator>=(const Iterator& a, const Iterator& b) noexcept { return a.idx_ >= b.idx_; }
+    };
+
+public:
+    // type aliases for STL compatibility
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // constructors and destructor
+    explicit XRingBuffer(size_t, RingOverflow = RingOverflow::reject);
+    XRingBuffer(const XRingBuffer<T>&);
+    XRingBuffer(XRingBuffer<T>&&) noexcept;
+    ~XRingBuffer();
+
+    // assignment operator
+    XRingBuffer<T>& operator=(const XRingBuffer<T>&);
+    XRingBuffer<T>& operator=(XRingBuffer<T>&&) noexcept;
+
+    // element access, index 0 is the oldest element
+    T& operator[](size_t) noexcept;
+    const T& operator[](size_t) const noexcept;
+    [[nodiscard]] T& at(size_t n);
+    [[nodiscard]] const T& at(size_t n) const;
+    T& front() noexcept;
+    const T& front() const noexcept;
+    T& back() noexcept;
+    const T& back() const noexcept;
+
+    // contiguous views: the elements are array_one() followed by array_two()
+    [[nodiscard]] std::pair<T*, size_t> array_one() noexcept;
+    [[nodiscard]] std::pair<T*, size_t> array_two() noexcept;
+    [[nodiscard]] std::pair<const T*, size_t> array_one() const noexcept;
+    [[nodiscard]] std::pair<const T*, size_t> array_two() const noexcept;
+    T* linearize();
+
+    // iterators
+    iterator begin() noexcept;
+    const_iterator begin() const noexcept;
+    iterator end() noexcept;
+    const_iterator end() const noexcept;
+    reverse_iterator rbegin() noexcept;
+    const_reverse_iterator rbegin() const noexcept;
+    reverse_iterator rend() noexcept;
+    const_reverse_iterator rend() const noexcept;
+
+    // capacity
+    [[nodiscard]] size_t size() const noexcept;
+    [[nodiscard]] size_t capacity() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] bool full() const noexcept;
+    [[nodiscard]] RingOverflow overflow() const noexcept;
+
+    // modifiers, single pushes return false if the element was rejected
+    bool push_back(const T&);
+    bool push_back(T&&);
+    template<typename... Args>
+    bool emplace_back(Args&&...);
+    void pop_front();
+    size_t push_back(const T* src, size_t count);
+    size_t pop_front(T* dest, size_t count);
+    size_t push_back(const XVector<T>&);
+    void clear() noexcept;
+    void swap(XRingBuffer<T>& other) noexcept;
+};
+
+template<typename T>
+size_t XRingBuffer<T>::slot(size_t idx) const noexcept
+{
+    return (head_ + idx) & mask_;
+}
+
+template<typename T>
+void XRingBuffer<T>::dropFront(size_t count) noexcept
+{
+    if constexpr (!std::is_trivially_destructible_v<T>)
+    {
+        for (size_t i = 0; i < count; ++i)
+            data_[slot(i)].~T();
+    }
+    head_ = slot(count);
+    size_ -= count;
+}
+
+template<typename T>
+void XRingBuffer<T>::copyFrom(const XRingBuffer<T>& other)
+{
+    // elements are stored linearized starting at slot 0
+    const auto one = other.array_one();
+    const auto two = other.array_two();
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        std::memcpy(data_, one.first, one.second * sizeof(T));
+        std::memcpy(data_ + one.second, two.first, two.second * sizeof(T));
+        size_ = other.size_;
+    }
+    else
+    {
+        for (size_t i = 0; i < one.second; ++i, ++size_)
+            new (&data_[size_]) T(one.first[i]);
+        for (size_t i = 0; i < two.second; ++i, ++size_)
+            new (&data_[size_]) T(two.first[i]);
+    }
+}
+
+template<typename T>
+XRingBuffer<T>::XRingBuffer(size_t capacity, RingOverflow overflow)
+    : head_(0), size_(0), mask_(detail::nextPowerOf2(capacity) - 1),
+      data_(static_cast<T*>(::operator new((mask_ + 1) * sizeof(T)))), overflow_(overflow) {}
+
+template<typename T>
+XRingBuffer<T>::XRingBuffer(const XRingBuffer<T>& other)
+    : head_(0), size_(0), mask_(other.mask_),
+      data_(static_cast<T*>(::operator new((mask_ + 1) * sizeof(T)))), overflow_(other.overflow_)
+{
+    try
+    {
+        copyFrom(other);
+    }
+    catch (...)
+    {
+        clear();
+        ::operator delete(data_);
+        throw;
+    }
+}
+
+template<typename T>
+XRingBuffer<T>::XRingBuffer(XRingBuffer<T>&& other) noexcept
+    : head_(std::exchange(other.head_, 0)), size_(std::exchange(other.size_, 0)), mask_(std::exchange(other.mask_, 0)),
+      data_(std::exchange(other.data_, nullptr)), overflow_(other.overflow_) {}
+
+template<typename T>
+XRingBuffer<T>::~XRingBuffer()
+{
+    clear();
+    ::operator delete(data_);
+}
+
+template<typename T>
+XRingBuffer<T>& XRingBuffer<T>::operator=(const XRingBuffer<T>& other)
+{
+    if (this != &other)
+    {
+        if (mask_ == other.mask_ && data_)
+        {
+            clear();
+            head_ = 0;
+            overflow_ = other.overflow_;
+            copyFrom(other);
+        }
+        else
+        {
+            XRingBuffer<T> tmp(other); // for exception safety
+            swap(tmp);
+        }
+    }
+    return *this;
+}
+
+template<typename T>
+XRingBuffer<T>& XRingBuffer<T>::operator=(XRingBuffer<T>&& other) noexcept
+{
+    if (this != &other)
+    {
+        clear();
+        ::operator delete(data_);
+
+        head_ = std::exchange(other.head_, 0);
+        size_ = std::exchange(other.size_, 0);
+        mask_ = std::exchange(other.mask_, 0);
+        data_ = std::exchange(other.data_, nullptr);
+        overflow_ = other.overflow_;
+    }
+    return *this;
+}
+
+template<typename T>
+T& XRingBuffer<T>::operator[](size_t idx) noexcept {
+    XVECTOR_BOUNDS_CHECK(idx);
+    return data_[slot(idx)]; // no bounds checking for performance
+}
+
+template<typename T>
+const T& XRingBuffer<T>::operator[](size_t idx) const noexcept {
+    XVECTOR_BOUNDS_CHECK(idx);
+    return data_[slot(idx)];
+}
+
+template<typename T>
+T& XRingBuffer<T>::at(size_t idx)
+{
+    if (idx >= size_) throw std::out_of_range("XRingBuffer index out of bounds.");
+
+    return data_[slot(idx)];
+}
+
+template<typename T>
+const T& XRingBuffer<T>::at(size_t idx) const
+{
+    if (idx >= size_) throw std::out_of_range("XRingBuffer index out of bounds.");
+
+    return data_[slot(idx)];
+}
+
+template<typename T>
+T& XRingBuffer<T>::front() noexcept {
+    XVECTOR_EMPTY_CHECK();
+    return data_[head_];
+}
+
+template<typename T>
+const T& XRingBuffer<T>::front() const noexcept {
+    XVECTOR_EMPTY_CHECK();
+    return data_[head_];
+}
+
+template<typename T>
+T& XRingBuffer<T>::back() noexcept {
+    XVECTOR_EMPTY_CHECK();
+    return data_[slot(size_ - 1)];
+}
+
+template<typename T>
+const T& XRingBuffer<T>::back() const noexcept {
+    XVECTOR_EMPTY_CHECK();
+    return data_[slot(size_ - 1)];
+}
+
+template<typename T>
+std::pair<T*, size_t> XRingBuffer<T>::array_one() noexcept
+{
+    return { data_ + head_, std::min(size_, mask_ + 1 - head_) };
+}
+
+template<typename T>
+std::pair<T*, size_t> XRingBuffer<T>::array_two() noexcept
+{
+    return { data_, size_ - std::min(size_, mask_ + 1 - head_) };
+}
+
+template<typename T>
+std::pair<const T*, size_t> XRingBuffer<T>::array_one() const noexcept
+{
+    return { data_ + head_, std::min(size_, mask_ + 1 - head_) };
+}
+
+template<typename T>
+std::pair<const T*, size_t> XRingBuffer<T>::array_two() const noexcept
+{
+    return { data_, size_ - std::min(size_, mask_ + 1 - head_) };
+}
+
+// makes the elements one contiguous array and returns its start. the buffer is rearranged in
+// place, only a T whose move can throw is copied through a new allocation.
+template<typename T>
+T* XRingBuffer<T>::linearize()
+{
+    const size_t capacity = mask_ + 1;
+    if (head_ + size_ <= capacity) return data_ + head_; // already contiguous
+
+    if constexpr (std::is_trivially_copyable_v<T> ||
+                  (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_swappable_v<T>))
+    {
+        // wrapped, so rotate in place: slide the older piece down against the newer one at slot
+        // 0, closing the free gap between them, then rotate the older piece to the front
+        const size_t wrapped = head_ + size_ - capacity; // newer elements, in slots [0, wrapped)
+        const size_t older = size_ - wrapped;            // in slots [head_, capacity)
+        T* dest = data_ + wrapped;
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            std::memmove(dest, data_ + head_, older * sizeof(T));
+        }
+        else if (dest != data_ + head_) // a full buffer has no gap to close
+        {
+            for (size_t i = 0; i < older; ++i)
+            {
+                new (&dest[i]) T(std::move(data_[head_ + i]));
+                data_[head_ + i].~T();
+            }
+        }
+        std::rotate(data_, dest, dest + older);
+    }
+    else
+    {
+        // a move that can throw would leave the pieces half rotated, so copy into a new buffer
+        T* newData = static_cast<T*>(::operator new(capacity * sizeof(T)));
+        size_t i = 0;
+        try
+        {
+            for (; i < size_; ++i)
+                new (&newData[i]) T(std::move_if_noexcept((*this)[i]));
+        }
+        catch (...)
+        {
+            for (size_t j = 0; j < i; ++j)
+                newData[j].~T();
+
+            ::operator delete(newData);
+            throw;
+        }
+
+        const size_t count = size_;
+        clear();
+        ::operator delete(data_);
+
+        data_ = newData;
+        size_ = count;
+    }
+
+    head_ = 0;
+    return data_;
+}
+
+template<typename T>
+typename XRingBuffer<T>::iterator XRingBuffer<T>::begin() noexcept { return iterator(this, 0); }
+
+template<typename T>
+typename XRingBuffer<T>::const_iterator XRingBuffer<T>::begin() const noexcept { return const_iterator(this, 0); }
+
+template<typename T>
+typename XRingBuffer<T>::iterator XRingBuffer<T>::end() noexcept { return iterator(this, size_); }
+
+template<typename T>
+typename XRingBuffer<T>::const_iterator XRingBuffer<T>::end() const noexcept { return const_iterator(this, size_); }
+
+template<typename T>
+typename XRingBuffer<T>::reverse_iterator XRingBuffer<T>::rbegin() noexcept { return reverse_iterator(end()); }
+
+template<typename T>
+typename XRingBuffer<T>::const_reverse_iterator XRingBuffer<T>::rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+template<typename T>
+typename XRingBuffer<T>::reverse_iterator XRingBuffer<T>::rend() noexcept { return reverse_iterator(begin()); }
+
+template<typename T>
+typename XRingBuffer<T>::const_reverse_iterator XRingBuffer<T>::rend() const noexcept { return const_reverse_iterator(begin()); }
+
+template<typename T>
+size_t XRingBuffer<T>::size() const noexcept { return size_; }
+
+template<typename T>
+size_t XRingBuffer<T>::capacity() const noexcept { return data_ ? mask_ + 1 : 0; }
+
+template<typename T>
+bool XRingBuffer<T>::empty() const noexcept
+{
+    return (size_ == 0);
+}
+
+template<typename T>
+bool XRingBuffer<T>::full() const noexcept
+{
+    return (size_ == capacity());
+}
+
+template<typename T>
+RingOverflow XRingBuffer<T>::overflow() const noexcept { return overflow_; }
+
+template<typename T>
+bool XRingBuffer<T>::push_back(const T& item) { return emplace_back(item); }
+
+template<typename T>
+bool XRingBuffer<T>::push_back(T&& item) { return emplace_back(std::move(item)); }
+
+template<typename T>
+template<typename... Args>
+bool XRingBuffer<T>::emplace_back(Args&&... args)
+{
+    if (full())
+    {
+        if (overflow_ == RingOverflow::reject || !data_) return false;
+
+        // the tail slot is the head slot, so the oldest element makes room. the new one is built
+        // first, args may refer to the element being dropped
+        T* dest = &data_[head_];
+        T tmp(std::forward<Args>(args)...);
+        dropFront(1);
+        new (dest) T(std::move(tmp));
+        ++size_;
+        return true;
+    }
+
+    new (&data_[slot(size_)]) T(std::forward<Args>(args)...);
+    ++size_;
+    return true;
+}
+
+template<typename T>
+void XRingBuffer<T>::pop_front()
+{
+    XVECTOR_EMPTY_CHECK();
+    dropFront(1); // no check for performance
+}
+
+template<typename T>
+size_t XRingBuffer<T>::push_back(const T* src, size_t count)
+{
+    const size_t cap = capacity();
+    if (overflow_ == RingOverflow::reject)
+    {
+        count = std::min(count, cap - size_);
+    }
+    else if (count > cap)
+    {
+        // only the newest capacity() elements would survive anyway
+        src += count - cap;
+        count = cap;
+    }
+    if (count == 0) return 0;
+
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        if (size_ + count > cap) dropFront(size_ + count - cap);
+
+        // at most two memcpy's, up to the physical end of the buffer and then from slot 0
+        const size_t tail = slot(size_);
+        const size_t first = std::min(count, cap - tail);
+        std::memcpy(data_ + tail, src, first * sizeof(T));
+        std::memcpy(data_, src + first, (count - first) * sizeof(T));
+        size_ += count;
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+            emplace_back(src[i]);
+    }
+    return count;
+}
+
+template<typename T>
+size_t XRingBuffer<T>::pop_front(T* dest, size_t count)
+{
+    count = std::min(count, size_);
+    if (count == 0) return 0;
+
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        const size_t first = std::min(count, mask_ + 1 - head_);
+        std::memcpy(dest, data_ + head_, first * sizeof(T));
+        std::memcpy(dest + first, data_, (count - first) * sizeof(T));
+    }
+    else
+    {
+        // dest must hold constructed objects, elements are move assigned into it
+        for (size_t i = 0; i < count; ++i)
+            dest[i] = std::move(data_[slot(i)]);
+    }
+    dropFront(count);
+    return count;
+}
+
+template<typename T>
+size_t XRingBuffer<T>::push_back(const XVector<T>& items)
+{
+    return push_back(items.data(), items.size());
+}
+
+template<typename T>
+void XRingBuffer<T>::clear() noexcept
+{
+    if (data_) dropFront(size_);
+    head_ = 0;
+}
+
+template<typename T>
+void XRingBuffer<T>::swap(XRingBuffer<T>& other) noexcept {
+    std::swap(head_, other.head_);
+    std::swap(size_, other.size_);
+    std::swap(mask_, other.mask_);
+    std::swap(data_, other.data_);
+    std::swap(overflow_, other.overflow_);
+}
+
+} // namespace xvc
+
+#endif // X_RING_BUFFER_H
@@ -0,0 +1,308 @@
+#ifndef X_SEARCH_H
+#define X_SEARCH_H
+
+#include "XVector.h"
+
+#include <stddef.h>    // size_t
+#include <stdint.h>    // uint64_t
+#include <initializer_list> // std::initializer_list
+#include <algorithm>   // std::min
+#include <utility>     // std::pair
+
+namespace xvc {
+
+namespace simd {
+
+// the search kernels compare whole vectors of elements against up to maxSearchValues broadcast
+// values at once. integers compare bit patterns, float and double use ordered IEEE equality,
+// so -0.0 finds 0.0 and NaN is never found, exactly like the scalar loop.
+inline constexpr size_t maxSearchValues = 8;
+
+template<typename T>
+bool equalsAny(const T& x, const T* values, size_t k)
+{
+    for (size_t j = 0; j < k; ++j)
+        if (x == values[j]) return true;
+    return false;
+}
+
+template<typename T>
+size_t findAnyScalar(const T* data, size_t n, const T* values, size_t k, bool negate)
+{
+    for (size_t i = 0; i < n; ++i)
+        if (equalsAny(data[i], values, k) != negate) return i;
+    return n;
+}
+
+#if XVECTOR_SIMD_X86
+
+// index of the first element that equals one of values (or none of them when negate is set)
+template<typename T>
+XVECTOR_TARGET("sse2")
+inline size_t findAnySse2(const T* data, size_t n, const T* values, size_t k, bool negate) noexcept
+{
+    constexpr size_t lanes = 16 / sizeof(T);
+    __m128i v[maxSearchValues];
+    for (size_t j = 0; j < k; ++j)
+        v[j] = _mm_set1_epi64x(static_cast<long long>(broadcastPattern(values[j])));
+
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes)
+    {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        unsigned mask = 0;
+        for (size_t j = 0; j < k; ++j) mask |= eqMaskSse2<T>(a, v[j]);
+        if (negate) mask = ~mask & 0xFFFFu;
+        if (mask) return i + static_cast<size_t>(__builtin_ctz(mask)) / sizeof(T);
+    }
+    return i + findAnyScalar(data + i, n - i, values, k, negate);
+}
+
+template<typename T>
+XVECTOR_TARGET("avx2")
+inline size_t findAnyAvx2(const T* data, size_t n, const T* values, size_t k, bool negate) noexcept
+{
+    constexpr size_t lanes = 32 / sizeof(T);
+    __m256i v[maxSearchValues];
+    for (size_t j = 0; j < k; ++j)
+        v[j] = _mm256_set1_epi64x(static_cast<long long>(broadcastPattern(values[j])));
+
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes)
+    {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        unsigned mask = 0;
+        for (size_t j = 0; j < k; ++j) mask |= eqMaskAvx2<T>(a, v[j]);
+        if (negate) mask = ~mask;
+        if (mask) return i + static_cast<size_t>(__builtin_ctz(mask)) / sizeof(T);
+    }
+    return i + findAnyScalar(data + i, n - i, values, k, negate);
+}
+
+template<typename T>
+XVECTOR_TARGET("avx512f,avx512bw")
+inline size_t findAnyAvx512(const T* data, size_t n, const T* values, size_t k, bool negate) noexcept
+{
+    constexpr size_t lanes = 64 / sizeof(T);
+    constexpr uint64_t full = lanes == 64 ? ~uint64_t(0) : (uint64_t(1) << lanes) - 1;
+    __m512i v[maxSearchValues];
+    for (size_t j = 0; j < k; ++j)
+        v[j] = _mm512_set1_epi64(static_cast<long long>(broadcastPattern(values[j])));
+
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes)
+    {
+        const __m512i a = _mm512_loadu_si512(data + i);
+        uint64_t mask = 0;
+        for (size_t j = 0; j < k; ++j) mask |= eqMaskAvx512<T>(a, v[j]);
+        if (negate) mask = ~mask & full;
+        if (mask) return i + static_cast<size_t>(__builtin_ctzll(mask));
+    }
+    return i + findAnyScalar(data + i, n - i, values, k, negate);
+}
+
+template<typename T>
+XVECTOR_TARGET("sse2")
+inline size_t countEqualSse2(const T* data, size_t n, const T& value) noexcept
+{
+    constexpr size_t lanes = 16 / sizeof(T);
+    const __m128i v = _mm_set1_epi64x(static_cast<long long>(broadcastPattern(value)));
+    size_t bits = 0;
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes)
+        bits += static_cast<size_t>(__builtin_popcount(eqMaskSse2<T>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), v)));
+
+    size_t found = bits / sizeof(T);
+    for (; i < n; ++i) found += data[i] == value;
+    return found;
+}
+
+template<typename T>
+XVECTOR_TARGET("avx2,popcnt")
+inline size_t countEqualAvx2(const T* data, size_t n, const T& value) noexcept
+{
+    constexpr size_t lanes = 32 / sizeof(T);
+    const __m256i v = _mm256_set1_epi64x(static_cast<long long>(broadcastPattern(value)));
+    size_t bits = 0;
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes)
+        bits += static_cast<size_t>(__builtin_popcount(eqMaskAvx2<T>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), v)));
+
+    size_t found = bits / sizeof(T);
+    for (; i < n; ++i) found += data[i] == value;
+    return found;
+}
+
+template<typename T>
+XVECTOR_TARGET("avx512f,avx512bw,popcnt")
+inline size_t countEqualAvx512(const T* data, size_t n, const T& value) noexcept
+{
+    constexpr size_t lanes = 64 / sizeof(T);
+    const __m512i v = _mm512_set1_epi64(static_cast<long long>(broadcastPattern(value)));
+    size_t found = 0;
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes)
+        found += static_cast<size_t>(__builtin_popcountll(eqMaskAvx512<T>(_mm512_loadu_si512(data + i), v)));
+
+    for (; i < n; ++i) found += data[i] == value;
+    return found;
+}
+
+#endif // XVECTOR_SIMD_X86
+
+// index of the first element equal to one of the k values, or to none of them when negate is
+// set, n when there is no such element. more than maxSearchValues values take the scalar loop.
+template<typename T>
+size_t findAny(const T* data, size_t n, const T* values, size_t k, bool negate) noexcept
+{
+#if XVECTOR_SIMD_X86
+    if (k <= maxSearchValues)
+    {
+        switch (detectIsa())
+        {
+            case Isa::avx512: return findAnyAvx512(data, n, values, k, negate);
+            case Isa::avx2:   return findAnyAvx2(data, n, values, k, negate);
+            case Isa::sse2:   return findAnySse2(data, n, values, k, negate);
+            default: break;
+        }
+    }
+#endif
+    return findAnyScalar(data, n, values, k, negate);
+}
+
+template<typename T>
+size_t countEqual(const T* data, size_t n, const T& value) noexcept
+{
+#if XVECTOR_SIMD_X86
+    switch (detectIsa())
+    {
+        case Isa::avx512: return countEqualAvx512(data, n, value);
+        case Isa::avx2:   return countEqualAvx2(data, n, value);
+        case Isa::sse2:   return countEqualSse2(data, n, value);
+        default: break;
+    }
+#endif
+    size_t found = 0;
+    for (size_t i = 0; i < n; ++i) found += data[i] == value;
+    return found;
+}
+
+} // namespace simd
+
+namespace detail {
+
+template<typename T>
+size_t findIndex(const XVector<T>& vec, const T* values, size_t k, bool negate) noexcept(simd::searchable_v<T>)
+{
+    if constexpr (simd::searchable_v<T>)
+        return simd::findAny(vec.data(), vec.size(), values, k, negate);
+    else
+        return simd::findAnyScalar(vec.data(), vec.size(), values, k, negate);
+}
+
+template<typename T>
+size_t mismatchIndex(const XVector<T>& left, const XVector<T>& right) noexcept(simd::searchable_v<T>)
+{
+    const size_t common = std::min(left.size(), right.size());
+    if constexpr (simd::searchable_v<T>)
+        return simd::mismatch(left.data(), right.data(), common);
+    else
+        return simd::mismatchScalar(left.data(), right.data(), common);
+}
+
+} // namespace detail
+
+// searches over XVector. arithmetic element types use the SIMD kernels above, anything else
+// falls back to an element loop with operator==. the find functions return end() when nothing
+// matches, like std::find.
+
+template<typename T>
+T* find(XVector<T>& vec, const T& value) noexcept(simd::searchable_v<T>)
+{
+    return vec.data() + detail::findIndex(vec, &value, 1, false);
+}
+
+template<typename T>
+const T* find(const XVector<T>& vec, const T& value) noexcept(simd::searchable_v<T>)
+{
+    return vec.data() + detail::findIndex(vec, &value, 1, false);
+}
+
+// first element equal to any of values
+template<typename T>
+T* find_if_equal(XVector<T>& vec, std::initializer_list<T> values) noexcept(simd::searchable_v<T>)
+{
+    return vec.data() + detail::findIndex(vec, values.begin(), values.size(), false);
+}
+
+template<typename T>
+const T* find_if_equal(const XVector<T>& vec, std::initializer_list<T> values) noexcept(simd::searchable_v<T>)
+{
+    return vec.data() + detail::findIndex(vec, values.begin(), values.size(), false);
+}
+
+// first element that differs from value, or from every one of values
+template<typename T>
+T* find_first_not_of(XVector<T>& vec, const T& value) noexcept(simd::searchable_v<T>)
+{
+    return vec.data() + detail::findIndex(vec, &value, 1, true);
+}
+
+template<typename T>
+const T* find_first_not_of(const XVector<T>& vec, const T& value) noexcept(simd::searchable_v<T>)
+{
+    return vec.data() + detail::findIndex(vec, &value, 1, true);
+}
+
+template<typename T>
+T* find_first_not_of(XVector<T>& vec, std::initializer_list<T> values) noexcept(simd::searchable_v<T>)
+{
+    return vec.data() + detail::findIndex(vec, values.begin(), values.size(), true);
+}
+
+template<typename T>
+const T* find_first_not_of(const XVector<T>& vec, std::initializer_list<T> values) noexcept(simd::searchable_v<T>)
+{
+    return vec.data() + detail::findIndex(vec, values.begin(), values.size(), true);
+}
+
+template<typename T>
+bool contains(const XVector<T>& vec, const T& value) noexcept(simd::searchable_v<T>)
+{
+    return detail::findIndex(vec, &value, 1, false) != vec.size();
+}
+
+template<typename T>
+size_t count(const XVector<T>& vec, const T& value) noexcept(simd::searchable_v<T>)
+{
+    if constexpr (simd::searchable_v<T>)
+    {
+        return simd::countEqual(vec.data(), vec.size(), value);
+    }
+    else
+    {
+        size_t found = 0;
+        for (const T& x : vec) found += x == value;
+        return found;
+    }
+}
+
+// the first position where left and right differ, within the shorter of the two, like std::mismatch.
+// float and double compare as values: -0.0 matches 0.0, NaN matches nothing.
+template<typename T>
+std::pair<T*, T*> mismatch(XVector<T>& left, XVector<T>& right) noexcept(simd::searchable_v<T>)
+{
+    const size_t i = detail::mismatchIndex(left, right);
+    return { left.data() + i, right.data() + i };
+}
+
+template<typename T>
+std::pair<const T*, const T*> mismatch(const XVector<T>& left, const XVector<T>& right) noexcept(simd::searchable_v<T>)
+{
+    const size_t i = detail::mismatchIndex(left, right);
+    return { left.data() + i, right.data() + i };
+}
+
+} // namespace xvc
+
+#endif // X_SEARCH_H
@@ -0,0 +1,501 @@
+#ifndef X_SIMD_H
+#define X_SIMD_H
+
+#include <stddef.h>    // size_t
+#include <stdint.h>    // uint64_t, uintptr_t
+#include <cstring>     // std::memcpy
+#include <type_traits> // std::conditional_t, std::is_arithmetic_v, std::is_floating_point_v, std::is_same_v, std::is_trivially_copyable_v
+
+// x86 kernels are compiled per instruction set with target attributes and picked at runtime,
+// so the library does not need -mavx2 and still runs on older CPUs. define XVECTOR_NO_SIMD to
+// fall back to portable code everywhere.
+#if !defined(XVECTOR_NO_SIMD) && (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #define XVECTOR_SIMD_X86 1
+    #include <immintrin.h>
+    #define XVECTOR_TARGET(isa) __attribute__((target(isa)))
+    // generic vector-extension bodies are forced inline into each target-specific kernel,
+    // so they are compiled once per instruction set
+    #define XVECTOR_ALWAYS_INLINE __attribute__((always_inline))
+#else
+    #define XVECTOR_SIMD_X86 0
+    #define XVECTOR_TARGET(isa)
+    #define XVECTOR_ALWAYS_INLINE
+#endif
+
+namespace xvc {
+
+// fills of at least this many bytes use non-temporal stores so they do not evict the working set
+inline size_t simd_stream_threshold = size_t(1) << 22;
+
+// copies of at least this many bytes are streamed, set per vector with XVector::set_stream_mode.
+// a copied buffer is usually read again soon, so this is higher than the fill threshold.
+inline size_t stream_copy_threshold = size_t(1) << 26;
+
+namespace simd {
+
+enum class Isa
+{
+    scalar,
+    sse2,
+    avx2,
+    avx512
+};
+
+// detected once, the result never changes for the lifetime of the process
+inline Isa detectIsa() noexcept
+{
+#if XVECTOR_SIMD_X86
+    static const Isa isa = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) return Isa::avx512;
+        if (__builtin_cpu_supports("avx2")) return Isa::avx2;
+        if (__builtin_cpu_supports("sse2")) return Isa::sse2;
+        return Isa::scalar;
+    }();
+    return isa;
+#else
+    return Isa::scalar;
+#endif
+}
+
+// repeats an element of 1, 2, 4 or 8 bytes across 64 bits
+template<typename T>
+uint64_t broadcastPattern(const T& value) noexcept
+{
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8, "unsupported element width");
+
+    uint64_t pattern = 0;
+    std::memcpy(&pattern, &value, sizeof(T));
+    if constexpr (sizeof(T) <= 1) pattern |= pattern << 8;
+    if constexpr (sizeof(T) <= 2) pattern |= pattern << 16;
+    if constexpr (sizeof(T) <= 4) pattern |= pattern << 32;
+    return pattern;
+}
+
+// the pattern as seen from a destination that is offset bytes further along
+inline uint64_t rotatePattern(uint64_t pattern, size_t offset) noexcept
+{
+    const unsigned shift = static_cast<unsigned>(offset % 8) * 8;
+    return shift ? (pattern >> shift) | (pattern << (64 - shift)) : pattern;
+}
+
+inline void fillScalar(unsigned char* dest, size_t bytes, uint64_t pattern) noexcept
+{
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8)
+        std::memcpy(dest + i, &pattern, 8);
+    std::memcpy(dest + i, &pattern, bytes - i); // pattern period is 8, so the phase is unchanged
+}
+
+// element types the compare kernels below and in XSearch.h work on
+template<typename T>
+inline constexpr bool searchable_v = std::is_arithmetic_v<T> &&
+                                     (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+// index of the first position where a and b differ, n if they are equal. elements compare with
+// ==, so for floating point -0.0 matches 0.0 and NaN matches nothing, not even itself.
+template<typename T>
+size_t mismatchScalar(const T* a, const T* b, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        if (!(a[i] == b[i])) return i;
+    return n;
+}
+
+#if XVECTOR_SIMD_X86
+
+// the vector kernels align the destination first so that streaming stores are legal
+XVECTOR_TARGET("sse2")
+inline void fillSse2(unsigned char* dest, size_t bytes, uint64_t pattern, bool stream) noexcept
+{
+    size_t head = (0 - reinterpret_cast<uintptr_t>(dest)) & 15;
+    if (head > bytes) head = bytes;
+    fillScalar(dest, head, pattern);
+    dest += head;
+    bytes -= head;
+    pattern = rotatePattern(pattern, head);
+
+    const __m128i v = _mm_set1_epi64x(static_cast<long long>(pattern));
+    size_t i = 0;
+    if (stream)
+    {
+        for (; i + 64 <= bytes; i += 64)
+        {
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dest + i), v);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dest + i + 16), v);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dest + i + 32), v);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dest + i + 48), v);
+        }
+        _mm_sfence();
+    }
+    for (; i + 16 <= bytes; i += 16)
+        _mm_store_si128(reinterpret_cast<__m128i*>(dest + i), v);
+    fillScalar(dest + i, bytes - i, pattern);
+}
+
+XVECTOR_TARGET("avx2")
+inline void fillAvx2(unsigned char* dest, size_t bytes, uint64_t pattern, bool stream) noexcept
+{
+    size_t head = (0 - reinterpret_cast<uintptr_t>(dest)) & 31;
+    if (head > bytes) head = bytes;
+    fillScalar(dest, head, pattern);
+    dest += head;
+    bytes -= head;
+    pattern = rotatePattern(pattern, head);
+
+    const __m256i v = _mm256_set1_epi64x(static_cast<long long>(pattern));
+    size_t i = 0;
+    if (stream)
+    {
+        for (; i + 128 <= bytes; i += 128)
+        {
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(dest + i), v);
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(dest + i + 32), v);
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(dest + i + 64), v);
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(dest + i + 96), v);
+        }
+        _mm_sfence();
+    }
+    else
+    {
+        for (; i + 128 <= bytes; i += 128)
+        {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(dest + i), v);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(dest + i + 32), v);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(dest + i + 64), v);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(dest + i + 96), v);
+        }
+    }
+    for (; i + 32 <= bytes; i += 32)
+        _mm256_store_si256(reinterpret_cast<__m256i*>(dest + i), v);
+    fillScalar(dest + i, bytes - i, pattern);
+}
+
+XVECTOR_TARGET("avx512f")
+inline void fillAvx512(unsigned char* dest, size_t bytes, uint64_t pattern, bool stream) noexcept
+{
+    size_t head = (0 - reinterpret_cast<uintptr_t>(dest)) & 63;
+    if (head > bytes) head = bytes;
+    fillScalar(dest, head, pattern);
+    dest += head;
+    bytes -= head;
+    pattern = rotatePattern(pattern, head);
+
+    const __m512i v = _mm512_set1_epi64(static_cast<long long>(pattern));
+    size_t i = 0;
+    if (stream)
+    {
+        for (; i + 256 <= bytes; i += 256)
+        {
+            _mm512_stream_si512(reinterpret_cast<__m512i*>(dest + i), v);
+            _mm512_stream_si512(reinterpret_cast<__m512i*>(dest + i + 64), v);
+            _mm512_stream_si512(reinterpret_cast<__m512i*>(dest + i + 128), v);
+            _mm512_stream_si512(reinterpret_cast<__m512i*>(dest + i + 192), v);
+        }
+        _mm_sfence();
+    }
+    else
+    {
+        for (; i + 256 <= bytes; i += 256)
+        {
+            _mm512_store_si512(reinterpret_cast<__m512i*>(dest + i), v);
+            _mm512_store_si512(reinterpret_cast<__m512i*>(dest + i + 64), v);
+            _mm512_store_si512(reinterpret_cast<__m512i*>(dest + i + 128), v);
+            _mm512_store_si512(reinterpret_cast<__m512i*>(dest + i + 192), v);
+        }
+    }
+    for (; i + 64 <= bytes; i += 64)
+        _mm512_store_si512(reinterpret_cast<__m512i*>(dest + i), v);
+    fillScalar(dest + i, bytes - i, pattern);
+}
+
+// streaming copies prefetch this far ahead of the loads
+inline constexpr size_t streamPrefetchDistance = 1024;
+
+XVECTOR_TARGET("sse2")
+inline void streamCopySse2(unsigned char* dest, const unsigned char* src, size_t bytes) noexcept
+{
+    size_t head = (0 - reinterpret_cast<uintptr_t>(dest)) & 15;
+    if (head > bytes) head = bytes;
+    std::memcpy(dest, src, head);
+    dest += head;
+    src += head;
+    bytes -= head;
+
+    size_t i = 0;
+    for (; i + 64 <= bytes; i += 64)
+    {
+        if (i + streamPrefetchDistance < bytes)
+            _mm_prefetch(reinterpret_cast<const char*>(src + i + streamPrefetchDistance), _MM_HINT_NTA);
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 32));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dest + i), a);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dest + i + 16), b);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dest + i + 32), c);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dest + i + 48), d);
+    }
+    _mm_sfence();
+    std::memcpy(dest + i, src + i, bytes - i);
+}
+
+XVECTOR_TARGET("avx2")
+inline void streamCopyAvx2(unsigned char* dest, const unsigned char* src, size_t bytes) noexcept
+{
+    size_t head = (0 - reinterpret_cast<uintptr_t>(dest)) & 31;
+    if (head > bytes) head = bytes;
+    std::memcpy(dest, src, head);
+    dest += head;
+    src += head;
+    bytes -= head;
+
+    size_t i = 0;
+    for (; i + 128 <= bytes; i += 128)
+    {
+        if (i + streamPrefetchDistance < bytes)
+            _mm_prefetch(reinterpret_cast<const char*>(src + i + streamPrefetchDistance), _MM_HINT_NTA);
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 64));
+        const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 96));
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dest + i), a);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dest + i + 32), b);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dest + i + 64), c);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dest + i + 96), d);
+    }
+    _mm_sfence();
+    std::memcpy(dest + i, src + i, bytes - i);
+}
+
+XVECTOR_TARGET("avx512f")
+inline void streamCopyAvx512(unsigned char* dest, const unsigned char* src, size_t bytes) noexcept
+{
+    size_t head = (0 - reinterpret_cast<uintptr_t>(dest)) & 63;
+    if (head > bytes) head = bytes;
+    std::memcpy(dest, src, head);
+    dest += head;
+    src += head;
+    bytes -= head;
+
+    size_t i = 0;
+    for (; i + 256 <= bytes; i += 256)
+    {
+        if (i + streamPrefetchDistance < bytes)
+            _mm_prefetch(reinterpret_cast<const char*>(src + i + streamPrefetchDistance), _MM_HINT_NTA);
+        const __m512i a = _mm512_loadu_si512(src + i);
+        const __m512i b = _mm512_loadu_si512(src + i + 64);
+        const __m512i c = _mm512_loadu_si512(src + i + 128);
+        const __m512i d = _mm512_loadu_si512(src + i + 192);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dest + i), a);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dest + i + 64), b);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dest + i + 128), c);
+        _mm512_stream_si512(reinterpret_cast<__m512i*>(dest + i + 192), d);
+    }
+    _mm_sfence();
+    std::memcpy(dest + i, src + i, bytes - i);
+}
+
+// lane equality as a movemask, one bit per byte: a matching element sets sizeof(T) bits
+template<typename T>
+XVECTOR_TARGET("sse2")
+inline unsigned eqMaskSse2(__m128i a, __m128i b) noexcept
+{
+    if constexpr (std::is_same_v<T, float>)
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)))));
+    else if constexpr (std::is_same_v<T, double>)
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)))));
+    else if constexpr (sizeof(T) == 1)
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+    else if constexpr (sizeof(T) == 2)
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi16(a, b)));
+    else if constexpr (sizeof(T) == 4)
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi32(a, b)));
+    else
+    {
+        // no 64-bit compare before SSE4.1, both 32-bit halves have to match
+        const __m128i half = _mm_cmpeq_epi32(a, b);
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)))));
+    }
+}
+
+template<typename T>
+XVECTOR_TARGET("avx2")
+inline unsigned eqMaskAvx2(__m256i a, __m256i b) noexcept
+{
+    if constexpr (std::is_same_v<T, float>)
+        return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ))));
+    else if constexpr (std::is_same_v<T, double>)
+        return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ))));
+    else if constexpr (sizeof(T) == 1)
+        return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+    else if constexpr (sizeof(T) == 2)
+        return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(a, b)));
+    else if constexpr (sizeof(T) == 4)
+        return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi32(a, b)));
+    else
+        return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi64(a, b)));
+}
+
+// AVX-512 compares straight into a mask register, one bit per element
+template<typename T>
+XVECTOR_TARGET("avx512f,avx512bw")
+inline uint64_t eqMaskAvx512(__m512i a, __m512i b) noexcept
+{
+    if constexpr (std::is_same_v<T, float>)
+        return _mm512_cmp_ps_mask(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b), _CMP_EQ_OQ);
+    else if constexpr (std::is_same_v<T, double>)
+        return _mm512_cmp_pd_mask(_mm512_castsi512_pd(a), _mm512_castsi512_pd(b), _CMP_EQ_OQ);
+    else if constexpr (sizeof(T) == 1)
+        return _mm512_cmpeq_epi8_mask(a, b);
+    else if constexpr (sizeof(T) == 2)
+        return _mm512_cmpeq_epi16_mask(a, b);
+    else if constexpr (sizeof(T) == 4)
+        return _mm512_cmpeq_epi32_mask(a, b);
+    else
+        return _mm512_cmpeq_epi64_mask(a, b);
+}
+
+// integers are equal exactly when their bytes are, so they compare bytes, which SSE2 has for
+// every width. floating point compares elements as IEEE values.
+template<typename T>
+XVECTOR_TARGET("sse2")
+inline size_t mismatchSse2(const T* a, const T* b, size_t n) noexcept
+{
+    using Lane = std::conditional_t<std::is_floating_point_v<T>, T, unsigned char>;
+    constexpr size_t lanes = 16 / sizeof(T);
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes)
+    {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        const unsigned mask = ~eqMaskSse2<Lane>(x, y) & 0xFFFFu;
+        if (mask) return i + static_cast<size_t>(__builtin_ctz(mask)) / sizeof(T);
+    }
+    return i + mismatchScalar(a + i, b + i, n - i);
+}
+
+// two vectors per iteration, the masks are only split apart once a difference shows up
+template<typename T>
+XVECTOR_TARGET("avx2")
+inline size_t mismatchAvx2(const T* a, const T* b, size_t n) noexcept
+{
+    constexpr size_t lanes = 32 / sizeof(T);
+    size_t i = 0;
+    for (; i + 2 * lanes <= n; i += 2 * lanes)
+    {
+        const __m256i x0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i y0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        const __m256i x1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + lanes));
+        const __m256i y1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + lanes));
+        const uint64_t mask = ~(uint64_t(eqMaskAvx2<T>(x0, y0)) | uint64_t(eqMaskAvx2<T>(x1, y1)) << 32);
+        if (mask) return i + static_cast<size_t>(__builtin_ctzll(mask)) / sizeof(T);
+    }
+    for (; i + lanes <= n; i += lanes)
+    {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        const unsigned mask = ~eqMaskAvx2<T>(x, y);
+        if (mask) return i + static_cast<size_t>(__builtin_ctz(mask)) / sizeof(T);
+    }
+    return i + mismatchScalar(a + i, b + i, n - i);
+}
+
+template<typename T>
+XVECTOR_TARGET("avx512f,avx512bw")
+inline size_t mismatchAvx512(const T* a, const T* b, size_t n) noexcept
+{
+    constexpr size_t lanes = 64 / sizeof(T);
+    constexpr uint64_t full = lanes == 64 ? ~uint64_t(0) : (uint64_t(1) << lanes) - 1;
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes)
+    {
+        const uint64_t mask = ~eqMaskAvx512<T>(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i)) & full;
+        if (mask) return i + static_cast<size_t>(__builtin_ctzll(mask));
+    }
+    return i + mismatchScalar(a + i, b + i, n - i);
+}
+
+#endif // XVECTOR_SIMD_X86
+
+// fills bytes bytes at dest with the 8-byte periodic pattern, picking the widest kernel the CPU has
+inline void fillPattern(void* dest, size_t bytes, uint64_t pattern) noexcept
+{
+    unsigned char* out = static_cast<unsigned char*>(dest);
+#if XVECTOR_SIMD_X86
+    const bool stream = bytes >= simd_stream_threshold;
+    switch (detectIsa())
+    {
+        case Isa::avx512: fillAvx512(out, bytes, pattern, stream); return;
+        case Isa::avx2:   fillAvx2(out, bytes, pattern, stream); return;
+        case Isa::sse2:   fillSse2(out, bytes, pattern, stream); return;
+        default: break;
+    }
+#endif
+    fillScalar(out, bytes, pattern);
+}
+
+// count copies of a trivially copyable value at dest: broadcast vector stores for 1, 2, 4 and
+// 8-byte types (streaming past simd_stream_threshold), repeated doubling memcpy for the rest
+template<typename T>
+void fillTrivial(T* dest, size_t count, const T& value) noexcept
+{
+    static_assert(std::is_trivially_copyable_v<T>, "fillTrivial copies bytes");
+    if (count == 0) return;
+
+    if constexpr (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)
+    {
+        fillPattern(dest, count * sizeof(T), broadcastPattern(value));
+    }
+    else
+    {
+        std::memcpy(dest, &value, sizeof(T));
+        size_t filled = 1;
+        while (filled < count)
+        {
+            const size_t chunk = filled < count - filled ? filled : count - filled;
+            std::memcpy(dest + filled, dest, chunk * sizeof(T));
+            filled += chunk;
+        }
+    }
+}
+
+// copies with non-temporal stores, bypassing the caches on the destination side
+inline void streamCopy(void* dest, const void* src, size_t bytes) noexcept
+{
+#if XVECTOR_SIMD_X86
+    unsigned char* out = static_cast<unsigned char*>(dest);
+    const unsigned char* in = static_cast<const unsigned char*>(src);
+    switch (detectIsa())
+    {
+        case Isa::avx512: streamCopyAvx512(out, in, bytes); return;
+        case Isa::avx2:   streamCopyAvx2(out, in, bytes); return;
+        case Isa::sse2:   streamCopySse2(out, in, bytes); return;
+        default: break;
+    }
+#endif
+    if (bytes) std::memcpy(dest, src, bytes);
+}
+
+// mismatchScalar over the widest kernel the CPU has, for searchable_v element types
+template<typename T>
+size_t mismatch(const T* a, const T* b, size_t n) noexcept
+{
+    static_assert(searchable_v<T>, "mismatch kernels need an arithmetic element of 1, 2, 4 or 8 bytes");
+#if XVECTOR_SIMD_X86
+    switch (detectIsa())
+    {
+        case Isa::avx512: return mismatchAvx512(a, b, n);
+        case Isa::avx2:   return mismatchAvx2(a, b, n);
+        case Isa::sse2:   return mismatchSse2(a, b, n);
+        default: break;
+    }
+#endif
+    return mismatchScalar(a, b, n);
+}
+
+} // namespace simd
+
+} // namespace xvc
+
+#endif // X_SIMD_H
@@ -0,0 +1,568 @@
+#ifndef X_SORT_H
+#define X_SORT_H
+
+#include "XVector.h"
+
+#include <stddef.h>    // size_t
+#include <stdint.h>    // uint8_t, uint16_t, uint32_t, uint64_t
+#include <cstring>     // std::memcpy
+#include <algorithm>   // std::rotate, std::sort, std::stable_sort, std::merge, std::fill, std::min, std::max
+#include <functional>  // std::less
+#include <iterator>    // std::make_move_iterator
+#include <type_traits> // std::is_integral_v, std::is_floating_point_v, std::is_signed_v, std::is_unsigned_v, std::is_trivially_copyable_v, std::is_default_constructible_v, std::invoke_result_t, std::is_invocable_r_v
+#include <utility>     // std::swap, std::move
+#include <tuple>       // std::tuple, std::tie
+#include <limits>      // std::numeric_limits
+#include <stdexcept>   // std::length_error
+
+namespace xvc {
+
+// key types radix_sort can order: integers, float and double
+template<typename K>
+inline constexpr bool radix_sortable_v = (std::is_integral_v<K> || std::is_floating_point_v<K>) &&
+                                         (sizeof(K) == 1 || sizeof(K) == 2 || sizeof(K) == 4 || sizeof(K) == 8);
+
+namespace detail {
+
+template<size_t Bytes> struct UnsignedOfSize;
+template<> struct UnsignedOfSize<1> { using type = uint8_t; };
+template<> struct UnsignedOfSize<2> { using type = uint16_t; };
+template<> struct UnsignedOfSize<4> { using type = uint32_t; };
+template<> struct UnsignedOfSize<8> { using type = uint64_t; };
+
+// the key as an unsigned integer that sorts the same way. signed integers flip the sign bit;
+// floating point flips every bit of negatives and just the sign bit of the rest, which puts -0.0
+// before 0.0, negative NaNs first and positive NaNs last.
+template<typename K>
+auto radixKey(K key) noexcept
+{
+    using U = typename UnsignedOfSize<sizeof(K)>::type;
+    constexpr U sign = static_cast<U>(U(1) << (sizeof(K) * 8 - 1));
+    U bits;
+    std::memcpy(&bits, &key, sizeof(K));
+    if constexpr (std::is_floating_point_v<K>)
+        return static_cast<U>(bits & sign ? ~bits : bits | sign);
+    else if constexpr (std::is_signed_v<K>)
+        return static_cast<U>(bits ^ sign);
+    else
+        return bits;
+}
+
+// below this many elements the counting overhead is not worth it
+inline constexpr size_t radixInsertionLimit = 64;
+
+// stable, so that short record sorts keep the radix ordering guarantees
+template<typename R, typename KeyOf>
+void radixInsertionSort(R* data, size_t n, KeyOf keyOf)
+{
+    for (size_t i = 1; i < n; ++i)
+    {
+        const auto key = keyOf(data[i]);
+        size_t j = i;
+        while (j > 0 && key < keyOf(data[j - 1])) --j;
+        if (j != i) std::rotate(data + j, data + i, data + i + 1);
+    }
+}
+
+// LSD passes of Digit bits, from data into buffer and back. one read computes the histograms of
+// every digit, and a digit that is the same for all keys skips its pass. R is trivially copyable,
+// and buffer is raw storage for n of them.
+template<unsigned Digit, typename R, typename KeyOf>
+void radixPasses(R* data, R* buffer, size_t n, KeyOf keyOf)
+{
+    using U = decltype(keyOf(*data));
+    constexpr unsigned passes = (sizeof(U) * 8 + Digit - 1) / Digit;
+    constexpr size_t buckets = size_t(1) << Digit;
+    constexpr size_t mask = buckets - 1;
+
+    XVector<size_t> counts(passes * buckets, 0);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const U key = keyOf(data[i]);
+        for (unsigned p = 0; p < passes; ++p)
+            ++counts[p * buckets + ((key >> (p * Digit)) & mask)];
+    }
+
+    R* src = data;
+    R* dst = buffer;
+    for (unsigned p = 0; p < passes; ++p)
+    {
+        const unsigned shift = p * Digit;
+        size_t* offset = counts.data() + p * buckets;
+        if (offset[(keyOf(src[0]) >> shift) & mask] == n) continue;
+
+        size_t total = 0;
+        for (size_t b = 0; b < buckets; ++b)
+        {
+            const size_t c = offset[b];
+            offset[b] = total;
+            total += c;
+        }
+        for (size_t i = 0; i < n; ++i)
+            std::memcpy(&dst[offset[(keyOf(src[i]) >> shift) & mask]++], &src[i], sizeof(R));
+        std::swap(src, dst);
+    }
+    if (src != data) std::memcpy(data, src, n * sizeof(R));
+}
+
+// the digit width: one 16-bit pass for 16-bit keys once there are enough of them to fill the
+// buckets, 11 bits (3 passes for 32-bit keys, 6 for 64-bit) for long inputs of wider keys,
+// bytes otherwise
+template<typename R, typename KeyOf>
+void radixSort(R* data, R* buffer, size_t n, KeyOf keyOf)
+{
+    using U = decltype(keyOf(*data));
+    if (n <= radixInsertionLimit)
+        radixInsertionSort(data, n, keyOf);
+    else if constexpr (sizeof(U) == 1)
+        radixPasses<8>(data, buffer, n, keyOf);
+    else if constexpr (sizeof(U) == 2)
+        n >= (size_t(1) << 16) ? radixPasses<16>(data, buffer, n, keyOf) : radixPasses<8>(data, buffer, n, keyOf);
+    else
+        n >= (size_t(1) << 14) ? radixPasses<11>(data, buffer, n, keyOf) : radixPasses<8>(data, buffer, n, keyOf);
+}
+
+// runs sort(buffer) with raw room for vec.size() elements: the vector's own spare capacity when
+// there is enough of it, otherwise scratch (cleared and grown as needed) or a temporary
+template<typename R, typename Sort>
+void withRadixBuffer(XVector<R>& vec, XVector<R>* scratch, Sort&& sort)
+{
+    const size_t n = vec.size();
+    if (vec.capacity() - n >= n)
+    {
+        sort(vec.data() + n);
+    }
+    else if (scratch)
+    {
+        scratch->clear();
+        scratch->reserve(n);
+        sort(scratch->data());
+    }
+    else
+    {
+        XVector<R> temp;
+        temp.reserve(n);
+        sort(temp.data());
+    }
+}
+
+template<typename R, typename KeyFn>
+void radixSortBy(XVector<R>& vec, KeyFn& key, XVector<R>* scratch)
+{
+    using K = std::decay_t<std::invoke_result_t<KeyFn&, const R&>>;
+    static_assert(radix_sortable_v<K>, "radix_sort keys must be integers, float or double");
+
+    auto keyOf = [&key](const R& item) { return radixKey<K>(key(item)); };
+    if constexpr (std::is_trivially_copyable_v<R>)
+    {
+        withRadixBuffer(vec, scratch, [&](R* buffer) { radixSort(vec.data(), buffer, vec.size(), keyOf); });
+    }
+    else
+    {
+        // records that cannot be moved with memcpy take a comparison sort with the same order
+        std::stable_sort(vec.begin(), vec.end(), [&keyOf](const R& a, const R& b) { return keyOf(a) < keyOf(b); });
+    }
+}
+
+} // namespace detail
+
+// sorts vec in ascending order with an LSD radix sort, which is stable and runs in O(n) passes
+// over the data instead of O(n log n) comparisons. floating point sorts by value with -0.0 before
+// 0.0 and NaNs at the ends by sign, where std::sort's behaviour would be undefined. the second
+// buffer is the vector's spare capacity if it has room for another size() elements, otherwise a
+// temporary; pass a scratch XVector to reuse one allocation across calls.
+template<typename T>
+void radix_sort(XVector<T>& vec)
+{
+    static_assert(radix_sortable_v<T>, "radix_sort sorts integers, float or double, use the key overload for records");
+    auto identity = [](const T& x) { return x; };
+    detail::radixSortBy(vec, identity, static_cast<XVector<T>*>(nullptr));
+}
+
+template<typename T>
+void radix_sort(XVector<T>& vec, XVector<T>& scratch)
+{
+    static_assert(radix_sortable_v<T>, "radix_sort sorts integers, float or double, use the key overload for records");
+    auto identity = [](const T& x) { return x; };
+    detail::radixSortBy(vec, identity, &scratch);
+}
+
+// records by key(record), an integer or floating-point value; equal keys keep their order.
+// records that are not trivially copyable fall back to std::stable_sort on the same keys.
+template<typename R, typename KeyFn, typename = std::enable_if_t<std::is_invocable_v<KeyFn&, const R&>>>
+void radix_sort(XVector<R>& vec, KeyFn key)
+{
+    detail::radixSortBy(vec, key, static_cast<XVector<R>*>(nullptr));
+}
+
+template<typename R, typename KeyFn, typename = std::enable_if_t<std::is_invocable_v<KeyFn&, const R&>>>
+void radix_sort(XVector<R>& vec, KeyFn key, XVector<R>& scratch)
+{
+    detail::radixSortBy(vec, key, &scratch);
+}
+
+namespace detail {
+
+// comparators under which the parallel sorts may take the radix path instead of merging
+template<typename T, typename Compare>
+inline constexpr bool radixComparable_v = std::is_integral_v<T> && radix_sortable_v<T> &&
+                                          (std::is_same_v<Compare, std::less<T>> || std::is_same_v<Compare, std::less<>>);
+
+// like withRadixBuffer, but element types that cannot live in raw storage get a buffer of
+// constructed elements in scratch (or a temporary), which the sort moves through
+template<typename T, typename Sort>
+void withSortBuffer(XVector<T>& vec, XVector<T>* scratch, Sort&& sort)
+{
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        withRadixBuffer(vec, scratch, sort);
+    }
+    else
+    {
+        static_assert(std::is_default_constructible_v<T>,
+                      "parallel sorts of types that are not trivially copyable need a default constructor for their buffer");
+        XVector<T> temp;
+        XVector<T>& buffer = scratch ? *scratch : temp;
+        if (buffer.size() < vec.size()) buffer.resize(vec.size());
+        sort(buffer.data());
+    }
+}
+
+// one part per thread of the pool, none below the parallel minimum
+template<typename T>
+Partition sortPartition(size_t n, ThreadPool& pool) noexcept
+{
+    const size_t threads = pool.concurrency();
+    return Partition(n, std::max(parallelMinChunk<T>(), (n + threads - 1) / threads));
+}
+
+// moves n elements from src back to dest on the pool
+template<typename T>
+void parallelMoveBack(T* dest, T* src, size_t n, ThreadPool& pool)
+{
+    const Partition part = sortPartition<T>(n, pool);
+    pool.run(part.tasks, [&](size_t task) {
+        const size_t first = part.first(task);
+        if constexpr (std::is_trivially_copyable_v<T>)
+            std::memcpy(dest + first, src + first, (part.last(task) - first) * sizeof(T));
+        else
+            std::move(src + first, src + part.last(task), dest + first);
+    });
+}
+
+// LSD radix sort with each pass split into one block per thread: the blocks count their digits,
+// a prefix sum over (digit, block) gives every block its own output ranges, and the blocks
+// scatter into them. the order within a digit follows the blocks, so each pass stays stable.
+template<typename T>
+void parallelRadixSort(T* data, T* buffer, size_t n, ThreadPool& pool)
+{
+    using U = decltype(radixKey(*data));
+    constexpr unsigned Digit = sizeof(U) <= 2 ? 8 : 11;
+    constexpr unsigned passes = (sizeof(U) * 8 + Digit - 1) / Digit;
+    constexpr size_t buckets = size_t(1) << Digit;
+    constexpr size_t mask = buckets - 1;
+
+    const Partition part = sortPartition<T>(n, pool);
+    XVector<size_t> counts(part.tasks * buckets, 0);
+    T* src = data;
+    T* dst = buffer;
+    for (unsigned p = 0; p < passes; ++p)
+    {
+        const unsigned shift = p * Digit;
+        pool.run(part.tasks, [&](size_t task) {
+            size_t* count = counts.data() + task * buckets;
+            std::fill(count, count + buckets, size_t(0));
+            for (size_t i = part.first(task); i < part.last(task); ++i)
+                ++count[(radixKey(src[i]) >> shift) & mask];
+        });
+
+        size_t total = 0;
+        bool trivial = false;
+        for (size_t b = 0; b < buckets; ++b)
+        {
+            const size_t bucketStart = total;
+            for (size_t task = 0; task < part.tasks; ++task)
+            {
+                const size_t c = counts[task * buckets + b];
+                counts[task * buckets + b] = total;
+                total += c;
+            }
+            if (total - bucketStart == n) trivial = true;
+        }
+        if (trivial) continue;
+
+        pool.run(part.tasks, [&](size_t task) {
+            size_t* offset = counts.data() + task * buckets;
+            for (size_t i = part.first(task); i < part.last(task); ++i)
+                std::memcpy(&dst[offset[(radixKey(src[i]) >> shift) & mask]++], &src[i], sizeof(T));
+        });
+        std::swap(src, dst);
+    }
+    if (src != data) parallelMoveBack(data, src, n, pool);
+}
+
+// how many of the first d elements of merge(a, b) come from a, with a winning ties like
+// std::merge does. a binary search along the diagonal d of the merge path.
+template<typename T, typename Compare>
+size_t mergeSplit(const T* a, size_t na, const T* b, size_t nb, size_t d, Compare& comp)
+{
+    size_t lo = d > nb ? d - nb : 0;
+    size_t hi = std::min(d, na);
+    while (lo < hi)
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (!comp(b[d - mid - 1], a[mid])) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// a slice [from, to) of the output of merging the run starting at bound index run with the next,
+// and how many elements of the first run come before from and before to
+struct MergePiece
+{
+    size_t run;
+    size_t from;
+    size_t to;
+    size_t fromA;
+    size_t toA;
+};
+
+// sorts one run per thread, then merges neighbouring runs pairwise, moving between data and
+// buffer each round. every merge is cut into pieces along its merge path, so even the last
+// round, a single merge, is spread over the pool. the cuts are all found before any piece moves
+// elements out of the runs they search.
+template<bool Stable, typename T, typename Compare>
+void parallelMergeSort(T* data, T* buffer, size_t n, Compare& comp, ThreadPool& pool)
+{
+    const Partition runs = sortPartition<T>(n, pool);
+    pool.run(runs.tasks, [&](size_t task) {
+        if constexpr (Stable)
+            std::stable_sort(data + runs.first(task), data + runs.last(task), comp);
+        else
+            std::sort(data + runs.first(task), data + runs.last(task), comp);
+    });
+
+    XVector<size_t> bounds;
+    bounds.reserve(runs.tasks + 1);
+    for (size_t task = 0; task < runs.tasks; ++task) bounds.push_back(runs.first(task));
+    bounds.push_back(n);
+
+    const size_t piece = std::max(parallelMinChunk<T>(), n / (4 * pool.concurrency()));
+    XVector<MergePiece> pieces;
+    XVector<size_t> merged;
+    T* src = data;
+    T* dst = buffer;
+    while (bounds.size() > 2)
+    {
+        const size_t runCount = bounds.size() - 1;
+        pieces.clear();
+        for (size_t r = 0; r < runCount; r += 2)
+        {
+            // a last odd run merges with nothing
+            const size_t a0 = bounds[r];
+            const size_t b0 = bounds[r + 1];
+            const size_t b1 = bounds[std::min(r + 2, runCount)];
+            size_t fromA = 0;
+            for (size_t d = a0; d < b1; d += piece)
+            {
+                const size_t to = std::min(b1, d + piece);
+                const size_t toA = mergeSplit(src + a0, b0 - a0, src + b0, b1 - b0, to - a0, comp);
+                pieces.push_back({ r, d, to, fromA, toA });
+                fromA = toA;
+            }
+        }
+
+        pool.run(pieces.size(), [&](size_t k) {
+            const MergePiece& m = pieces[k];
+            T* a = src + bounds[m.run];
+            T* b = src + bounds[m.run + 1];
+            const size_t fromB = m.from - bounds[m.run] - m.fromA;
+            const size_t toB = m.to - bounds[m.run] - m.toA;
+            std::merge(std::make_move_iterator(a + m.fromA), std::make_move_iterator(a + m.toA),
+                       std::make_move_iterator(b + fromB), std::make_move_iterator(b + toB),
+                       dst + m.from, comp);
+        });
+
+        merged.clear();
+        for (size_t r = 0; r < runCount; r += 2) merged.push_back(bounds[r]);
+        merged.push_back(n);
+        std::swap(bounds, merged);
+        std::swap(src, dst);
+    }
+    if (src != data) parallelMoveBack(data, src, n, pool);
+}
+
+template<bool Stable, typename T, typename Compare>
+void parallelSort(XVector<T>& vec, XVector<T>* scratch, Compare& comp, ThreadPool& pool)
+{
+    const size_t n = vec.size();
+    const bool parallel = pool.concurrency() > 1 && n >= 2 * parallelMinChunk<T>();
+    if constexpr (radixComparable_v<T, Compare>)
+    {
+        withSortBuffer(vec, scratch, [&](T* buffer) {
+            if (parallel)
+                parallelRadixSort(vec.data(), buffer, n, pool);
+            else
+                radixSort(vec.data(), buffer, n, [](const T& x) { return radixKey(x); });
+        });
+    }
+    else if (!parallel)
+    {
+        if constexpr (Stable)
+            std::stable_sort(vec.begin(), vec.end(), comp);
+        else
+            std::sort(vec.begin(), vec.end(), comp);
+    }
+    else
+    {
+        withSortBuffer(vec, scratch, [&](T* buffer) { parallelMergeSort<Stable>(vec.data(), buffer, n, comp, pool); });
+    }
+}
+
+} // namespace detail
+
+// sorts vec on a ThreadPool, the global one unless another is passed: every thread sorts a run,
+// then the runs are merged in parallel. integers under std::less take a parallel radix sort
+// instead. the second buffer is found like radix_sort's; element types that are not trivially
+// copyable need a default constructor for it, and a scratch XVector that already holds size()
+// elements is used as is. comp is called concurrently. if it throws, vec is left in an
+// unspecified order, and for types that are not trivially copyable some elements may be
+// moved-from.
+template<typename T, typename Compare = std::less<>,
+         typename = std::enable_if_t<std::is_invocable_r_v<bool, Compare&, const T&, const T&>>>
+void parallel_sort(XVector<T>& vec, Compare comp = {}, ThreadPool& pool = ThreadPool::global())
+{
+    detail::parallelSort<false>(vec, static_cast<XVector<T>*>(nullptr), comp, pool);
+}
+
+template<typename T, typename Compare = std::less<>>
+void parallel_sort(XVector<T>& vec, XVector<T>& scratch, Compare comp = {}, ThreadPool& pool = ThreadPool::global())
+{
+    detail::parallelSort<false>(vec, &scratch, comp, pool);
+}
+
+// parallel_sort that keeps equal elements in their original order
+template<typename T, typename Compare = std::less<>,
+         typename = std::enable_if_t<std::is_invocable_r_v<bool, Compare&, const T&, const T&>>>
+void parallel_stable_sort(XVector<T>& vec, Compare comp = {}, ThreadPool& pool = ThreadPool::global())
+{
+    detail::parallelSort<true>(vec, static_cast<XVector<T>*>(nullptr), comp, pool);
+}
+
+template<typename T, typename Compare = std::less<>>
+void parallel_stable_sort(XVector<T>& vec, XVector<T>& scratch, Compare comp = {}, ThreadPool& pool = ThreadPool::global())
+{
+    detail::parallelSort<true>(vec, &scratch, comp, pool);
+}
+
+namespace detail {
+
+// a key with the index it came from, what argsort radix sorts
+template<typename U, typename Index>
+struct KeyIndex
+{
+    U key;
+    Index index;
+};
+
+template<typename Index>
+void checkIndexRange(size_t n)
+{
+    if (n > 0 && n - 1 > std::numeric_limits<Index>::max())
+        throw std::length_error("argsort index type is too narrow for this many elements.");
+}
+
+} // namespace detail
+
+// the permutation that sorts keys: keys[perm[0]], keys[perm[1]], ... is ascending, and equal keys
+// keep their order. integer and floating-point keys are radix sorted together with their indices,
+// in the order radix_sort uses; anything else goes through std::stable_sort. Index is uint32_t by
+// default, pass uint64_t for more than 2^32 elements.
+template<typename Index = uint32_t, typename T>
+XVector<Index> argsort(const XVector<T>& keys)
+{
+    static_assert(std::is_integral_v<Index> && std::is_unsigned_v<Index>, "argsort indices are unsigned integers");
+    const size_t n = keys.size();
+    detail::checkIndexRange<Index>(n);
+
+    XVector<Index> perm;
+    perm.reserve(n);
+    if constexpr (radix_sortable_v<T>)
+    {
+        using Item = detail::KeyIndex<decltype(detail::radixKey(keys[0])), Index>;
+        XVector<Item> items;
+        items.reserve(2 * n); // the second half is radixSort's buffer
+        for (size_t i = 0; i < n; ++i)
+            items.push_back({ detail::radixKey(keys[i]), static_cast<Index>(i) });
+        detail::radixSort(items.data(), items.data() + n, n, [](const Item& item) { return item.key; });
+        for (const Item& item : items) perm.push_back(item.index);
+    }
+    else
+    {
+        for (size_t i = 0; i < n; ++i) perm.push_back(static_cast<Index>(i));
+        std::stable_sort(perm.begin(), perm.end(), [&keys](Index a, Index b) { return keys[a] < keys[b]; });
+    }
+    return perm;
+}
+
+// argsort under comp, always a comparison sort
+template<typename Index = uint32_t, typename T, typename Compare>
+XVector<Index> argsort(const XVector<T>& keys, Compare comp)
+{
+    static_assert(std::is_integral_v<Index> && std::is_unsigned_v<Index>, "argsort indices are unsigned integers");
+    const size_t n = keys.size();
+    detail::checkIndexRange<Index>(n);
+
+    XVector<Index> perm;
+    perm.reserve(n);
+    for (size_t i = 0; i < n; ++i) perm.push_back(static_cast<Index>(i));
+    std::stable_sort(perm.begin(), perm.end(), [&](Index a, Index b) { return comp(keys[a], keys[b]); });
+    return perm;
+}
+
+// reorders every one of vecs in place so that vec[i] becomes the old vec[perm[i]], which applies
+// an argsort result to its key and any number of columns beside it. it follows the cycles of perm
+// once for all of them, with one bit per position marking what is already in place, so each
+// element is moved about once and no column is copied. perm must hold every index in [0, n)
+// exactly once: a repeated or out-of-range index only asserts in DEBUG builds and is undefined
+// behaviour otherwise.
+template<typename Index, typename... Ts>
+void apply_permutation(const XVector<Index>& perm, XVector<Ts>&... vecs)
+{
+    static_assert(sizeof...(Ts) > 0, "apply_permutation needs at least one XVector to reorder");
+    const size_t n = perm.size();
+    if (((vecs.size() != n) || ...)) throw std::length_error("apply_permutation sizes differ.");
+
+    XVector<uint64_t> placed((n + 63) / 64, 0);
+    auto isPlaced = [&placed](size_t i) { return (placed[i / 64] >> (i % 64)) & 1; };
+    auto place = [&placed](size_t i) { placed[i / 64] |= uint64_t(1) << (i % 64); };
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (isPlaced(i)) continue;
+        place(i);
+        if (static_cast<size_t>(perm[i]) == i) continue;
+
+        std::tuple<Ts...> held(std::move(vecs[i])...);
+        size_t j = i;
+        for (;;)
+        {
+            const size_t k = static_cast<size_t>(perm[j]);
+            XVECTOR_ASSERT(k < n, "apply_permutation index out of range");
+            if (isPlaced(k))
+            {
+                XVECTOR_ASSERT(k == i, "apply_permutation needs a permutation");
+                break;
+            }
+            ((vecs[j] = std::move(vecs[k])), ...);
+            place(k);
+            j = k;
+        }
+        std::tie(vecs[j]...) = std::move(held);
+    }
+}
+
+} // namespace xvc
+
+#endif // X_SORT_H
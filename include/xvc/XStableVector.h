@@ -0,0 +1,713 @@
+#ifndef X_STABLE_VECTOR_H
+#define X_STABLE_VECTOR_H
+
+#include "XVector.h"
+
+#include <stddef.h>    // size_t
+#include <initializer_list> // std::initializer_list
+#include <stdexcept>   // std::out_of_range
+#include <utility>     // std::forward, std::move, std::swap
+#include <type_traits> // std::is_trivially_copyable_v, std::is_trivially_destructible_v, std::conditional_t
+#include <new>         // ::operator new, ::operator delete
+#include <iterator>    // std::random_access_iterator_tag, std::reverse_iterator
+#include <cstring>     // std::memcpy
+#include <algorithm>   // std::min
+#include <limits>      // std::numeric_limits
+
+namespace xvc {
+
+// XStableVector stores its elements in a directory of geometrically growing segments.
+// segment k holds (firstSegmentSize << k) elements, so growing only ever allocates a new
+// segment and never moves existing elements: pointers, references and iterators stay valid
+// until the element they refer to is removed.
+template<typename T>
+class XStableVector
+{
+private:
+    static constexpr size_t firstSegmentLog2 = 4;
+    static constexpr size_t firstSegmentSize = size_t(1) << firstSegmentLog2;
+    static constexpr size_t maxSegments = sizeof(size_t) * 8 - firstSegmentLog2;
+
+    // member variables
+    size_t size_;
+    size_t segmentCount_; // number of allocated segments
+    T* segments_[maxSegments]; // fixed directory, never reallocated
+
+    // private methods
+    static size_t log2Floor(size_t);
+    static size_t segmentOf(size_t) noexcept;
+    static size_t offsetOf(size_t, size_t) noexcept;
+    static size_t segmentSize(size_t) noexcept;
+    static size_t capacityFor(size_t) noexcept;
+    T* slot(size_t) const noexcept;
+    void addSegment();
+    void destroyRange(size_t, size_t) noexcept;
+    void releaseSegments(size_t) noexcept;
+
+    template<bool Const>
+    class Iterator
+    {
+    private:
+        using owner_type = std::conditional_t<Const, const XStableVector<T>, XStableVector<T>>;
+
+        owner_type* owner_;
+        size_t idx_;
+        T* ptr_;        // cached pointer to the current element, null at or past capacity
+        T* segEnd_;     // cached end of the current segment
+
+        void seek() noexcept
+        {
+            if (idx_ < owner_->capacity())
+            {
+                const size_t seg = segmentOf(idx_);
+                T* base = owner_->segments_[seg];
+                ptr_ = base + offsetOf(idx_, seg);
+                segEnd_ = base + segmentSize(seg);
+            }
+            else
+            {
+                ptr_ = segEnd_ = nullptr;
+            }
+        }
+
+        friend class XStableVector<T>;
+        friend class Iterator<!Const>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        Iterator() noexcept : owner_(nullptr), idx_(0), ptr_(nullptr), segEnd_(nullptr) {}
+        Iterator(owner_type* owner, size_t idx) noexcept : owner_(owner), idx_(idx) { seek(); }
+
+        template<bool C = Const, typename = std::enable_if_t<C>>
+        Iterator(const Iterator<false>& other) noexcept
+            : owner_(other.owner_), idx_(other.idx_), ptr_(other.ptr_), segEnd_(other.segEnd_) {}
+
+        // an iterator made at capacity() has no segment yet, so it looks its element up again
+        // in case the vector has grown since
+        reference operator*() const noexcept { return ptr_ ? *ptr_ : (*owner_)[idx_]; }
+        pointer operator->() const noexcept { return ptr_ ? ptr_ : &(*owner_)[idx_]; }
+        reference operator[](difference_type n) const noexcept { return (*owner_)[idx_ + n]; }
+
+        Iterator& operator++() noexcept
+        {
+            ++idx_;
+            if (!ptr_ || ++ptr_ == segEnd_) seek(); // only recompute at segment boundaries
+            return *this;
+        }
+        Iterator operator++(int) noexcept { Iterator tmp = *this; ++*this; return tmp; }
+
+        Iterator& operator--() noexcept { --idx_; seek(); return *this; }
+        Iterator operator--(int) noexcept { Iterator tmp = *this; --*this; return tmp; }
+
+        Iterator& operator+=(difference_type n) noexcept { idx_ += n; seek(); return *this; }
+        Iterator& operator-=(difference_type n) noexcept { idx_ -= n; seek(); return *this; }
+        friend Iterator operator+(Iterator it, difference_type n) noexcept { return it += n; }
+        friend Iterator operator+(difference_type n, Iterator it) noexcept { return it += n; }
+        friend Iterator operator-(Iterator it, difference_type n) noexcept { return it -= n; }
+        friend difference_type operator-(const Iterator& a, const Iterator& b) noexcept
+        {
+            return static_cast<difference_type>(a.idx_) - static_cast<difference_type>(b.idx_);
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) noexcept { return a.idx_ == b.idx_; }
+        friend bool operator!=(const Iterator& a, const Iterator& b) noexcept { return a.idx_ != b.idx_; }
+        friend bool operator<(const Iterator& a, const Iterator& b) noexcept { return a.idx_ < b.idx_; }
+        friend bool operator>(const Iterator& a, const Iterator& b) noexcept { return a.idx_ > b.idx_; }
+        friend bool operator<=(const Iterator& a, const Iterator& b) noexcept { return a.idx_ <= b.idx_; }
+        friend bool operator>=(const Iterator& a, const Iterator& b) noexcept { return a.idx_ >= b.idx_; }
+    };
+
+public:
+    // type aliases for STL compatibility
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // constructors and destructor
+    XStableVector() noexcept;
+    explicit XStableVector(size_t, const T& = T{});
+    XStableVector(const XStableVector<T>&);
+    XStableVector(XStableVector<T>&&) noexcept;
+    XStableVector(std::initializer_list<T> init);
+    template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    XStableVector(InputIt first, InputIt last);
+    ~XStableVector();
+
+    // assignment operator
+    XStableVector<T>& operator=(const XStableVector<T>&);
+    XStableVector<T>& operator=(XStableVector<T>&&) noexcept;
+
+    // element access
+    T& operator[](size_t) noexcept;
+    const T& operator[](size_t) const noexcept;
+    [[nodiscard]] T& at(size_t n);
+    [[nodiscard]] const T& at(size_t n) const;
+    T& front() noexcept;
+    const T& front() const noexcept;
+    T& back() noexcept;
+    const T& back() const noexcept;
+
+    // iterators
+    iterator begin() noexcept;
+    const_iterator begin() const noexcept;
+    iterator end() noexcept;
+    const_iterator end() const noexcept;
+    reverse_iterator rbegin() noexcept;
+    const_reverse_iterator rbegin() const noexcept;
+    reverse_iterator rend() noexcept;
+    const_reverse_iterator rend() const noexcept;
+
+    // segment-wise traversal, f(T* first, size_t count) is called once per contiguous run
+    template<typename F>
+    void for_each_segment(F&& f);
+    template<typename F>
+    void for_each_segment(F&& f) const;
+
+    // capacity
+    [[nodiscard]] size_t size() const noexcept;
+    [[nodiscard]] size_t max_size() const noexcept;
+    [[nodiscard]] size_t capacity() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+
+    // modifiers
+    void append(const T&);
+    void append(T&&);
+    void push_back(const T&);
+    void push_back(T&&);
+    void pop_back();
+    void concatenate(const XStableVector<T>&);
+    void concatenate(const XVector<T>&);
+    void clear() noexcept;
+    void swap(XStableVector<T>& other) noexcept;
+    void reserve(size_t);
+    void resize(size_t, const T& = T{});
+    void shrink_to_fit();
+    template<typename... Args>
+    T& emplace_back(Args&&...);
+
+    friend bool operator==(const XStableVector<T>& left, const XStableVector<T>& right) {
+        if (left.size_ != right.size_) return false;
+
+        // segment layout only depends on the index, so both sides share boundaries
+        for (size_t seg = 0, done = 0; done < left.size_; ++seg)
+        {
+            const size_t n = std::min(segmentSize(seg), left.size_ - done);
+            if constexpr (std::has_unique_object_representations_v<T>)
+            {
+                if (std::memcmp(left.segments_[seg], right.segments_[seg], n * sizeof(T)) != 0) return false;
+            }
+            else
+            {
+                for (size_t i = 0; i < n; ++i)
+                {
+                    if (!(left.segments_[seg][i] == right.segments_[seg][i])) return false;
+                }
+            }
+            done += n;
+        }
+        return true;
+    }
+
+    friend bool operator!=(const XStableVector<T>& left, const XStableVector<T>& right) {
+        return !(left == right);
+    }
+};
+
+template<typename T>
+size_t XStableVector<T>::log2Floor(size_t n)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    if constexpr (sizeof(size_t) > 4)
+        return 63 - static_cast<size_t>(__builtin_clzll(static_cast<unsigned long long>(n)));
+    else
+        return 31 - static_cast<size_t>(__builtin_clz(static_cast<unsigned int>(n)));
+#else
+    // same bit smearing as XVector::nextPowerOf2, then count the set bits
+    n |= n >> 1;
+    n |= n >> 2;
+    n |= n >> 4;
+    n |= n >> 8;
+    n |= n >> 16;
+    if constexpr (sizeof(size_t) > 4) n |= n >> 32;
+    size_t bits = 0;
+    while (n >>= 1) ++bits;
+    return bits;
+#endif
+}
+
+template<typename T>
+size_t XStableVector<T>::segmentOf(size_t idx) noexcept
+{
+    return log2Floor(idx + firstSegmentSize) - firstSegmentLog2;
+}
+
+template<typename T>
+size_t XStableVector<T>::offsetOf(size_t idx, size_t seg) noexcept
+{
+    return (idx + firstSegmentSize) ^ (firstSegmentSize << seg); // clear the leading bit
+}
+
+template<typename T>
+size_t XStableVector<T>::segmentSize(size_t seg) noexcept
+{
+    return firstSegmentSize << seg;
+}
+
+template<typename T>
+size_t XStableVector<T>::capacityFor(size_t segments) noexcept
+{
+    return segments ? (firstSegmentSize << segments) - firstSegmentSize : 0;
+}
+
+template<typename T>
+T* XStableVector<T>::slot(size_t idx) const noexcept
+{
+    const size_t seg = segmentOf(idx);
+    return segments_[seg] + offsetOf(idx, seg);
+}
+
+template<typename T>
+void XStableVector<T>::addSegment()
+{
+    if (segmentCount_ >= maxSegments) throw std::length_error("XStableVector exceeded max_size.");
+    segments_[segmentCount_] = static_cast<T*>(::operator new(segmentSize(segmentCount_) * sizeof(T)));
+    ++segmentCount_;
+}
+
+template<typename T>
+void XStableVector<T>::destroyRange(size_t first, size_t last) noexcept
+{
+    if constexpr (!std::is_trivially_destructible_v<T>)
+    {
+        for (size_t i = first; i < last; ++i)
+            slot(i)->~T();
+    }
+}
+
+template<typename T>
+void XStableVector<T>::releaseSegments(size_t keep) noexcept
+{
+    while (segmentCount_ > keep)
+        ::operator delete(segments_[--segmentCount_]);
+}
+
+template<typename T>
+XStableVector<T>::XStableVector() noexcept
+    : size_(0), segmentCount_(0) {}
+
+template<typename T>
+XStableVector<T>::XStableVector(size_t count, const T& value)
+    : XStableVector()
+{
+    resize(count, value);
+}
+
+template<typename T>
+XStableVector<T>::XStableVector(const XStableVector<T>& other)
+    : XStableVector()
+{
+    concatenate(other);
+}
+
+template<typename T>
+XStableVector<T>::XStableVector(XStableVector<T>&& other) noexcept
+    : size_(std::exchange(other.size_, 0)), segmentCount_(std::exchange(other.segmentCount_, 0))
+{
+    for (size_t seg = 0; seg < segmentCount_; ++seg)
+        segments_[seg] = other.segments_[seg];
+}
+
+template<typename T>
+XStableVector<T>::XStableVector(std::initializer_list<T> init)
+    : XStableVector(init.begin(), init.end()) {}
+
+template<typename T>
+template<typename InputIt, typename>
+XStableVector<T>::XStableVector(InputIt first, InputIt last)
+    : XStableVector()
+{
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
+
+    try
+    {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>)
+            reserve(static_cast<size_t>(std::distance(first, last)));
+
+        for (; first != last; ++first)
+            emplace_back(*first);
+    }
+    catch (...)
+    {
+        clear();
+        releaseSegments(0);
+        throw;
+    }
+}
+
+template<typename T>
+XStableVector<T>::~XStableVector()
+{
+    clear();
+    releaseSegments(0);
+}
+
+template<typename T>
+XStableVector<T>& XStableVector<T>::operator=(const XStableVector<T>& other)
+{
+    if (this != &other)
+    {
+        XStableVector<T> tmp(other); // strong guarantee, elements are not relocated anyway
+        swap(tmp);
+    }
+    return *this;
+}
+
+template<typename T>
+XStableVector<T>& XStableVector<T>::operator=(XStableVector<T>&& other) noexcept
+{
+    if (this != &other)
+    {
+        clear();
+        releaseSegments(0);
+        swap(other);
+    }
+    return *this;
+}
+
+template<typename T>
+T& XStableVector<T>::operator[](size_t idx) noexcept {
+    XVECTOR_BOUNDS_CHECK(idx);
+    const size_t seg = segmentOf(idx);
+    return segments_[seg][offsetOf(idx, seg)];
+}
+
+template<typename T>
+const T& XStableVector<T>::operator[](size_t idx) const noexcept {
+    XVECTOR_BOUNDS_CHECK(idx);
+    const size_t seg = segmentOf(idx);
+    return segments_[seg][offsetOf(idx, seg)];
+}
+
+template<typename T>
+T& XStableVector<T>::at(size_t idx)
+{
+    if (idx >= size_) throw std::out_of_range("XStableVector index out of bounds.");
+
+    return (*this)[idx];
+}
+
+template<typename T>
+const T& XStableVector<T>::at(size_t idx) const
+{
+    if (idx >= size_) throw std::out_of_range("XStableVector index out of bounds.");
+
+    return (*this)[idx];
+}
+
+template<typename T>
+T& XStableVector<T>::front() noexcept {
+    XVECTOR_EMPTY_CHECK();
+    return segments_[0][0];
+}
+
+template<typename T>
+const T& XStableVector<T>::front() const noexcept {
+    XVECTOR_EMPTY_CHECK();
+    return segments_[0][0];
+}
+
+template<typename T>
+T& XStableVector<T>::back() noexcept {
+    XVECTOR_EMPTY_CHECK();
+    return (*this)[size_ - 1];
+}
+
+template<typename T>
+const T& XStableVector<T>::back() const noexcept {
+    XVECTOR_EMPTY_CHECK();
+    return (*this)[size_ - 1];
+}
+
+template<typename T>
+typename XStableVector<T>::iterator XStableVector<T>::begin() noexcept { return iterator(this, 0); }
+
+template<typename T>
+typename XStableVector<T>::const_iterator XStableVector<T>::begin() const noexcept { return const_iterator(this, 0); }
+
+template<typename T>
+typename XStableVector<T>::iterator XStableVector<T>::end() noexcept { return iterator(this, size_); }
+
+template<typename T>
+typename XStableVector<T>::const_iterator XStableVector<T>::end() const noexcept { return const_iterator(this, size_); }
+
+template<typename T>
+typename XStableVector<T>::reverse_iterator XStableVector<T>::rbegin() noexcept { return reverse_iterator(end()); }
+
+template<typename T>
+typename XStableVector<T>::const_reverse_iterator XStableVector<T>::rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+template<typename T>
+typename XStableVector<T>::reverse_iterator XStableVector<T>::rend() noexcept { return reverse_iterator(begin()); }
+
+template<typename T>
+typename XStableVector<T>::const_reverse_iterator XStableVector<T>::rend() const noexcept { return const_reverse_iterator(begin()); }
+
+template<typename T>
+template<typename F>
+void XStableVector<T>::for_each_segment(F&& f)
+{
+    for (size_t seg = 0, done = 0; done < size_; ++seg)
+    {
+        const size_t n = std::min(segmentSize(seg), size_ - done);
+        f(segments_[seg], n);
+        done += n;
+    }
+}
+
+template<typename T>
+template<typename F>
+void XStableVector<T>::for_each_segment(F&& f) const
+{
+    for (size_t seg = 0, done = 0; done < size_; ++seg)
+    {
+        const size_t n = std::min(segmentSize(seg), size_ - done);
+        f(static_cast<const T*>(segments_[seg]), n);
+        done += n;
+    }
+}
+
+template<typename T>
+size_t XStableVector<T>::size() const noexcept { return size_; }
+
+template<typename T>
+size_t XStableVector<T>::max_size() const noexcept { return std::numeric_limits<size_t>::max() / sizeof(T); }
+
+template<typename T>
+size_t XStableVector<T>::capacity() const noexcept { return capacityFor(segmentCount_); }
+
+template<typename T>
+bool XStableVector<T>::empty() const noexcept
+{
+    return (size_ == 0);
+}
+
+template<typename T>
+void XStableVector<T>::append(const T& item) { emplace_back(item); }
+
+template<typename T>
+void XStableVector<T>::append(T&& item) { emplace_back(std::move(item)); }
+
+template<typename T>
+void XStableVector<T>::push_back(const T& item) { emplace_back(item); }
+
+template<typename T>
+void XStableVector<T>::push_back(T&& item) { emplace_back(std::move(item)); }
+
+template<typename T>
+void XStableVector<T>::pop_back()
+{
+    XVECTOR_EMPTY_CHECK();
+    if constexpr (!std::is_trivially_destructible_v<T>)
+    {
+        slot(size_ - 1)->~T(); // no check for performance
+    }
+    --size_;
+}
+
+template<typename T>
+void XStableVector<T>::concatenate(const XStableVector<T>& other)
+{
+    if (other.empty()) return;
+
+    // reading other segment by segment keeps the source side sequential. its size is taken up
+    // front, other may be *this and grow while it is read, but its elements never move.
+    const size_t oldSize = size_;
+    const size_t count = other.size_;
+    reserve(size_ + count);
+    try
+    {
+        for (size_t seg = 0, done = 0; done < count; ++seg)
+        {
+            const T* src = other.segments_[seg];
+            size_t n = std::min(segmentSize(seg), count - done);
+            done += n;
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                // copy in runs bounded by both the source and destination segments
+                while (n > 0)
+                {
+                    const size_t to = segmentOf(size_);
+                    const size_t off = offsetOf(size_, to);
+                    const size_t chunk = std::min(n, segmentSize(to) - off);
+                    std::memcpy(segments_[to] + off, src, chunk * sizeof(T));
+                    src += chunk;
+                    n -= chunk;
+                    size_ += chunk;
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < n; ++i)
+                {
+                    new (slot(size_)) T(src[i]);
+                    ++size_;
+                }
+            }
+        }
+    }
+    catch (...)
+    {
+        destroyRange(oldSize, size_);
+        size_ = oldSize;
+        throw;
+    }
+}
+
+template<typename T>
+void XStableVector<T>::concatenate(const XVector<T>& other)
+{
+    if (other.empty()) return;
+
+    const size_t oldSize = size_;
+    reserve(size_ + other.size());
+    const T* src = other.data();
+    size_t n = other.size();
+    try
+    {
+        while (n > 0)
+        {
+            const size_t seg = segmentOf(size_);
+            const size_t off = offsetOf(size_, seg);
+            const size_t chunk = std::min(n, segmentSize(seg) - off);
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                std::memcpy(segments_[seg] + off, src, chunk * sizeof(T));
+                size_ += chunk;
+            }
+            else
+            {
+                for (size_t i = 0; i < chunk; ++i)
+                {
+                    new (&segments_[seg][off + i]) T(src[i]);
+                    ++size_;
+                }
+            }
+            src += chunk;
+            n -= chunk;
+        }
+    }
+    catch (...)
+    {
+        destroyRange(oldSize, size_);
+        size_ = oldSize;
+        throw;
+    }
+}
+
+template<typename T>
+void XStableVector<T>::clear() noexcept
+{
+    if constexpr (!std::is_trivially_destructible_v<T>)
+    {
+        for_each_segment([](T* first, size_t n) {
+            for (size_t i = 0; i < n; ++i)
+                first[i].~T();
+        });
+    }
+    size_ = 0;
+}
+
+template<typename T>
+void XStableVector<T>::swap(XStableVector<T>& other) noexcept {
+    std::swap(size_, other.size_);
+    std::swap(segmentCount_, other.segmentCount_);
+    std::swap(segments_, other.segments_);
+}
+
+template<typename T>
+void XStableVector<T>::reserve(size_t space)
+{
+    while (capacityFor(segmentCount_) < space)
+        addSegment();
+}
+
+template<typename T>
+void XStableVector<T>::resize(size_t newSize, const T& value)
+{
+    if (newSize > size_)
+    {
+        reserve(newSize);
+        const size_t oldSize = size_;
+        try
+        {
+            while (size_ < newSize)
+            {
+                const size_t seg = segmentOf(size_);
+                const size_t off = offsetOf(size_, seg);
+                const size_t chunk = std::min(newSize - size_, segmentSize(seg) - off);
+                T* dest = segments_[seg] + off;
+                if constexpr (std::is_trivially_copyable_v<T>)
+                {
+                    simd::fillTrivial(dest, chunk, value);
+                    size_ += chunk;
+                }
+                else
+                {
+                    for (size_t i = 0; i < chunk; ++i)
+                    {
+                        new (&dest[i]) T(value);
+                        ++size_;
+                    }
+                }
+            }
+        }
+        catch (...)
+        {
+            destroyRange(oldSize, size_);
+            size_ = oldSize;
+            throw;
+        }
+    }
+    else if (newSize < size_)
+    {
+        destroyRange(newSize, size_);
+        size_ = newSize;
+    }
+}
+
+template<typename T>
+void XStableVector<T>::shrink_to_fit()
+{
+    // only whole trailing segments can be released without moving anything
+    size_t keep = 0;
+    while (capacityFor(keep) < size_) ++keep;
+    releaseSegments(keep);
+}
+
+template<typename T>
+template<typename... Args>
+T& XStableVector<T>::emplace_back(Args&&... args)
+{
+    if (size_ >= capacityFor(segmentCount_)) addSegment();
+    T* p = slot(size_);
+    new (p) T(std::forward<Args>(args)...);
+    ++size_;
+    return *p;
+}
+
+} // namespace xvc
+
+#endif // X_STABLE_VECTOR_H
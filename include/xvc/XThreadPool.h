@@ -0,0 +1,375 @@
+#ifndef X_THREAD_POOL_H
+#define X_THREAD_POOL_H
+
+#include <stddef.h>    // size_t
+#include <atomic>      // std::atomic
+#include <condition_variable> // std::condition_variable
+#include <deque>       // std::deque
+#include <exception>   // std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <functional>  // std::function
+#include <memory>      // std::shared_ptr, std::make_shared, std::unique_ptr
+#include <mutex>       // std::mutex, std::lock_guard, std::unique_lock
+#include <thread>      // std::thread
+#include <type_traits> // std::true_type, std::false_type, std::decay_t
+#include <utility>     // std::move
+#include <vector>      // std::vector
+#include <algorithm>   // std::min, std::max
+
+namespace xvc {
+
+// bulk copies and fills of at least this many bytes are split across the internal thread pool.
+// parallel execution is opt-in, 0 keeps everything on the calling thread.
+inline size_t parallel_threshold = 0;
+
+// destroying at least this many non-trivially destructible elements (clear, shrinking resize and
+// the destructor) is split across the pool as well. counted in elements rather than bytes, since
+// the cost is in what each destructor frees. 0 keeps destruction serial.
+inline size_t parallel_destroy_threshold = 0;
+
+namespace detail {
+
+// how a bulk operation decides between the calling thread and the pool
+enum class Exec : unsigned char { automatic, sequential, parallel };
+
+} // namespace detail
+
+// execution policies for the bulk operation overloads, mirroring std::execution. they override
+// parallel_threshold for a single call: seq always stays on the calling thread, par and par_unseq
+// always use the pool. the bulk kernels are vectorized either way, so par_unseq behaves like par.
+namespace execution {
+
+struct sequenced_policy { static constexpr detail::Exec mode = detail::Exec::sequential; };
+struct parallel_policy { static constexpr detail::Exec mode = detail::Exec::parallel; };
+struct parallel_unsequenced_policy { static constexpr detail::Exec mode = detail::Exec::parallel; };
+
+} // namespace execution
+
+inline constexpr execution::sequenced_policy seq{};
+inline constexpr execution::parallel_policy par{};
+inline constexpr execution::parallel_unsequenced_policy par_unseq{};
+
+template<typename P> struct is_execution_policy : std::false_type {};
+template<> struct is_execution_policy<execution::sequenced_policy> : std::true_type {};
+template<> struct is_execution_policy<execution::parallel_policy> : std::true_type {};
+template<> struct is_execution_policy<execution::parallel_unsequenced_policy> : std::true_type {};
+
+template<typename P>
+inline constexpr bool is_execution_policy_v = is_execution_policy<std::decay_t<P>>::value;
+
+// work-stealing thread pool. every worker owns a deque: it pops its own jobs from the back and
+// steals from the front of the others when it runs dry. jobs submitted from a worker go to its
+// own deque, others are dealt round-robin. the thread that calls run() always takes part in its
+// own job, so a job submitted from inside a worker cannot deadlock the pool, and concurrency()
+// counts the caller on top of the workers. global() is the pool behind the parallel bulk
+// operations, sized to the hardware; construct a separate one to keep a job off it.
+class ThreadPool
+{
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> jobs;
+    };
+
+    // member variables
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> pending_;   // jobs sitting in any of the queues
+    std::atomic<size_t> nextQueue_;
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    bool stop_;
+
+    static inline thread_local const ThreadPool* currentPool_ = nullptr;
+    static inline thread_local size_t currentIndex_ = 0;
+
+    // private methods
+    void workerLoop(size_t index);
+    bool popLocal(size_t index, std::function<void()>& job);
+    bool steal(size_t thief, std::function<void()>& job);
+    void submit(std::function<void()>);
+    template<typename Task>
+    static void runInline(size_t tasks, Task& task);
+
+public:
+    explicit ThreadPool(size_t workers);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    [[nodiscard]] size_t concurrency() const noexcept;
+
+    // calls task(i) for every i in [0, tasks) and returns once all of them finished. when tasks
+    // throw, the remaining ones still run and the first exception is rethrown at the end,
+    // so run() only throws what the tasks throw.
+    template<typename Task>
+    void run(size_t tasks, Task&& task);
+
+    static ThreadPool& global();
+};
+
+inline ThreadPool::ThreadPool(size_t workers)
+    : pending_(0), nextQueue_(0), stop_(false)
+{
+    // a thread that cannot be started just leaves the pool smaller, the caller always takes part
+    try
+    {
+        queues_.reserve(workers);
+        for (size_t i = 0; i < workers; ++i)
+            queues_.push_back(std::make_unique<Queue>());
+        workers_.reserve(workers);
+        for (size_t i = 0; i < workers; ++i)
+            workers_.emplace_back([this, i] { workerLoop(i); });
+    }
+    catch (...) {}
+}
+
+inline ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) worker.join();
+}
+
+inline bool ThreadPool::popLocal(size_t index, std::function<void()>& job)
+{
+    Queue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    pending_.fetch_sub(1);
+    return true;
+}
+
+inline bool ThreadPool::steal(size_t thief, std::function<void()>& job)
+{
+    for (size_t k = 1; k < queues_.size(); ++k)
+    {
+        Queue& victim = *queues_[(thief + k) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.jobs.empty()) continue;
+        job = std::move(victim.jobs.front());
+        victim.jobs.pop_front();
+        pending_.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+inline void ThreadPool::workerLoop(size_t index)
+{
+    currentPool_ = this;
+    currentIndex_ = index;
+
+    for (;;)
+    {
+        std::function<void()> job;
+        if (popLocal(index, job) || steal(index, job))
+        {
+            job();
+            continue;
+        }
+
+        // pending_ grows before the wake-up is sent under sleepMutex_, so checking it under
+        // the same lock cannot miss a job
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this] { return stop_ || pending_.load() != 0; });
+        if (stop_ && pending_.load() == 0) return;
+    }
+}
+
+inline void ThreadPool::submit(std::function<void()> job)
+{
+    const size_t index = currentPool_ == this ? currentIndex_ : nextQueue_.fetch_add(1) % queues_.size();
+    {
+        Queue& queue = *queues_[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+        pending_.fetch_add(1);
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    wake_.notify_one();
+}
+
+inline size_t ThreadPool::concurrency() const noexcept
+{
+    return workers_.size() + 1;
+}
+
+template<typename Task>
+void ThreadPool::runInline(size_t tasks, Task& task)
+{
+    std::exception_ptr error;
+    for (size_t i = 0; i < tasks; ++i)
+    {
+        try { task(i); }
+        catch (...) { if (!error) error = std::current_exception(); }
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+template<typename Task>
+void ThreadPool::run(size_t tasks, Task&& task)
+{
+    if (tasks == 0) return;
+    if (tasks == 1 || workers_.empty()) return runInline(tasks, task);
+
+    // helpers may start after the job is over, so everything they touch is shared
+    struct State
+    {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        size_t tasks = 0;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    std::shared_ptr<State> state;
+    try
+    {
+        state = std::make_shared<State>();
+    }
+    catch (...)
+    {
+        return runInline(tasks, task);
+    }
+    state->tasks = tasks;
+    auto* body = &task;
+
+    // tasks are claimed one at a time, so a slow or late helper never holds up the others
+    auto drain = [state, body] {
+        size_t i;
+        while ((i = state->next.fetch_add(1)) < state->tasks)
+        {
+            try
+            {
+                (*body)(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->error) state->error = std::current_exception();
+            }
+            if (state->done.fetch_add(1) + 1 == state->tasks)
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->finished.notify_all();
+            }
+        }
+    };
+
+    // a helper that cannot be queued is not needed for correctness, drain() takes its share
+    const size_t helpers = std::min(tasks, concurrency()) - 1;
+    try
+    {
+        for (size_t h = 0; h < helpers; ++h)
+            submit(drain);
+    }
+    catch (...) {}
+    drain();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&] { return state->done.load() == state->tasks; });
+    if (state->error) std::rethrow_exception(state->error);
+}
+
+inline ThreadPool& ThreadPool::global()
+{
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+namespace detail {
+
+inline constexpr size_t cacheLineSize = 64;
+
+// [0, count) cut into tasks of grain elements. when lead is set the first task also takes the
+// lead elements in front of the first cache line boundary, so every later task starts on one.
+struct Partition
+{
+    size_t count;
+    size_t lead;
+    size_t grain;
+    size_t tasks;
+
+    Partition(size_t count_, size_t grain_, size_t lead_ = 0) noexcept
+        : count(count_), lead(std::min(lead_, count_)), grain(std::max<size_t>(grain_, 1)),
+          tasks(count_ > lead ? (count_ - lead + grain - 1) / grain : 1) {}
+
+    [[nodiscard]] size_t first(size_t task) const noexcept {
+        return task == 0 ? 0 : std::min(count, lead + task * grain);
+    }
+    [[nodiscard]] size_t last(size_t task) const noexcept {
+        return std::min(count, lead + (task + 1) * grain);
+    }
+};
+
+// a partition of count elements of T at base whose task boundaries fall on cache lines, so no two
+// tasks write the same line. grain 0 gives every thread of the pool a few tasks to balance with.
+template<typename T>
+Partition alignedPartition(const T* base, size_t count, size_t grain, size_t concurrency) noexcept
+{
+    if (grain == 0) grain = std::max<size_t>(1, count / (4 * concurrency));
+
+    if constexpr (cacheLineSize % sizeof(T) == 0)
+    {
+        constexpr size_t perLine = cacheLineSize / sizeof(T);
+        const size_t offset = reinterpret_cast<size_t>(base) % cacheLineSize;
+        const size_t lead = offset % sizeof(T) == 0 ? ((cacheLineSize - offset) % cacheLineSize) / sizeof(T) : 0;
+        return Partition(count, (grain + perLine - 1) / perLine * perLine, lead);
+    }
+    else
+    {
+        return Partition(count, grain);
+    }
+}
+
+// no chunk is made smaller than this, below it handing the work over costs more than it saves
+inline constexpr size_t parallelMinChunkBytes = size_t(1) << 16;
+
+template<typename T>
+constexpr size_t parallelMinChunk() noexcept
+{
+    return std::max<size_t>(1, parallelMinChunkBytes / sizeof(T));
+}
+
+// whether a bulk operation over count elements of T runs on the pool
+template<typename T>
+bool runsParallel(size_t count, Exec mode) noexcept
+{
+    switch (mode)
+    {
+        case Exec::sequential: return false;
+        case Exec::parallel:   return count >= 2 * parallelMinChunk<T>();
+        default:               return parallel_threshold != 0 && count * sizeof(T) >= parallel_threshold;
+    }
+}
+
+// splits [0, count) into about one chunk per thread, each at least minChunk long,
+// and calls chunk(first, last) for each of them on the global pool
+template<typename Chunk>
+void parallelChunks(size_t count, size_t minChunk, Chunk&& chunk)
+{
+    ThreadPool& pool = ThreadPool::global();
+    const size_t maxChunks = std::max<size_t>(1, count / std::max<size_t>(minChunk, 1));
+    const size_t chunks = std::min(pool.concurrency(), maxChunks);
+    const size_t step = (count + chunks - 1) / chunks;
+
+    pool.run(chunks, [&](size_t i) {
+        const size_t first = i * step;
+        const size_t last = std::min(count, first + step);
+        if (first < last) chunk(first, last);
+    });
+}
+
+} // namespace detail
+
+} // namespace xvc
+
+#endif // X_THREAD_POOL_H
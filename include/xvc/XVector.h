@@ -29,12 +29,84 @@
 #include <utility>     // std::exchange, std::forward, std::swap
 #include <type_traits> // std::is_nothrow_move_constructible_v, std::is_nothrow_copy_constructible_v, std::is_trivially_destructible_v
 #include <new>         // ::operator new, ::operator delete
-#include <iterator>    // std::reverse_iterator
+#include <iterator>    // std::reverse_iterator, std::data, std::size
 #include <cstring>     // std::memcpy, std::memmove, std::memcmp
-#include <algorithm>   // std::min
+#include <algorithm>   // std::min, std::max, std::move, std::rotate, std::lexicographical_compare
+#include <limits>      // std::numeric_limits
+#include <atomic>      // std::atomic
+
+#include "XSimd.h"
+#include "XThreadPool.h"
+#if __cplusplus >= 202002L
+    #include <span>    // std::span
+    #include <memory>  // std::to_address
+    #include <compare> // std::three_way_comparable, std::compare_three_way_result_t
+#endif
 
 namespace xvc {
 
+namespace detail {
+
+// shared by the containers in this library so they all grow the same way
+inline size_t nextPowerOf2(size_t n)
+{
+    if (n <= 1) return 1;
+    --n;
+    n |= n >> 1;
+    n |= n >> 2;
+    n |= n >> 4;
+    n |= n >> 8;
+    n |= n >> 16;
+    if constexpr (sizeof(size_t) > 4) n |= n >> 32; // compile-time check to avoid undefined behavior on 32-bit systems
+    return n+1;
+}
+
+// raw pointers are always contiguous, C++20 can also recognise contiguous class iterators
+template<typename It>
+inline constexpr bool is_contiguous_iterator_v =
+#if __cplusplus >= 202002L
+    std::contiguous_iterator<It>;
+#else
+    std::is_pointer_v<It>;
+#endif
+
+template<typename It>
+auto toAddress(It it) noexcept
+{
+#if __cplusplus >= 202002L
+    return std::to_address(it);
+#else
+    return it;
+#endif
+}
+
+// detects containers of T exposing data() and size(), which can be appended with one memcpy
+template<typename R, typename T, typename = void>
+struct is_contiguous_range_of : std::false_type {};
+
+template<typename R, typename T>
+struct is_contiguous_range_of<R, T, std::void_t<decltype(std::data(std::declval<R&>())), decltype(std::size(std::declval<R&>()))>>
+    : std::is_same<std::remove_cv_t<std::remove_pointer_t<decltype(std::data(std::declval<R&>()))>>, T> {};
+
+// selects the private constructor that only allocates, for results built in place
+struct WithCapacity {};
+
+} // namespace detail
+
+// whether trivially copyable copies of a vector bypass the cache with non-temporal stores
+enum class StreamMode : unsigned char
+{
+    automatic,  // stream copies of at least stream_copy_threshold bytes
+    always,
+    never
+};
+
+template<typename T, size_t N>
+class ConcatExpr;
+
+template<typename T>
+class BatchInserter;
+
 template<typename T>
 class XVector
 {
@@ -43,11 +115,47 @@ private:
     size_t size_;
     size_t capacity_;
     T* data_;
+    StreamMode streamMode_;
 
     // private methods
     static size_t nextPowerOf2(size_t);
-    static void fillTrivial(T* dest, size_t count, const T& value);
+    void copyTrivial(T* dest, const T* src, size_t count, detail::Exec = detail::Exec::automatic) const noexcept;
+    static void uninitFill(T* dest, size_t count, const T& value, detail::Exec = detail::Exec::automatic);
+    template<typename It>
+    static void uninitCopy(T* dest, It first, size_t count, detail::Exec = detail::Exec::automatic);
+    static void destroy(T* first, size_t count) noexcept;
+    template<typename Build>
+    static void buildParallel(T* dest, size_t count, Build&& build);
     void reallocate(bool = false);
+    template<typename Fill>
+    T* insertGap(size_t idx, size_t count, Fill&& fill);
+    static XVector<T> joinParts(XVector<T>* const* parts, size_t count);
+
+    // an empty vector with room for at least capacity elements, allocated once
+    XVector(detail::WithCapacity, size_t capacity);
+
+    // bulk operations with an explicit execution mode, behind the public overloads
+    XVector(detail::Exec, size_t, const T&);
+    XVector(detail::Exec, const XVector<T>&);
+    template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    XVector(detail::Exec, InputIt first, InputIt last);
+    void concatenate(detail::Exec, const XVector<T>&);
+    void resize(detail::Exec, size_t, const T&);
+    void assign(detail::Exec, size_t, const T&);
+
+    template<typename U, size_t N>
+    friend class ConcatExpr;
+    friend class BatchInserter<T>;
+    template<typename In, typename Out, typename F>
+    friend void transform_into(const XVector<In>&, XVector<Out>&, F, size_t, ThreadPool&);
+    template<typename U, typename... Rest>
+    friend XVector<U> join(XVector<U>&&, Rest&&...);
+    template<typename U>
+    friend XVector<U> join(XVector<XVector<U>>&&);
+    template<typename U, typename Pred>
+    friend void parallel_copy_if(const XVector<U>&, XVector<U>&, Pred, size_t, ThreadPool&);
+    template<typename U, typename Pred>
+    friend size_t parallel_partition(XVector<U>&, Pred, size_t, ThreadPool&);
 
 public:
     // type aliases for STL compatibility
@@ -71,8 +179,18 @@ public:
     XVector(const XVector<T>&);
     XVector(XVector<T>&&) noexcept;
     XVector(std::initializer_list<T> init);
-    template<typename InputIt>
+    template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
     XVector(InputIt first, InputIt last);
+
+    // the same with an execution policy (xvc::seq, xvc::par, xvc::par_unseq) chosen per call
+    template<typename ExecutionPolicy, typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    XVector(ExecutionPolicy&&, size_t, const T& = T{});
+    template<typename ExecutionPolicy, typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    XVector(ExecutionPolicy&&, const XVector<T>&);
+    template<typename ExecutionPolicy, typename InputIt,
+             typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    XVector(ExecutionPolicy&&, InputIt first, InputIt last);
     ~XVector();
 
     //asignment operator
@@ -110,18 +228,84 @@ public:
     // modifiers
     void append(const T&);
     void append(T&&);
+    template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    void append(InputIt first, InputIt last);
+    void append(const T* src, size_t count);
+#if __cplusplus >= 202002L
+    void append(std::span<const T>);
+#endif
+    template<typename Range>
+    void append_range(Range&&);
     void push_back(const T&);
     void push_back(T&&);
     void pop_back();
     void concatenate(const XVector<T>&);
+    void concatenate(XVector<T>&&);
     void clear() noexcept;
     void swap(XVector<T>& other) noexcept;
     void reserve(size_t);
     void resize(size_t, const T& = T{});
+    void assign(size_t, const T&);
+    template<typename ExecutionPolicy, typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    void concatenate(ExecutionPolicy&&, const XVector<T>&);
+    template<typename ExecutionPolicy, typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    void resize(ExecutionPolicy&&, size_t, const T& = T{});
+    template<typename ExecutionPolicy, typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+    void assign(ExecutionPolicy&&, size_t, const T&);
+    void set_stream_mode(StreamMode) noexcept;
+    [[nodiscard]] StreamMode stream_mode() const noexcept;
     void shrink_to_fit();
     template<typename... Args>
     void emplace_back(Args&&...);
 
+    // unchecked appends for loops that have already reserved enough capacity,
+    // going past capacity() is undefined (asserted in DEBUG builds)
+    void unchecked_push_back(const T&);
+    void unchecked_push_back(T&&);
+    template<typename... Args>
+    void unchecked_emplace_back(Args&&...);
+
+    // BackWriter appends through a local end pointer and only writes size_ back when it is
+    // committed or destroyed. the vector must not be touched through other means meanwhile.
+    class BackWriter
+    {
+    private:
+        XVector<T>* vec_;
+        T* end_;
+
+    public:
+        explicit BackWriter(XVector<T>& vec) noexcept : vec_(&vec), end_(vec.data_ + vec.size_) {}
+        BackWriter(const BackWriter&) = delete;
+        BackWriter& operator=(const BackWriter&) = delete;
+        ~BackWriter() { commit(); }
+
+        template<typename... Args>
+        void emplace_back(Args&&... args)
+        {
+            XVECTOR_ASSERT(end_ < vec_->data_ + vec_->capacity_, "BackWriter past reserved capacity");
+            new (end_) T(std::forward<Args>(args)...);
+            ++end_;
+        }
+        void push_back(const T& item) { emplace_back(item); }
+        void push_back(T&& item) { emplace_back(std::move(item)); }
+
+        [[nodiscard]] size_t remaining() const noexcept { return vec_->capacity_ - (end_ - vec_->data_); }
+        void commit() noexcept { vec_->size_ = end_ - vec_->data_; }
+    };
+
+    [[nodiscard]] BackWriter back_writer(size_t = 0);
+    T* insert(const T* pos, const T&);
+    T* insert(const T* pos, T&&);
+    T* insert(const T* pos, size_t count, const T&);
+    template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    T* insert(const T* pos, InputIt first, InputIt last);
+    T* insert(const T* pos, std::initializer_list<T>);
+    template<typename... Args>
+    T* emplace(const T* pos, Args&&...);
+    T* erase(const T* pos);
+    T* erase(const T* first, const T* last);
+    T* unordered_erase(const T* pos);
+
     friend bool operator==(const XVector<T>& left, const XVector<T>& right) {
         if (left.size_ != right.size_) return false;
         
@@ -129,6 +313,11 @@ public:
         {
             return std::memcmp(left.data_, right.data_, left.size_ * sizeof(T)) == 0;
         }
+        else if constexpr (simd::searchable_v<T>)
+        {
+            // float and double: -0.0 == 0.0 and NaN != NaN rule out memcmp
+            return simd::mismatch(left.data_, right.data_, left.size_) == left.size_;
+        }
         else
         {
             for (size_t i = 0; i < left.size_; ++i)
@@ -142,173 +331,236 @@ public:
     friend bool operator!=(const XVector<T>& left, const XVector<T>& right) {
         return !(left == right);
     }
+
+    // lexicographic, like std::lexicographical_compare. arithmetic types skip the equal prefix with
+    // the mismatch kernels; a pair where neither is less (NaN) is passed over, as std does.
+    friend bool operator<(const XVector<T>& left, const XVector<T>& right) {
+        const size_t common = std::min(left.size_, right.size_);
+        if constexpr (simd::searchable_v<T>)
+        {
+            for (size_t i = simd::mismatch(left.data_, right.data_, common); i < common;
+                 i += 1 + simd::mismatch(left.data_ + i + 1, right.data_ + i + 1, common - i - 1))
+            {
+                if (left.data_[i] < right.data_[i]) return true;
+                if (right.data_[i] < left.data_[i]) return false;
+            }
+            return left.size_ < right.size_;
+        }
+        else
+        {
+            return std::lexicographical_compare(left.data_, left.data_ + left.size_, right.data_, right.data_ + right.size_);
+        }
+    }
+
+    friend bool operator>(const XVector<T>& left, const XVector<T>& right) {
+        return right < left;
+    }
+
+    friend bool operator<=(const XVector<T>& left, const XVector<T>& right) {
+        return !(right < left);
+    }
+
+    friend bool operator>=(const XVector<T>& left, const XVector<T>& right) {
+        return !(left < right);
+    }
+
+#if __cplusplus >= 202002L
+    // the first element pair that is not equivalent decides, then the sizes. a template, so that
+    // <, >, <= and >= still pick the operators above: as a constrained non-template this would be
+    // the more constrained candidate and a < b would become (a <=> b) < 0, which stops at a NaN pair.
+    template<typename U = T, typename = std::enable_if_t<std::three_way_comparable<U>>>
+    friend auto operator<=>(const XVector<T>& left, const XVector<T>& right) {
+        const size_t common = std::min(left.size_, right.size_);
+        if constexpr (simd::searchable_v<T>)
+        {
+            // an unequal pair compares unequal with <=> too, NaN included (unordered)
+            const size_t i = simd::mismatch(left.data_, right.data_, common);
+            if (i < common) return left.data_[i] <=> right.data_[i];
+            return std::compare_three_way_result_t<T>(left.size_ <=> right.size_);
+        }
+        else
+        {
+            return std::lexicographical_compare_three_way(left.data_, left.data_ + left.size_,
+                                                          right.data_, right.data_ + right.size_);
+        }
+    }
+#endif
 };
 
 template<typename T>
 size_t XVector<T>::nextPowerOf2(size_t n)
 {
-    if (n <= 1) return 1;
-    --n;
-    n |= n >> 1;
-    n |= n >> 2;
-    n |= n >> 4;
-    n |= n >> 8;
-    n |= n >> 16;
-    if constexpr (sizeof(size_t) > 4) n |= n >> 32; // compile-time check to avoid undefined behavior on 32-bit systems
-    return n+1;
+    return detail::nextPowerOf2(n);
 }
 
+// memcpy, or a streaming copy for large buffers depending on streamMode_, split across
+// the thread pool above parallel_threshold or when mode asks for it
 template<typename T>
-void XVector<T>::fillTrivial(T* dest, size_t count, const T& value) {
-    if (count == 0) return;
+void XVector<T>::copyTrivial(T* dest, const T* src, size_t count, detail::Exec mode) const noexcept
+{
+    const size_t bytes = count * sizeof(T);
+    const bool stream = streamMode_ == StreamMode::always ||
+                        (streamMode_ == StreamMode::automatic && bytes >= stream_copy_threshold);
+    auto copy = [dest, src, stream](size_t first, size_t last) {
+        if (stream)
+            simd::streamCopy(dest + first, src + first, (last - first) * sizeof(T));
+        else
+            std::memcpy(dest + first, src + first, (last - first) * sizeof(T));
+    };
 
-    std::memcpy(dest, &value, sizeof(T));
-    size_t filled = 1;
-    while (filled < count)
-    {
-        const size_t chunk = std::min(filled, count - filled);
-        std::memcpy(dest + filled, dest, chunk * sizeof(T));
-        filled += chunk;
-    }
+    if (detail::runsParallel<T>(count, mode))
+        detail::parallelChunks(count, detail::parallelMinChunk<T>(), copy); // the chunks cannot throw
+    else if (bytes)
+        copy(0, count);
 }
 
-
+// destroys count elements, split across the thread pool above parallel_destroy_threshold
 template<typename T>
-void XVector<T>::reallocate(bool doubleCap)
+void XVector<T>::destroy(T* first, size_t count) noexcept
 {
-    const size_t newCap = doubleCap ? (capacity_ ? capacity_ * 2 : 1) : nextPowerOf2(size_); // for append could just be capacity_ *= 2, for concatenate need more
-    T* newData = static_cast<T*>(::operator new(newCap * sizeof(T)));
-
-    // compile-time check to avoid try-catch block if T has a noexcept move constructor
-    if constexpr (std::is_trivially_copyable_v<T>) 
+    if constexpr (!std::is_trivially_destructible_v<T>)
     {
-        std::memcpy(newData, data_, size_ * sizeof(T));
+        auto destroyChunk = [first](size_t chunkFirst, size_t chunkLast) noexcept {
+            for (size_t i = chunkFirst; i < chunkLast; ++i)
+                first[i].~T();
+        };
+
+        if (parallel_destroy_threshold != 0 && count >= parallel_destroy_threshold)
+            detail::parallelChunks(count, detail::parallelMinChunk<T>(), destroyChunk); // the chunks cannot throw
+        else
+            destroyChunk(0, count);
     }
-    else if constexpr (std::is_nothrow_move_constructible_v<T>)
+}
+
+// build(first, last) constructs dest[first, last) or nothing at all. chunks that finished are
+// recorded, so when one of them throws the others are destroyed again before rethrowing.
+template<typename T>
+template<typename Build>
+void XVector<T>::buildParallel(T* dest, size_t count, Build&& build)
+{
+    if constexpr (std::is_trivially_destructible_v<T>)
     {
-        for (size_t i = 0; i < size_; ++i)
-            new (&newData[i]) T(std::move(data_[i]));
+        detail::parallelChunks(count, detail::parallelMinChunk<T>(), build);
     }
     else
     {
-        size_t i = 0;
+        XVector<std::pair<size_t, size_t>> built;
+        built.reserve(ThreadPool::global().concurrency()); // push_back below never allocates
+        std::mutex mutex;
+
         try
         {
-            for (; i < size_; ++i)
-                new (&newData[i]) T(std::move(data_[i]));
+            detail::parallelChunks(count, detail::parallelMinChunk<T>(), [&](size_t first, size_t last) {
+                build(first, last);
+                std::lock_guard<std::mutex> lock(mutex);
+                built.push_back({ first, last });
+            });
         }
         catch (...)
         {
-            if constexpr (!std::is_trivially_destructible_v<T>)
+            for (const auto& range : built)
             {
-                for (size_t j = 0; j < i; ++j)
-                    newData[j].~T();
+                for (size_t i = range.first; i < range.second; ++i)
+                    dest[i].~T();
             }
-
-            ::operator delete(newData);
             throw;
         }
     }
-    
-    if constexpr (!std::is_trivially_destructible_v<T>)
-    {
-        for (size_t i = 0; i < size_; i++)
-            data_[i].~T();
-    }
-    
-    ::operator delete(data_);
-
-    data_ = newData;
-    capacity_ = newCap;
 }
 
 template<typename T>
-XVector<T>::XVector() 
-    : size_(0), capacity_(1), data_(static_cast<T*>(::operator new(sizeof(T)))) {}
-
-template<typename T>
-XVector<T>::XVector(size_t count, const T& value)
-    : size_(count), capacity_(nextPowerOf2(count)), data_(static_cast<T*>(::operator new(capacity_ * sizeof(T))))
+void XVector<T>::uninitFill(T* dest, size_t count, const T& value, detail::Exec mode)
 {
-    if constexpr (std::is_trivially_copyable_v<T>)
+    if (detail::runsParallel<T>(count, mode))
     {
-        fillTrivial(data_, size_, value);
+        buildParallel(dest, count, [dest, &value](size_t first, size_t last) {
+            uninitFill(dest + first, last - first, value, detail::Exec::sequential);
+        });
     }
-    else if constexpr (std::is_nothrow_copy_constructible_v<T>) // compile-time check if T has a noexcept copy constructor
+    else if constexpr (std::is_trivially_copyable_v<T>)
     {
-        for (size_t i = 0; i < size_; ++i)
-            new (&data_[i]) T(value);
+        simd::fillTrivial(dest, count, value);
     }
     else
     {
         size_t i = 0;
         try
         {
-            for (; i < size_; ++i)
-                new (&data_[i]) T(value);
+            for (; i < count; ++i)
+                new (&dest[i]) T(value);
         }
         catch (...)
         {
             if constexpr (!std::is_trivially_destructible_v<T>)
             {
                 for (size_t j = 0; j < i; ++j)
-                    data_[j].~T();
+                    dest[j].~T();
             }
 
-            ::operator delete(data_);
             throw;
         }
     }
 }
 
 template<typename T>
-template<size_t N>
-XVector<T>::XVector(T (&a)[N])
-    : size_(N), capacity_(nextPowerOf2(N)), data_(static_cast<T*>(::operator new(capacity_ * sizeof(T))))
+template<typename It>
+void XVector<T>::uninitCopy(T* dest, It first, size_t count, detail::Exec mode)
 {
-    if constexpr (std::is_trivially_copyable_v<T>)
+    if constexpr (detail::is_contiguous_iterator_v<It> &&
+                  std::is_same_v<typename std::iterator_traits<It>::value_type, T>)
     {
-        std::memcpy(data_, a, size_ * sizeof(T));
+        if (detail::runsParallel<T>(count, mode))
+        {
+            const T* src = detail::toAddress(first);
+            buildParallel(dest, count, [dest, src](size_t chunkFirst, size_t chunkLast) {
+                uninitCopy(dest + chunkFirst, src + chunkFirst, chunkLast - chunkFirst, detail::Exec::sequential);
+            });
+            return;
+        }
     }
-    else if constexpr (std::is_nothrow_copy_constructible_v<T>) // compile time check if T has a noexcept copy constructor
+
+    if constexpr (std::is_trivially_copyable_v<T> && detail::is_contiguous_iterator_v<It> &&
+                  std::is_same_v<typename std::iterator_traits<It>::value_type, T>)
     {
-        for (size_t i = 0; i < size_; ++i)
-            new (&data_[i]) T(a[i]);
+        if (count) std::memcpy(dest, detail::toAddress(first), count * sizeof(T));
     }
     else
     {
         size_t i = 0;
         try
         {
-            for (; i < size_; ++i)
-                new (&data_[i]) T(a[i]);
+            for (; i < count; ++i, ++first)
+                new (&dest[i]) T(*first);
         }
         catch (...)
         {
             if constexpr (!std::is_trivially_destructible_v<T>)
             {
                 for (size_t j = 0; j < i; ++j)
-                    data_[j].~T();
+                    dest[j].~T();
             }
 
-            ::operator delete(data_);
             throw;
         }
     }
 }
 
+
 template<typename T>
-XVector<T>::XVector(const XVector<T>& other)
-    : size_(other.size_), capacity_(other.capacity_), data_(static_cast<T*>(::operator new(other.capacity_ * sizeof(T))))
+void XVector<T>::reallocate(bool doubleCap)
 {
-    if constexpr (std::is_trivially_copyable_v<T>)
+    const size_t newCap = doubleCap ? (capacity_ ? capacity_ * 2 : 1) : nextPowerOf2(size_); // for append could just be capacity_ *= 2, for concatenate need more
+    T* newData = static_cast<T*>(::operator new(newCap * sizeof(T)));
+
+    // compile-time check to avoid try-catch block if T has a noexcept move constructor
+    if constexpr (std::is_trivially_copyable_v<T>) 
     {
-        std::memcpy(data_, other.data_, size_ * sizeof(T));
+        copyTrivial(newData, data_, size_);
     }
-    else if constexpr (std::is_nothrow_copy_constructible_v<T>)
+    else if constexpr (std::is_nothrow_move_constructible_v<T>)
     {
         for (size_t i = 0; i < size_; ++i)
-            new (&data_[i]) T(other.data_[i]);
+            new (&newData[i]) T(std::move(data_[i]));
     }
     else
     {
@@ -316,105 +568,21 @@ XVector<T>::XVector(const XVector<T>& other)
         try
         {
             for (; i < size_; ++i)
-                new (&data_[i]) T(other.data_[i]);
+                new (&newData[i]) T(std::move(data_[i]));
         }
         catch (...)
         {
             if constexpr (!std::is_trivially_destructible_v<T>)
             {
                 for (size_t j = 0; j < i; ++j)
-                    data_[j].~T();
+                    newData[j].~T();
             }
 
-            ::operator delete(data_);
-            throw;
-        }
-    }
-}
-
-template<typename T>
-XVector<T>::XVector(XVector<T>&& other) noexcept
-    : size_(other.size_), capacity_(other.capacity_), data_(std::exchange(other.data_, nullptr)) 
-{
-    other.size_ = 0;
-    other.capacity_ = 0;
-}
-
-template<typename T>
-XVector<T>::XVector(std::initializer_list<T> init)
-    : size_(init.size()), capacity_(nextPowerOf2(init.size())), 
-      data_(static_cast<T*>(::operator new(capacity_ * sizeof(T))))
-{
-    if constexpr (std::is_trivially_copyable_v<T>) {
-        std::memcpy(data_, init.begin(), size_ * sizeof(T));
-    } else {
-        size_t i = 0;
-        try {
-            for (const auto& val : init) {
-                new (&data_[i++]) T(val);
-            }
-        } catch (...) {
-            if constexpr (!std::is_trivially_destructible_v<T>) {
-                for (size_t j = 0; j < i; ++j)
-                    data_[j].~T();
-            }
-            ::operator delete(data_);
+            ::operator delete(newData);
             throw;
         }
     }
-}
-
-template<typename T>
-template<typename InputIt>
-XVector<T>::XVector(InputIt first, InputIt last)
-    : size_(0), capacity_(1), data_(nullptr)
-{
-    // use iterator traits to determine if we can calculate size efficiently
-    using category = typename std::iterator_traits<InputIt>::iterator_category;
     
-    if constexpr (std::is_base_of_v<std::random_access_iterator_tag, category>) {
-        // random access iterators can pre-calculate size
-        size_ = std::distance(first, last);
-        capacity_ = nextPowerOf2(size_);
-        data_ = static_cast<T*>(::operator new(capacity_ * sizeof(T)));
-        
-        size_t i = 0;
-        try {
-            for (; first != last; ++first, ++i) {
-                new (&data_[i]) T(*first);
-            }
-        } catch (...) {
-            if constexpr (!std::is_trivially_destructible_v<T>) {
-                for (size_t j = 0; j < i; ++j)
-                    data_[j].~T();
-            }
-            ::operator delete(data_);
-            throw;
-        }
-    } else {
-        // other iterators grow as we go
-        capacity_ = 1;
-        data_ = static_cast<T*>(::operator new(capacity_ * sizeof(T)));
-        
-        try {
-            for (; first != last; ++first) {
-                if (size_ >= capacity_) reallocate(true);
-                new (&data_[size_++]) T(*first);
-            }
-        } catch (...) {
-            if constexpr (!std::is_trivially_destructible_v<T>) {
-                for (size_t j = 0; j < size_; ++j)
-                    data_[j].~T();
-            }
-            ::operator delete(data_);
-            throw;
-        }
-    }
-}
-
-template<typename T>
-XVector<T>::~XVector()
-{
     if constexpr (!std::is_trivially_destructible_v<T>)
     {
         for (size_t i = 0; i < size_; i++)
@@ -422,27 +590,349 @@ XVector<T>::~XVector()
     }
     
     ::operator delete(data_);
+
+    data_ = newData;
+    capacity_ = newCap;
 }
 
+// opens count uninitialized slots at idx and lets fill construct them, fill must clean up after itself if it throws
 template<typename T>
-XVector<T>& XVector<T>::operator=(const XVector<T>& other)
+template<typename Fill>
+T* XVector<T>::insertGap(size_t idx, size_t count, Fill&& fill)
 {
-    if (this != &other)
+    if (count == 0) return data_ + idx;
+
+    const size_t newSize = size_ + count;
+
+    // shifting in place needs a move that cannot throw, otherwise build a new buffer for the strong guarantee
+    if (newSize > capacity_ || (idx != size_ && !(std::is_trivially_copyable_v<T> || std::is_nothrow_move_constructible_v<T>)))
     {
-        if (other.size_ <= capacity_)
+        const size_t newCap = std::max(capacity_, nextPowerOf2(newSize));
+        T* newData = static_cast<T*>(::operator new(newCap * sizeof(T)));
+
+        // fill first, the source of the new elements may still point into data_
+        try
         {
-            if constexpr (std::is_trivially_copyable_v<T>)
+            fill(newData + idx);
+        }
+        catch (...)
+        {
+            ::operator delete(newData);
+            throw;
+        }
+
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            if (size_)
             {
-                std::memcpy(data_, other.data_, other.size_ * sizeof(T));
+                std::memcpy(newData, data_, idx * sizeof(T));
+                std::memcpy(newData + idx + count, data_ + idx, (size_ - idx) * sizeof(T));
             }
-            else
-            {
-                size_t i = 0;
-                for (; i < std::min(size_, other.size_); ++i)
-                    data_[i] = other.data_[i];
-                
-                if constexpr (std::is_nothrow_copy_constructible_v<T>)
-                {
+        }
+        else if constexpr (std::is_nothrow_move_constructible_v<T>)
+        {
+            for (size_t i = 0; i < idx; ++i)
+                new (&newData[i]) T(std::move(data_[i]));
+            for (size_t i = idx; i < size_; ++i)
+                new (&newData[i + count]) T(std::move(data_[i]));
+        }
+        else
+        {
+            size_t i = 0;
+            try
+            {
+                for (; i < size_; ++i)
+                    new (&newData[i < idx ? i : i + count]) T(std::move(data_[i]));
+            }
+            catch (...)
+            {
+                if constexpr (!std::is_trivially_destructible_v<T>)
+                {
+                    for (size_t j = 0; j < i; ++j)
+                        newData[j < idx ? j : j + count].~T();
+                    for (size_t j = idx; j < idx + count; ++j)
+                        newData[j].~T();
+                }
+
+                ::operator delete(newData);
+                throw;
+            }
+        }
+
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for (size_t i = 0; i < size_; i++)
+                data_[i].~T();
+        }
+
+        ::operator delete(data_);
+
+        data_ = newData;
+        capacity_ = newCap;
+    }
+    else
+    {
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            std::memmove(data_ + idx + count, data_ + idx, (size_ - idx) * sizeof(T));
+        }
+        else
+        {
+            // relocate the tail back to front so the gap is left uninitialized
+            for (size_t i = size_; i-- > idx;)
+            {
+                new (&data_[i + count]) T(std::move(data_[i]));
+                data_[i].~T();
+            }
+        }
+
+        try
+        {
+            fill(data_ + idx);
+        }
+        catch (...)
+        {
+            // close the gap again
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                std::memmove(data_ + idx, data_ + idx + count, (size_ - idx) * sizeof(T));
+            }
+            else
+            {
+                for (size_t i = idx; i < size_; ++i)
+                {
+                    new (&data_[i]) T(std::move(data_[i + count]));
+                    data_[i + count].~T();
+                }
+            }
+
+            throw;
+        }
+    }
+
+    size_ = newSize;
+    return data_ + idx;
+}
+
+template<typename T>
+XVector<T>::XVector() 
+    : size_(0), capacity_(1), data_(static_cast<T*>(::operator new(sizeof(T)))), streamMode_(StreamMode::automatic) {}
+
+template<typename T>
+XVector<T>::XVector(size_t count, const T& value)
+    : XVector(detail::Exec::automatic, count, value) {}
+
+template<typename T>
+XVector<T>::XVector(detail::WithCapacity, size_t capacity)
+    : size_(0), capacity_(nextPowerOf2(capacity)), data_(static_cast<T*>(::operator new(capacity_ * sizeof(T)))),
+      streamMode_(StreamMode::automatic) {}
+
+template<typename T>
+template<typename ExecutionPolicy, typename>
+XVector<T>::XVector(ExecutionPolicy&&, size_t count, const T& value)
+    : XVector(std::decay_t<ExecutionPolicy>::mode, count, value) {}
+
+template<typename T>
+XVector<T>::XVector(detail::Exec mode, size_t count, const T& value)
+    : size_(count), capacity_(nextPowerOf2(count)), data_(static_cast<T*>(::operator new(capacity_ * sizeof(T)))),
+      streamMode_(StreamMode::automatic)
+{
+    // SIMD fill for trivially copyable types, split across threads above parallel_threshold
+    try
+    {
+        uninitFill(data_, size_, value, mode);
+    }
+    catch (...)
+    {
+        ::operator delete(data_);
+        throw;
+    }
+}
+
+template<typename T>
+template<size_t N>
+XVector<T>::XVector(T (&a)[N])
+    : size_(N), capacity_(nextPowerOf2(N)), data_(static_cast<T*>(::operator new(capacity_ * sizeof(T)))),
+      streamMode_(StreamMode::automatic)
+{
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        std::memcpy(data_, a, size_ * sizeof(T));
+    }
+    else if constexpr (std::is_nothrow_copy_constructible_v<T>) // compile time check if T has a noexcept copy constructor
+    {
+        for (size_t i = 0; i < size_; ++i)
+            new (&data_[i]) T(a[i]);
+    }
+    else
+    {
+        size_t i = 0;
+        try
+        {
+            for (; i < size_; ++i)
+                new (&data_[i]) T(a[i]);
+        }
+        catch (...)
+        {
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                for (size_t j = 0; j < i; ++j)
+                    data_[j].~T();
+            }
+
+            ::operator delete(data_);
+            throw;
+        }
+    }
+}
+
+template<typename T>
+XVector<T>::XVector(const XVector<T>& other)
+    : XVector(detail::Exec::automatic, other) {}
+
+template<typename T>
+template<typename ExecutionPolicy, typename>
+XVector<T>::XVector(ExecutionPolicy&&, const XVector<T>& other)
+    : XVector(std::decay_t<ExecutionPolicy>::mode, other) {}
+
+template<typename T>
+XVector<T>::XVector(detail::Exec mode, const XVector<T>& other)
+    : size_(other.size_), capacity_(other.capacity_), data_(static_cast<T*>(::operator new(other.capacity_ * sizeof(T)))),
+      streamMode_(other.streamMode_)
+{
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        copyTrivial(data_, other.data_, size_, mode);
+    }
+    else
+    {
+        try
+        {
+            uninitCopy(data_, other.data_, size_, mode);
+        }
+        catch (...)
+        {
+            ::operator delete(data_);
+            throw;
+        }
+    }
+}
+
+template<typename T>
+XVector<T>::XVector(XVector<T>&& other) noexcept
+    : size_(other.size_), capacity_(other.capacity_), data_(std::exchange(other.data_, nullptr)), streamMode_(other.streamMode_)
+{
+    other.size_ = 0;
+    other.capacity_ = 0;
+}
+
+template<typename T>
+XVector<T>::XVector(std::initializer_list<T> init)
+    : size_(init.size()), capacity_(nextPowerOf2(init.size())), 
+      data_(static_cast<T*>(::operator new(capacity_ * sizeof(T)))), streamMode_(StreamMode::automatic)
+{
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        std::memcpy(data_, init.begin(), size_ * sizeof(T));
+    } else {
+        size_t i = 0;
+        try {
+            for (const auto& val : init) {
+                new (&data_[i++]) T(val);
+            }
+        } catch (...) {
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                for (size_t j = 0; j < i; ++j)
+                    data_[j].~T();
+            }
+            ::operator delete(data_);
+            throw;
+        }
+    }
+}
+
+template<typename T>
+template<typename InputIt, typename>
+XVector<T>::XVector(InputIt first, InputIt last)
+    : XVector(detail::Exec::automatic, first, last) {}
+
+template<typename T>
+template<typename ExecutionPolicy, typename InputIt, typename, typename>
+XVector<T>::XVector(ExecutionPolicy&&, InputIt first, InputIt last)
+    : XVector(std::decay_t<ExecutionPolicy>::mode, first, last) {}
+
+template<typename T>
+template<typename InputIt, typename>
+XVector<T>::XVector(detail::Exec mode, InputIt first, InputIt last)
+    : size_(0), capacity_(1), data_(nullptr), streamMode_(StreamMode::automatic)
+{
+    // use iterator traits to determine if we can calculate size efficiently
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
+    
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+        // multi-pass iterators can pre-calculate size, walking a list or set twice is
+        // still far cheaper than log2(n) reallocations
+        const size_t count = static_cast<size_t>(std::distance(first, last));
+        capacity_ = nextPowerOf2(count);
+        data_ = static_cast<T*>(::operator new(capacity_ * sizeof(T)));
+        
+        try {
+            uninitCopy(data_, first, count, mode); // a single memcpy for contiguous trivially copyable sources
+        } catch (...) {
+            ::operator delete(data_);
+            throw;
+        }
+        size_ = count;
+    } else {
+        // other iterators grow as we go
+        capacity_ = 1;
+        data_ = static_cast<T*>(::operator new(capacity_ * sizeof(T)));
+        
+        try {
+            for (; first != last; ++first) {
+                if (size_ >= capacity_) reallocate(true);
+                new (&data_[size_++]) T(*first);
+            }
+        } catch (...) {
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                for (size_t j = 0; j < size_; ++j)
+                    data_[j].~T();
+            }
+            ::operator delete(data_);
+            throw;
+        }
+    }
+}
+
+template<typename T>
+XVector<T>::~XVector()
+{
+    destroy(data_, size_);
+    ::operator delete(data_);
+}
+
+template<typename T>
+XVector<T>& XVector<T>::operator=(const XVector<T>& other)
+{
+    if (this != &other)
+    {
+        if (other.size_ <= capacity_)
+        {
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                copyTrivial(data_, other.data_, other.size_);
+            }
+            else
+            {
+                size_t i = 0;
+                for (; i < std::min(size_, other.size_); ++i)
+                    data_[i] = other.data_[i];
+
+                if (other.size_ < size_)
+                {
+                    destroy(data_ + other.size_, size_ - other.size_);
+                }
+                else if constexpr (std::is_nothrow_copy_constructible_v<T>)
+                {
                     for (; i < other.size_; ++i)
                         new (&data_[i]) T(other.data_[i]);
                 }
@@ -455,13 +945,7 @@ XVector<T>& XVector<T>::operator=(const XVector<T>& other)
                     }
                     catch (...)
                     {
-                        if constexpr (!std::is_trivially_destructible_v<T>)
-                        {
-                            for (size_t i = 0; i < size_; ++i)
-                                data_[i].~T();
-                        }
-
-                        ::operator delete(data_);
+                        size_ = i; // keep what was copied, the vector stays valid
                         throw;
                     }
                 }
@@ -474,29 +958,16 @@ XVector<T>& XVector<T>::operator=(const XVector<T>& other)
             T* newData = static_cast<T*>(::operator new(other.capacity_ * sizeof(T))); // for exception safety
             if constexpr (std::is_trivially_copyable_v<T>)
             {
-                std::memcpy(newData, other.data_, other.size_ * sizeof(T));
-            }
-            else if constexpr (std::is_nothrow_copy_constructible_v<T>)
-            {
-                for (size_t i = 0; i < other.size_; ++i)
-                    new (&newData[i]) T(other.data_[i]);
+                copyTrivial(newData, other.data_, other.size_);
             }
             else
             {
-                size_t i = 0;
                 try
                 {
-                    for (; i < other.size_; ++i)
-                        new (&newData[i]) T(other.data_[i]);
+                    uninitCopy(newData, other.data_, other.size_);
                 }
                 catch (...)
                 {
-                    if constexpr (!std::is_trivially_destructible_v<T>)
-                    {
-                        for (size_t j = 0; j < i; ++j)
-                            newData[j].~T();
-                    }
-
                     ::operator delete(newData);
                     throw;
                 }
@@ -533,6 +1004,7 @@ XVector<T>& XVector<T>::operator=(XVector<T>&& other) noexcept
         size_ = std::exchange(other.size_, 0);
         capacity_ = std::exchange(other.capacity_, 0);
         data_ = std::exchange(other.data_, nullptr);
+        streamMode_ = other.streamMode_;
     }
     return *this;
 }
@@ -604,6 +1076,72 @@ void XVector<T>::append(T&& item)
     ++size_;
 }
 
+template<typename T>
+template<typename InputIt, typename>
+void XVector<T>::append(InputIt first, InputIt last)
+{
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
+
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>)
+    {
+        // size is known, so grow once and copy (memcpy for contiguous trivially copyable sources)
+        const size_t count = static_cast<size_t>(std::distance(first, last));
+        insertGap(size_, count, [&first, count](T* dest) { uninitCopy(dest, first, count); });
+    }
+    else
+    {
+        // single pass, fill whatever capacity is free before checking again
+        while (first != last)
+        {
+            if (size_ >= capacity_) reallocate(true);
+            T* out = data_ + size_;
+            T* const stop = data_ + capacity_;
+            try
+            {
+                for (; out != stop && first != last; ++first, ++out)
+                    new (out) T(*first);
+            }
+            catch (...)
+            {
+                size_ = out - data_;
+                throw;
+            }
+            size_ = out - data_;
+        }
+    }
+}
+
+template<typename T>
+void XVector<T>::append(const T* src, size_t count)
+{
+    insertGap(size_, count, [src, count](T* dest) { uninitCopy(dest, src, count); });
+}
+
+#if __cplusplus >= 202002L
+template<typename T>
+void XVector<T>::append(std::span<const T> items)
+{
+    append(items.data(), items.size());
+}
+#endif
+
+template<typename T>
+template<typename Range>
+void XVector<T>::append_range(Range&& range)
+{
+    using std::begin;
+    using std::end;
+
+    if constexpr (detail::is_contiguous_range_of<Range, T>::value)
+    {
+        append(std::data(range), static_cast<size_t>(std::size(range)));
+    }
+    else
+    {
+        append(begin(range), end(range));
+    }
+}
+
 template<typename T>
 void XVector<T>::push_back(const T& item) { append(item); }
 
@@ -626,6 +1164,19 @@ void XVector<T>::pop_back()
 
 template<typename T>
 void XVector<T>::concatenate(const XVector<T>& other)
+{
+    concatenate(detail::Exec::automatic, other);
+}
+
+template<typename T>
+template<typename ExecutionPolicy, typename>
+void XVector<T>::concatenate(ExecutionPolicy&&, const XVector<T>& other)
+{
+    concatenate(std::decay_t<ExecutionPolicy>::mode, other);
+}
+
+template<typename T>
+void XVector<T>::concatenate(detail::Exec mode, const XVector<T>& other)
 {
     if (other.empty()) return;
 
@@ -636,8 +1187,8 @@ void XVector<T>::concatenate(const XVector<T>& other)
         T* newData = static_cast<T*>(::operator new(newCap * sizeof(T)));
         if constexpr (std::is_trivially_copyable_v<T>)
         {
-            std::memcpy(newData, data_, size_ * sizeof(T));
-            std::memcpy(newData + size_, other.data_, other.size_ * sizeof(T));
+            copyTrivial(newData, data_, size_);
+            copyTrivial(newData + size_, other.data_, other.size_, mode);
         }
         else 
         {
@@ -667,30 +1218,22 @@ void XVector<T>::concatenate(const XVector<T>& other)
                 }
             }
             
-            if constexpr (std::is_nothrow_copy_constructible_v<T>)
+            // when other is *this its elements were just moved, the copies come from newData
+            const T* src = &other == this ? newData : other.data_;
+            try
             {
-                for (size_t i = size_; i < newSize; ++i)
-                    new (&newData[i]) T(other.data_[i-size_]);
+                uninitCopy(newData + size_, src, other.size_, mode);
             }
-            else
+            catch (...)
             {
-                size_t i = size_;
-                try
+                if constexpr (!std::is_trivially_destructible_v<T>)
                 {
-                    for (; i < newSize; ++i)
-                        new (&newData[i]) T(other.data_[i-size_]);
+                    for (size_t j = 0; j < size_; ++j)
+                        newData[j].~T();
                 }
-                catch (...)
-                {
-                    if constexpr (!std::is_trivially_destructible_v<T>)
-                    {
-                        for (size_t j = 0; j < i; ++j)
-                            newData[j].~T();
-                    }
 
-                    ::operator delete(newData);
-                    throw;
-                }
+                ::operator delete(newData);
+                throw;
             }
         }
         
@@ -708,36 +1251,101 @@ void XVector<T>::concatenate(const XVector<T>& other)
     }
     else
     {
+        // other may be *this, but the source [0, size_) never overlaps the destination
         if constexpr (std::is_trivially_copyable_v<T>)
-        {
-            std::memmove(data_ + size_, other.data_, other.size_ * sizeof(T));
-        }
-        else if constexpr (std::is_nothrow_copy_constructible_v<T>) // compile-time check if T has a noexcept copy constructor
-        {
-            for (size_t i = size_; i < newSize; ++i)
-                new (&data_[i]) T(other.data_[i-size_]);
-        }
+            copyTrivial(data_ + size_, other.data_, other.size_, mode);
         else
+            uninitCopy(data_ + size_, other.data_, other.size_, mode);
+        size_ = newSize;
+    }
+}
+
+template<typename T>
+void XVector<T>::concatenate(XVector<T>&& other)
+{
+    if (this == &other)
+    {
+        XVector<T> tmp(other);
+        concatenate(std::move(tmp));
+        return;
+    }
+    if (other.empty()) return;
+
+    if (size_ == 0 && other.capacity_ >= capacity_)
+    {
+        swap(other); // nothing to keep, take other's buffer as is
+        std::swap(streamMode_, other.streamMode_); // but not its settings
+        return;
+    }
+
+    const size_t newSize = size_ + other.size_;
+    constexpr bool relocatable = std::is_trivially_copyable_v<T> || std::is_nothrow_move_constructible_v<T>;
+
+    if constexpr (relocatable)
+    {
+        if (newSize > capacity_ && newSize <= other.capacity_)
         {
-            size_t i = size_;
-            try
+            // other's buffer is big enough, so shift its elements up and relocate ours in front of them
+            if constexpr (std::is_trivially_copyable_v<T>)
             {
-                for (; i < newSize; ++i)
-                    new (&data_[i]) T(other.data_[i-size_]);
+                std::memmove(other.data_ + size_, other.data_, other.size_ * sizeof(T));
+                std::memcpy(other.data_, data_, size_ * sizeof(T));
             }
-            catch (...)
+            else
             {
-                if constexpr (!std::is_trivially_destructible_v<T>)
+                for (size_t i = other.size_; i-- > 0;)
                 {
-                    for (size_t j = size_; j < i; ++j)
-                        data_[j].~T();
+                    new (&other.data_[i + size_]) T(std::move(other.data_[i]));
+                    other.data_[i].~T();
                 }
+                for (size_t i = 0; i < size_; ++i)
+                {
+                    new (&other.data_[i]) T(std::move(data_[i]));
+                    data_[i].~T();
+                }
+            }
 
-                throw;
+            std::swap(data_, other.data_);
+            std::swap(capacity_, other.capacity_);
+            size_ = newSize;
+            other.size_ = 0;
+            return;
+        }
+    }
+
+    if (newSize > capacity_) reserve(newSize);
+
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        copyTrivial(data_ + size_, other.data_, other.size_);
+    }
+    else if constexpr (std::is_nothrow_move_constructible_v<T>)
+    {
+        for (size_t i = 0; i < other.size_; ++i)
+            new (&data_[size_ + i]) T(std::move(other.data_[i]));
+    }
+    else
+    {
+        size_t i = 0;
+        try
+        {
+            for (; i < other.size_; ++i)
+                new (&data_[size_ + i]) T(std::move(other.data_[i]));
+        }
+        catch (...)
+        {
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                for (size_t j = 0; j < i; ++j)
+                    data_[size_ + j].~T();
             }
+
+            throw;
         }
-        size_ = newSize;
     }
+
+    size_ = newSize;
+    other.clear();
 }
 
 template<typename T>
@@ -789,11 +1397,7 @@ bool XVector<T>::empty() const noexcept
 template<typename T>
 void XVector<T>::clear() noexcept 
 {
-    if constexpr (!std::is_trivially_destructible_v<T>)
-    {
-        for (size_t i = 0; i < size_; i++)
-            data_[i].~T();
-    }
+    destroy(data_, size_);
     size_ = 0;
 }
 
@@ -802,6 +1406,7 @@ void XVector<T>::swap(XVector<T>& other) noexcept {
     std::swap(data_, other.data_);
     std::swap(size_, other.size_);
     std::swap(capacity_, other.capacity_);
+    std::swap(streamMode_, other.streamMode_);
 }
 
 template<typename T>
@@ -814,7 +1419,7 @@ void XVector<T>::reserve(size_t space)
         
         if constexpr (std::is_trivially_copyable_v<T>)
         {
-            std::memcpy(newData, data_, size_ * sizeof(T));
+            copyTrivial(newData, data_, size_);
         }
         else if constexpr (std::is_nothrow_move_constructible_v<T>)
         {
@@ -857,6 +1462,19 @@ void XVector<T>::reserve(size_t space)
 
 template<typename T>
 void XVector<T>::resize(size_t newSize, const T& value)
+{
+    resize(detail::Exec::automatic, newSize, value);
+}
+
+template<typename T>
+template<typename ExecutionPolicy, typename>
+void XVector<T>::resize(ExecutionPolicy&&, size_t newSize, const T& value)
+{
+    resize(std::decay_t<ExecutionPolicy>::mode, newSize, value);
+}
+
+template<typename T>
+void XVector<T>::resize(detail::Exec mode, size_t newSize, const T& value)
 {
     if (newSize > size_)
     {
@@ -865,9 +1483,19 @@ void XVector<T>::resize(size_t newSize, const T& value)
             const size_t newCap = nextPowerOf2(newSize);
             T* newData = static_cast<T*>(::operator new(newCap * sizeof(T)));
 
+            // fill first, value may refer to one of the elements that are about to move
+            try
+            {
+                uninitFill(newData + size_, newSize - size_, value, mode);
+            }
+            catch (...)
+            {
+                ::operator delete(newData);
+                throw;
+            }
+
             if constexpr (std::is_trivially_copyable_v<T>) {
-                std::memcpy(newData, data_, size_ * sizeof(T)); // copy existing elements
-                fillTrivial(newData + size_, newSize - size_, value);
+                copyTrivial(newData, data_, size_, mode); // copy existing elements
             }
             else if constexpr (std::is_nothrow_move_constructible_v<T>)
             {
@@ -888,31 +1516,7 @@ void XVector<T>::resize(size_t newSize, const T& value)
                     {
                         for (size_t j = 0; j < i; ++j)
                             newData[j].~T();
-                    }
-
-                    ::operator delete(newData);
-                    throw;
-                }
-            }
-
-            if constexpr (std::is_nothrow_copy_constructible_v<T>)
-            {
-                for (size_t i = size_; i < newSize; ++i)
-                    new (&newData[i]) T(value);
-            }
-            else
-            {
-                size_t i = size_;
-                try
-                {
-                    for (; i < newSize; ++i)
-                        new (&newData[i]) T(value);
-                }
-                catch (...)
-                {
-                    if constexpr (!std::is_trivially_destructible_v<T>)
-                    {
-                        for (size_t j = 0; j < i; ++j)
+                        for (size_t j = size_; j < newSize; ++j)
                             newData[j].~T();
                     }
 
@@ -934,55 +1538,82 @@ void XVector<T>::resize(size_t newSize, const T& value)
         }
         else
         {
-            if constexpr (std::is_trivially_copyable_v<T>) {
-                const size_t grow = newSize - size_;
-                if (grow > 0) {
-                    std::memcpy(data_ + size_, &value, sizeof(T));
-                    size_t filled = 1;
-                    while (filled < grow) {
-                        const size_t chunk = std::min(filled, grow - filled);
-                        std::memcpy(data_ + size_ + filled, data_ + size_, chunk * sizeof(T));
-                        filled += chunk;
-                    }
-                }
-            } 
-            else if constexpr (std::is_nothrow_copy_constructible_v<T>) // compile-time check if T has a noexcept copy constructor
-            {
-                for (size_t i = size_; i < newSize; ++i)
-                    new (&data_[i]) T(value);
-            }
-            else
-            {
-                size_t i = size_;
-                try
-                {
-                    for (; i < newSize; ++i)
-                        new (&data_[i]) T(value);
-                }
-                catch (...)
-                {
-                    if constexpr (!std::is_trivially_destructible_v<T>)
-                    {
-                        for (size_t j = size_; j < i; ++j)
-                            data_[j].~T();
-                    }
-
-                    throw;
-                }
-            }
+            uninitFill(data_ + size_, newSize - size_, value, mode); // SIMD fill for trivially copyable types
         }
     }
     else if (newSize < size_)
     {
-        if constexpr (!std::is_trivially_destructible_v<T>)
+        destroy(data_ + newSize, size_ - newSize);
+    }
+    size_ = newSize;
+}
+
+template<typename T>
+void XVector<T>::assign(size_t count, const T& value)
+{
+    assign(detail::Exec::automatic, count, value);
+}
+
+template<typename T>
+template<typename ExecutionPolicy, typename>
+void XVector<T>::assign(ExecutionPolicy&&, size_t count, const T& value)
+{
+    assign(std::decay_t<ExecutionPolicy>::mode, count, value);
+}
+
+template<typename T>
+void XVector<T>::assign(detail::Exec mode, size_t count, const T& value)
+{
+    if (count > capacity_)
+    {
+        XVector<T> tmp(mode, count, value); // old contents are discarded, so there is nothing to move
+        tmp.streamMode_ = streamMode_;
+        swap(tmp);
+    }
+    else if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        const T copy = value; // value may live in the range being overwritten
+        uninitFill(data_, count, copy, mode); // overwriting trivially copyable elements needs no destruction
+        size_ = count;
+    }
+    else
+    {
+        const size_t common = std::min(size_, count);
+        auto assignRange = [this](const T& src, size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i)
+                data_[i] = src;
+        };
+        if (detail::runsParallel<T>(common, mode))
         {
-            for (size_t i = newSize; i < size_; i++)
-                data_[i].~T();
+            // value may be one of the elements the other threads are assigning to
+            const T copy = value;
+            detail::parallelChunks(common, detail::parallelMinChunk<T>(), [&](size_t first, size_t last) {
+                assignRange(copy, first, last);
+            });
+        }
+        else
+        {
+            assignRange(value, 0, common);
+        }
+
+        if (count > size_)
+        {
+            uninitFill(data_ + size_, count - size_, value, mode);
+        }
+        else
+        {
+            destroy(data_ + count, size_ - count);
         }
+        size_ = count;
     }
-    size_ = newSize;
 }
 
+template<typename T>
+void XVector<T>::set_stream_mode(StreamMode mode) noexcept { streamMode_ = mode; }
+
+template<typename T>
+StreamMode XVector<T>::stream_mode() const noexcept { return streamMode_; }
+
 template <typename T>
 void XVector<T>::shrink_to_fit()
 {
@@ -998,6 +1629,360 @@ void XVector<T>::emplace_back(Args&&... args)
     ++size_;
 }
 
+template<typename T>
+void XVector<T>::unchecked_push_back(const T& item) { unchecked_emplace_back(item); }
+
+template<typename T>
+void XVector<T>::unchecked_push_back(T&& item) { unchecked_emplace_back(std::move(item)); }
+
+template<typename T>
+template<typename... Args>
+void XVector<T>::unchecked_emplace_back(Args&&... args)
+{
+    XVECTOR_ASSERT(size_ < capacity_, "Unchecked append past capacity");
+    new (&data_[size_]) T(std::forward<Args>(args)...);
+    ++size_;
+}
+
+// reserves room for count more elements before handing out the writer
+template<typename T>
+typename XVector<T>::BackWriter XVector<T>::back_writer(size_t count)
+{
+    if (count) reserve(size_ + count);
+    return BackWriter(*this);
+}
+
+template<typename T>
+T* XVector<T>::insert(const T* pos, const T& value)
+{
+    return insert(pos, 1, value);
+}
+
+template<typename T>
+T* XVector<T>::insert(const T* pos, T&& value)
+{
+    const size_t idx = pos - data_;
+    if (&value >= data_ && &value < data_ + size_) // value would be shifted along with the tail
+    {
+        T tmp(std::move(value));
+        return insertGap(idx, 1, [&tmp](T* dest) { new (dest) T(std::move(tmp)); });
+    }
+    return insertGap(idx, 1, [&value](T* dest) { new (dest) T(std::move(value)); });
+}
+
+template<typename T>
+T* XVector<T>::insert(const T* pos, size_t count, const T& value)
+{
+    const size_t idx = pos - data_;
+    if (&value >= data_ && &value < data_ + size_)
+    {
+        const T tmp(value);
+        return insertGap(idx, count, [&tmp, count](T* dest) { uninitFill(dest, count, tmp); });
+    }
+    return insertGap(idx, count, [&value, count](T* dest) { uninitFill(dest, count, value); });
+}
+
+template<typename T>
+template<typename InputIt, typename>
+T* XVector<T>::insert(const T* pos, InputIt first, InputIt last)
+{
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
+    const size_t idx = pos - data_;
+
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>)
+    {
+        // multi-pass iterators can pre-calculate size, so there is at most one reallocation
+        const size_t count = static_cast<size_t>(std::distance(first, last));
+        return insertGap(idx, count, [&first, count](T* dest) { uninitCopy(dest, first, count); });
+    }
+    else
+    {
+        // single pass, so append and rotate the new elements into place
+        const size_t oldSize = size_;
+        try
+        {
+            for (; first != last; ++first)
+                emplace_back(*first);
+        }
+        catch (...)
+        {
+            while (size_ > oldSize) pop_back();
+            throw;
+        }
+        std::rotate(data_ + idx, data_ + oldSize, data_ + size_);
+        return data_ + idx;
+    }
+}
+
+template<typename T>
+T* XVector<T>::insert(const T* pos, std::initializer_list<T> init)
+{
+    return insert(pos, init.begin(), init.end());
+}
+
+template<typename T>
+template<typename... Args>
+T* XVector<T>::emplace(const T* pos, Args&&... args)
+{
+    const size_t idx = pos - data_;
+    if (idx == size_)
+    {
+        emplace_back(std::forward<Args>(args)...);
+        return data_ + idx;
+    }
+
+    T tmp(std::forward<Args>(args)...); // args may refer to an element that is about to move
+    return insertGap(idx, 1, [&tmp](T* dest) { new (dest) T(std::move(tmp)); });
+}
+
+template<typename T>
+T* XVector<T>::erase(const T* pos)
+{
+    return erase(pos, pos + 1);
+}
+
+template<typename T>
+T* XVector<T>::erase(const T* first, const T* last)
+{
+    const size_t idx = first - data_;
+    const size_t count = last - first;
+    if (count == 0) return data_ + idx;
+
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        std::memmove(data_ + idx, data_ + idx + count, (size_ - idx - count) * sizeof(T));
+    }
+    else
+    {
+        std::move(data_ + idx + count, data_ + size_, data_ + idx);
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for (size_t i = size_ - count; i < size_; ++i)
+                data_[i].~T();
+        }
+    }
+
+    size_ -= count;
+    return data_ + idx;
+}
+
+// O(1) erase that moves the last element into the gap instead of shifting everything after pos,
+// so the order of the remaining elements is not kept. returns pos, now holding the old last element.
+template<typename T>
+T* XVector<T>::unordered_erase(const T* pos)
+{
+    XVECTOR_ASSERT(pos >= data_ && pos < data_ + size_, "Index out of bounds");
+    const size_t idx = pos - data_;
+    if (idx != size_ - 1) data_[idx] = std::move(data_[size_ - 1]);
+    pop_back();
+    return data_ + idx;
+}
+
+// BatchInserter is an output iterator for STL algorithms writing into an XVector. instead of a
+// capacity check and size update per element like std::back_inserter, it reserves chunk elements
+// at a time, writes through a raw pointer and publishes the new size when it runs out of room or
+// is destroyed. algorithms copy output iterators around, so a copy that another one has written
+// past or reallocated under is stale: it leaves size_ alone and, like std::back_inserter, carries
+// on from the current end when it is written through again.
+template<typename T>
+class BatchInserter
+{
+private:
+    // member variables
+    XVector<T>* vec_;
+    T* base_;   // vec_->data_ when pos_ and limit_ were computed
+    T* pos_;
+    T* limit_;
+    size_t chunk_;
+
+    // private methods
+    void commit() noexcept;
+    void resync() noexcept;
+    void refill();
+
+public:
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    BatchInserter(XVector<T>& vec, size_t chunk) noexcept
+        : vec_(&vec), base_(vec.data_), pos_(vec.data_ + vec.size_), limit_(vec.data_ + vec.capacity_),
+          chunk_(chunk ? chunk : 1) {}
+    BatchInserter(const BatchInserter&) = default;
+    BatchInserter& operator=(const BatchInserter&) = default;
+    ~BatchInserter() { commit(); }
+
+    BatchInserter& operator=(const T&);
+    BatchInserter& operator=(T&&);
+    BatchInserter& operator*() noexcept { return *this; }
+    BatchInserter& operator++() noexcept { return *this; }
+    BatchInserter& operator++(int) noexcept { return *this; }
+};
+
+template<typename T>
+void BatchInserter<T>::commit() noexcept
+{
+    if (base_ != vec_->data_) return; // a copy has reallocated since, this one is stale
+    const size_t written = pos_ - base_;
+    if (written > vec_->size_) vec_->size_ = written;
+}
+
+// picks up from the end of the vector when another copy has reallocated it or committed past pos_
+template<typename T>
+void BatchInserter<T>::resync() noexcept
+{
+    if (base_ == vec_->data_ && static_cast<size_t>(pos_ - base_) >= vec_->size_) return;
+    base_ = vec_->data_;
+    pos_ = base_ + vec_->size_;
+    limit_ = base_ + vec_->capacity_;
+}
+
+template<typename T>
+void BatchInserter<T>::refill()
+{
+    commit();
+    vec_->reserve(vec_->size_ + chunk_);
+    base_ = vec_->data_;
+    pos_ = base_ + vec_->size_;
+    limit_ = base_ + vec_->capacity_;
+}
+
+template<typename T>
+BatchInserter<T>& BatchInserter<T>::operator=(const T& item)
+{
+    resync();
+    if (pos_ == limit_) refill();
+    new (pos_) T(item);
+    ++pos_;
+    return *this;
+}
+
+template<typename T>
+BatchInserter<T>& BatchInserter<T>::operator=(T&& item)
+{
+    resync();
+    if (pos_ == limit_) refill();
+    new (pos_) T(std::move(item));
+    ++pos_;
+    return *this;
+}
+
+// chunk defaults to roughly 64KB worth of elements
+template<typename T>
+BatchInserter<T> batch_inserter(XVector<T>& vec, size_t chunk = (size_t(1) << 16) / sizeof(T))
+{
+    return BatchInserter<T>(vec, chunk);
+}
+
+// moves the elements of count parts into one vector, in order. the part with the largest buffer
+// is the result when that buffer has room for everything: the parts before it are moved in front
+// of its elements with a single shift and the parts after it are appended.
+template<typename T>
+XVector<T> XVector<T>::joinParts(XVector<T>* const* parts, size_t count)
+{
+    size_t total = 0;
+    size_t largest = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        total += parts[i]->size_;
+        if (parts[i]->capacity_ > parts[largest]->capacity_) largest = i;
+    }
+
+    XVector<T> result(std::move(*parts[largest]));
+    if (result.capacity_ < total) result.reserve(total);
+
+    size_t front = 0;
+    for (size_t i = 0; i < largest; ++i)
+        front += parts[i]->size_;
+    result.insertGap(0, front, [&](T* dest) {
+        size_t done = 0;
+        try
+        {
+            for (size_t i = 0; i < largest; ++i)
+            {
+                for (size_t j = 0; j < parts[i]->size_; ++j, ++done)
+                    new (&dest[done]) T(std::move(parts[i]->data_[j]));
+            }
+        }
+        catch (...)
+        {
+            destroy(dest, done);
+            throw;
+        }
+    });
+    for (size_t i = 0; i < largest; ++i)
+        parts[i]->clear();
+
+    for (size_t i = largest + 1; i < count; ++i)
+        result.concatenate(std::move(*parts[i]));
+    return result;
+}
+
+// joins rvalue vectors into one, moving every element and allocating at most once.
+// when one of the pieces already has room for everything, its buffer is adopted instead.
+template<typename T, typename... Rest>
+XVector<T> join(XVector<T>&& first, Rest&&... rest)
+{
+    static_assert((std::is_same_v<Rest, XVector<T>> && ...), "join expects rvalue XVectors of the same type");
+
+    XVector<T>* const parts[] = {&first, &rest...};
+    return XVector<T>::joinParts(parts, 1 + sizeof...(Rest));
+}
+
+template<typename T>
+XVector<T> join(XVector<XVector<T>>&& parts)
+{
+    XVector<XVector<T>*> pointers;
+    pointers.reserve(parts.size());
+    for (XVector<T>& part : parts)
+        pointers.push_back(&part);
+
+    XVector<T> result = pointers.empty() ? XVector<T>() : XVector<T>::joinParts(pointers.data(), pointers.size());
+    parts.clear();
+    return result;
+}
+
+// operator== with an execution policy. under par the chunks are compared on the pool,
+// and each one gives up early once another has found a difference.
+template<typename ExecutionPolicy, typename T, typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+bool equal(ExecutionPolicy&&, const XVector<T>& left, const XVector<T>& right)
+{
+    constexpr detail::Exec mode = std::decay_t<ExecutionPolicy>::mode;
+    const size_t count = left.size();
+    if (count != right.size()) return false;
+    if (!detail::runsParallel<T>(count, mode)) return left == right;
+
+    const T* a = left.data();
+    const T* b = right.data();
+    std::atomic<bool> differs{false};
+    detail::parallelChunks(count, detail::parallelMinChunk<T>(), [&](size_t first, size_t last) {
+        // compared in blocks so a difference found elsewhere stops this chunk soon
+        constexpr size_t block = detail::parallelMinChunk<T>();
+        for (size_t i = first; i < last && !differs.load(std::memory_order_relaxed); i += block)
+        {
+            const size_t end = std::min(last, i + block);
+            bool same = true;
+            if constexpr (std::has_unique_object_representations_v<T>)
+            {
+                same = std::memcmp(a + i, b + i, (end - i) * sizeof(T)) == 0;
+            }
+            else if constexpr (simd::searchable_v<T>)
+            {
+                same = simd::mismatch(a + i, b + i, end - i) == end - i;
+            }
+            else
+            {
+                for (size_t j = i; j < end && same; ++j)
+                    same = a[j] == b[j];
+            }
+            if (!same) differs.store(true, std::memory_order_relaxed);
+        }
+    });
+    return !differs.load();
+}
+
 } // namespace xvc
 
 #endif // X_VECTOR_H
\ No newline at end of file
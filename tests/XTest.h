@@ -0,0 +1,28 @@
+#ifndef X_TEST_H
+#define X_TEST_H
+
+#include <cstdio> // std::printf
+
+// the tests keep going after a failed CHECK and main returns the number of failures, so ctest
+// reports every broken expectation of a run, not just the first
+inline int xtestFailures = 0;
+
+#define CHECK(condition)                                                          \
+    do                                                                            \
+    {                                                                             \
+        if (!(condition))                                                         \
+        {                                                                         \
+            ++xtestFailures;                                                      \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+        }                                                                         \
+    } while (0)
+
+#define CHECK_THROWS(expression, exception)                                       \
+    do                                                                            \
+    {                                                                             \
+        bool xtestThrew = false;                                                  \
+        try { (void)(expression); } catch (const exception&) { xtestThrew = true; } \
+        CHECK(xtestThrew);                                                        \
+    } while (0)
+
+#endif // X_TEST_H
@@ -0,0 +1,41 @@
+#include <xvc/XConcat.h>
+#include "XTest.h"
+
+#include <stdint.h> // SIZE_MAX
+#include <cstdlib>  // std::malloc, std::free
+#include <new>      // std::bad_alloc
+#include <string>   // std::string
+
+using xvc::XVector;
+
+// every allocation of the test is counted, to see that a concatenation allocates once
+static size_t allocations = 0;
+
+void* operator new(size_t bytes)
+{
+    ++allocations;
+    if (void* p = std::malloc(bytes ? bytes : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+void testSingleAllocation()
+{
+    const XVector<int> a(100, 1), b(50, 2);
+    allocations = 0;
+    const XVector<int> c = a + b + a;
+    CHECK(allocations == 1);
+    CHECK(c.size() == 250 && c[99] == 1 && c[100] == 2 && c[150] == 1);
+
+    const XVector<std::string> s(3, "s"), t(2, "t");
+    const XVector<std::string> u = xvc::concat(s, t);
+    CHECK(u.size() == 5 && u[2] == "s" && u[3] == "t");
+}
+
+int main()
+{
+    CHECK(xvc::concat_parallel_threshold == SIZE_MAX); // parallel copies are opt-in
+    testSingleAllocation();
+    return xtestFailures;
+}
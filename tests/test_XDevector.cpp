@@ -0,0 +1,196 @@
+#include <xvc/XDevector.h>
+#include "XTest.h"
+
+#include <stdint.h>  // uint64_t
+#include <algorithm> // std::equal, std::min
+#include <iterator>  // std::istream_iterator
+#include <sstream>   // std::istringstream
+#include <string>    // std::string, std::to_string
+#include <vector>    // std::vector
+
+using xvc::XDevector;
+
+// a type whose move may throw, so XDevector cannot slide it in place
+struct ThrowingMove
+{
+    int value;
+    ThrowingMove(int v) : value(v) {}
+    ThrowingMove(const ThrowingMove& other) : value(other.value) {}
+    ThrowingMove(ThrowingMove&& other) noexcept(false) : value(other.value) {}
+    ThrowingMove& operator=(const ThrowingMove&) = default;
+    bool operator==(const ThrowingMove& other) const { return value == other.value; }
+};
+
+// a window of a few elements sliding a long way in either direction keeps a small buffer
+template<typename T, typename Make>
+void testSlidingWindow(Make make)
+{
+    constexpr size_t window = 4;
+    constexpr size_t steps = 100000;
+
+    XDevector<T> back;
+    for (size_t i = 0; i < window; ++i) back.push_back(make(i));
+    for (size_t i = window; i < steps; ++i)
+    {
+        back.push_back(make(i));
+        back.pop_front();
+        CHECK(back.capacity() <= 4 * window);
+    }
+    CHECK(back.size() == window);
+    for (size_t i = 0; i < window; ++i)
+        CHECK(back[i] == make(steps - window + i));
+
+    XDevector<T> front;
+    for (size_t i = 0; i < window; ++i) front.push_front(make(i));
+    for (size_t i = window; i < steps; ++i)
+    {
+        front.push_front(make(i));
+        front.pop_back();
+        CHECK(front.capacity() <= 4 * window);
+    }
+    CHECK(front.size() == window);
+    for (size_t i = 0; i < window; ++i)
+        CHECK(front[i] == make(steps - 1 - i));
+}
+
+// pushing an element of the devector itself when it has to make room
+template<typename T, typename Make>
+void testPushOwnElement(Make make)
+{
+    XDevector<T> d;
+    for (size_t i = 0; i < 8; ++i) d.push_back(make(i));
+    for (size_t i = 0; i < 6; ++i) d.pop_front();
+    while (d.back_capacity() > d.size()) d.push_back(make(0));
+    const T first = d.front();
+    d.push_back(d.front());
+    CHECK(d.back() == first);
+
+    while (d.front_capacity() > d.size()) d.push_front(make(1));
+    while (d.size() > 2) d.pop_back();
+    const T last = d.back();
+    d.push_front(d.back());
+    CHECK(d.front() == last);
+}
+
+// growing with resize from one of the devector's own elements, at full capacity and with the
+// spare room at the front, where the elements slide before the new ones are built
+template<typename T, typename Make>
+void testResizeOwnElement(Make make)
+{
+    XDevector<T> d;
+    for (size_t i = 0; i < 8; ++i) d.push_back(make(i));
+    CHECK(d.size() == d.capacity());
+    d.resize(d.size() * 2, d[0]);
+    CHECK(d.size() == 16);
+    for (size_t i = 0; i < 16; ++i)
+        CHECK(d[i] == make(i < 8 ? i : 0));
+
+    XDevector<T> f;
+    for (size_t i = 0; i < 8; ++i) f.push_front(make(i));
+    while (f.back_capacity() > f.size()) f.push_back(make(100));
+    f.erase(f.begin(), f.begin() + 2);
+    const T copy = f[1];
+    f.resize(f.size() + 2, f[1]);
+    CHECK(f[f.size() - 1] == copy);
+    CHECK(f[f.size() - 2] == copy);
+}
+
+// insert, emplace and erase at the front, the middle and the back against std::vector
+template<typename T, typename Make>
+void testInsertErase(Make make)
+{
+    XDevector<T> d;
+    std::vector<T> ref;
+    uint64_t state = 42;
+    auto next = [&state](size_t bound) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<size_t>(state >> 33) % bound;
+    };
+
+    for (size_t step = 0; step < 3000; ++step)
+    {
+        const size_t at = next(d.size() + 1);
+        const T value = make(step);
+        switch (next(8))
+        {
+            case 0:
+                d.insert(d.begin() + at, value);
+                ref.insert(ref.begin() + at, value);
+                break;
+            case 1:
+            {
+                const size_t count = next(5);
+                d.insert(d.begin() + at, count, value);
+                ref.insert(ref.begin() + at, count, value);
+                break;
+            }
+            case 2:
+            {
+                const T items[] = { make(step), make(step + 1), make(step + 2) };
+                d.insert(d.begin() + at, items, items + 3);
+                ref.insert(ref.begin() + at, items, items + 3);
+                break;
+            }
+            case 3:
+                if (!d.empty())
+                {
+                    const size_t from = next(d.size());
+                    d.insert(d.begin() + at, d[from]); // an element of the devector itself
+                    ref.insert(ref.begin() + at, T(ref[from]));
+                }
+                break;
+            case 4:
+                d.emplace(d.begin() + at, value);
+                ref.emplace(ref.begin() + at, value);
+                break;
+            case 5:
+            case 6:
+                if (at < d.size())
+                {
+                    const size_t last = at + next(std::min<size_t>(d.size() - at, 4) + 1);
+                    CHECK(d.erase(d.begin() + at, d.begin() + last) == d.begin() + at);
+                    ref.erase(ref.begin() + at, ref.begin() + last);
+                }
+                break;
+            default:
+                if (next(2)) { d.push_front(value); ref.insert(ref.begin(), value); }
+                else { d.push_back(value); ref.push_back(value); }
+                break;
+        }
+
+        CHECK(d.size() == ref.size());
+        CHECK(std::equal(d.begin(), d.end(), ref.begin(), ref.end()));
+        if (d.size() > 200)
+        {
+            d.erase(d.begin() + 10, d.end() - 10);
+            ref.erase(ref.begin() + 10, ref.end() - 10);
+        }
+    }
+
+    // single-pass input iterators append and rotate into place
+    std::istringstream in("7 8 9");
+    XDevector<int> ints = { 1, 2, 3 };
+    ints.insert(ints.begin() + 1, std::istream_iterator<int>(in), std::istream_iterator<int>());
+    CHECK(ints == XDevector<int>({ 1, 7, 8, 9, 2, 3 }));
+}
+
+int main()
+{
+    auto makeInt = [](size_t i) { return static_cast<int>(i); };
+    auto makeString = [](size_t i) { return std::string(24, 's') + std::to_string(i); };
+    auto makeThrowing = [](size_t i) { return ThrowingMove(static_cast<int>(i)); };
+
+    testSlidingWindow<int>(makeInt);
+    testSlidingWindow<std::string>(makeString);
+    testSlidingWindow<ThrowingMove>(makeThrowing);
+    testPushOwnElement<int>(makeInt);
+    testPushOwnElement<std::string>(makeString);
+    testPushOwnElement<ThrowingMove>(makeThrowing);
+    testResizeOwnElement<int>(makeInt);
+    testResizeOwnElement<std::string>(makeString);
+    testResizeOwnElement<ThrowingMove>(makeThrowing);
+    testInsertErase<int>(makeInt);
+    testInsertErase<std::string>(makeString);
+    testInsertErase<ThrowingMove>(makeThrowing);
+    return xtestFailures;
+}
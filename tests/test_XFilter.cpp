@@ -0,0 +1,247 @@
+#include <xvc/XFilter.h>
+#include "XTest.h"
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t, uint64_t
+#include <algorithm> // std::remove_if
+#include <stdexcept> // std::length_error
+#include <string>    // std::string, std::to_string
+#include <vector>    // std::vector
+
+using xvc::XVector;
+
+// keep masks for a block: none, all, alternating, the first and the last element, runs, and
+// pseudo-random ones
+std::vector<uint64_t> keepMasks()
+{
+    std::vector<uint64_t> masks = { 0, ~uint64_t(0), 0x5555555555555555ull, 0xaaaaaaaaaaaaaaaaull, 1, uint64_t(1) << 63,
+                                    0x00ff00ff00ff00ffull, 0xfffffffffffffffeull, 0x7fffffffffffffffull };
+    uint64_t state = 1;
+    for (int i = 0; i < 8; ++i)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        masks.push_back(state ^ (state >> 29));
+    }
+    return masks;
+}
+
+// a kernel keeps exactly the selected elements, in order, for every block length and mask, with
+// dest at src, before it and apart from it, and writes nothing past the block
+template<typename T, typename Kernel>
+void testKernel(Kernel kernel)
+{
+    constexpr size_t slack = 3;
+    const T guard = T(99);
+    for (size_t n = 0; n <= 64; ++n)
+    {
+        for (uint64_t mask : keepMasks())
+        {
+            const uint64_t keep = xvc::detail::lowBits(n) & (n ? mask : 0);
+            std::vector<T> expected;
+            for (size_t j = 0; j < n; ++j)
+                if ((keep >> j) & 1) expected.push_back(T(j + 1));
+
+            for (size_t shift : { size_t(0), size_t(1), slack })
+            {
+                T buffer[slack + 64 + 1];
+                T* src = buffer + slack;
+                for (size_t j = 0; j < n; ++j) src[j] = T(j + 1);
+                src[n] = guard;
+
+                T* dest = src - shift;
+                const size_t kept = kernel(src, dest, n, keep);
+                bool ok = kept == expected.size() && src[n] == guard;
+                for (size_t j = 0; ok && j < kept; ++j) ok = dest[j] == expected[j];
+                CHECK(ok);
+            }
+
+            // a separate destination
+            T src[64], dest[65];
+            for (size_t j = 0; j < n; ++j) src[j] = T(j + 1);
+            dest[n] = guard;
+            const size_t kept = kernel(src, dest, n, keep);
+            bool ok = kept == expected.size() && dest[n] == guard;
+            for (size_t j = 0; ok && j < kept; ++j) ok = dest[j] == expected[j];
+            CHECK(ok);
+        }
+    }
+}
+
+// every kernel that takes T and that the CPU runs
+template<typename T>
+void testKernels()
+{
+    using namespace xvc::simd;
+    testKernel<T>(compressScalar<T>);
+#if XVECTOR_SIMD_X86
+    const Isa isa = detectIsa();
+    if constexpr (sizeof(T) >= 4)
+    {
+        if (isa >= Isa::avx2) testKernel<T>(compressAvx2<T>);
+        if (isa >= Isa::avx512) testKernel<T>(compressAvx512<T>);
+    }
+    else
+    {
+        if (isa >= Isa::avx512 && hasVbmi2()) testKernel<T>(compressAvx512Vbmi2<T>);
+    }
+
+    // the kernel that is picked
+    const CompressKernel<T> picked = compressKernel<T>();
+    if constexpr (sizeof(T) >= 4)
+        CHECK(picked == (isa == Isa::avx512 ? compressAvx512<T> : isa == Isa::avx2 ? compressAvx2<T> : compressScalar<T>));
+    else
+        CHECK(picked == (isa == Isa::avx512 && hasVbmi2() ? compressAvx512Vbmi2<T> : compressScalar<T>));
+#endif
+}
+
+// erase_if, erase and both filters against std::remove_if, across block boundaries and with
+// leading blocks that keep everything
+template<typename T>
+void testFilters()
+{
+    for (size_t n : { size_t(0), size_t(1), size_t(63), size_t(64), size_t(65), size_t(130), size_t(1000) })
+    {
+        for (size_t period : { size_t(1), size_t(2), size_t(7), size_t(100), size_t(5000) })
+        {
+            XVector<T> vec;
+            for (size_t i = 0; i < n; ++i) vec.push_back(T(i % period == period - 1 ? 0 : i % 50 + 1));
+            auto isZero = [](const T& x) { return x == T(0); };
+
+            std::vector<T> expected(vec.begin(), vec.end());
+            expected.erase(std::remove_if(expected.begin(), expected.end(), isZero), expected.end());
+            auto same = [&expected](const XVector<T>& v) { return std::vector<T>(v.begin(), v.end()) == expected; };
+
+            size_t calls = 0;
+            size_t next = 0;
+            bool inOrder = true;
+            XVector<T> erased = vec;
+            const T* first = erased.data();
+            const size_t removed = xvc::erase_if(erased, [&](const T& x) {
+                inOrder &= &x == first + next++;
+                ++calls;
+                return isZero(x);
+            });
+            CHECK(same(erased) && removed == n - expected.size() && calls == n && inOrder);
+
+            XVector<T> byValue = vec;
+            CHECK(xvc::erase(byValue, T(0)) == n - expected.size() && same(byValue));
+
+            XVector<T> kept = vec;
+            CHECK(xvc::filter(kept, [](const T& x) { return x != T(0); }) == n - expected.size() && same(kept));
+
+            XVector<uint64_t> mask((n + 63) / 64, 0);
+            for (size_t i = 0; i < n; ++i) mask[i / 64] |= uint64_t(vec[i] != T(0)) << (i % 64);
+            XVector<T> masked = vec;
+            CHECK(xvc::filter(masked, mask) == n - expected.size() && same(masked));
+        }
+    }
+
+    // the value may be an element of the vector
+    XVector<T> vec = { T(3), T(1), T(3), T(2), T(3) };
+    CHECK(xvc::erase(vec, vec[0]) == 3 && vec == XVector<T>({ T(1), T(2) }));
+}
+
+// a mask needs a word for every started block of 64; the bits past size() are ignored
+void testMaskLength()
+{
+    XVector<int> vec(65, 1);
+    CHECK_THROWS(xvc::filter(vec, XVector<uint64_t>(1, ~uint64_t(0))), std::length_error);
+    CHECK(vec.size() == 65);
+
+    XVector<std::string> strings(65, std::string("s"));
+    CHECK_THROWS(xvc::filter(strings, XVector<uint64_t>(1, ~uint64_t(0))), std::length_error);
+    CHECK(xvc::filter(strings, XVector<uint64_t>{ ~uint64_t(0), 0, 7 }) == 1 && strings.size() == 64);
+
+    XVector<int> empty;
+    CHECK(xvc::filter(empty, XVector<uint64_t>()) == 0);
+    CHECK(xvc::filter(vec, XVector<uint64_t>{ 0, ~uint64_t(0) }) == 64 && vec.size() == 1);
+}
+
+// a trivially copyable record that the SIMD kernels do not take
+struct Pair
+{
+    int key;
+    int value;
+};
+
+// types outside the kernels go through compactRuns, as one memmove per run or an element move
+void testCompactRuns()
+{
+    for (size_t n : { size_t(0), size_t(1), size_t(10), size_t(100) })
+    {
+        for (size_t period : { size_t(1), size_t(2), size_t(3), size_t(50) })
+        {
+            XVector<std::string> strings;
+            XVector<Pair> pairs;
+            std::vector<std::string> expected;
+            for (size_t i = 0; i < n; ++i)
+            {
+                strings.push_back(std::string(24, 'x') + std::to_string(i));
+                pairs.push_back({ static_cast<int>(i), static_cast<int>(i % period) });
+                if (i % period != 0) expected.push_back(strings.back());
+            }
+
+            size_t calls = 0;
+            XVector<std::string> erased = strings;
+            const size_t removed = xvc::erase_if(erased, [&](const std::string& s) {
+                ++calls;
+                return std::stoul(s.substr(24)) % period == 0;
+            });
+            CHECK(removed == n - expected.size() && calls == n && std::vector<std::string>(erased.begin(), erased.end()) == expected);
+
+            XVector<uint64_t> mask((n + 63) / 64, 0);
+            for (size_t i = 0; i < n; ++i) mask[i / 64] |= uint64_t(i % period != 0) << (i % 64);
+            XVector<std::string> masked = strings;
+            CHECK(xvc::filter(masked, mask) == n - expected.size() &&
+                  std::vector<std::string>(masked.begin(), masked.end()) == expected);
+
+            xvc::erase_if(pairs, [](const Pair& p) { return p.value == 0; });
+            bool ok = pairs.size() == expected.size();
+            for (size_t i = 0; ok && i < pairs.size(); ++i) ok = std::to_string(pairs[i].key) == expected[i].substr(24);
+            CHECK(ok);
+        }
+    }
+}
+
+// the last element is simply popped; anywhere else it moves into the gap
+void testUnorderedErase()
+{
+    XVector<std::string> vec = { "a", "b", "c", "d" };
+    std::string* at = vec.unordered_erase(vec.data() + 3);
+    CHECK(at == vec.data() + 3 && at == vec.end() && vec == XVector<std::string>({ "a", "b", "c" }));
+
+    at = vec.unordered_erase(vec.data());
+    CHECK(at == vec.data() && *at == "c" && vec == XVector<std::string>({ "c", "b" }));
+
+    vec.unordered_erase(vec.data() + 1);
+    at = vec.unordered_erase(vec.data());
+    CHECK(at == vec.end() && vec.empty());
+
+    XVector<int> ints = { 1, 2, 3 };
+    CHECK(ints.unordered_erase(ints.data() + 2) == ints.end() && ints == XVector<int>({ 1, 2 }));
+}
+
+template<typename T>
+void testType()
+{
+    testKernels<T>();
+    testFilters<T>();
+}
+
+int main()
+{
+    testType<int8_t>();
+    testType<uint8_t>();
+    testType<int16_t>();
+    testType<uint16_t>();
+    testType<int32_t>();
+    testType<uint32_t>();
+    testType<int64_t>();
+    testType<uint64_t>();
+    testType<float>();
+    testType<double>();
+    testMaskLength();
+    testCompactRuns();
+    testUnorderedErase();
+    return xtestFailures;
+}
@@ -0,0 +1,93 @@
+#include <xvc/XHash.h>
+#include "XTest.h"
+
+#include <stddef.h>      // size_t
+#include <stdint.h>      // uint64_t
+#include <cstring>       // std::strlen
+#include <functional>    // std::hash
+#include <unordered_set> // std::unordered_set
+
+using xvc::XVector;
+
+// the published wyhash final version 4 test vectors, the i-th message hashed with seed i and the
+// default secret. together they reach every path: empty, 1-3 bytes, 4-16 bytes, the 16-byte loop
+// and the three-lane 48-byte loop.
+void testReferenceVectors()
+{
+    struct Vector
+    {
+        const char* message;
+        uint64_t expected;
+    };
+    const Vector vectors[] = {
+        { "", 0x93228a4de0eec5a2ull },
+        { "a", 0xc5bac3db178713c4ull },
+        { "abc", 0xa97f2f7b1d9b3314ull },
+        { "message digest", 0x786d1f1df3801df4ull },
+        { "abcdefghijklmnopqrstuvwxyz", 0xdca5a8138ad37c87ull },
+        { "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789", 0xb9e734f117cfaf70ull },
+        { "12345678901234567890123456789012345678901234567890123456789012345678901234567890", 0x6cc5eab49a92d617ull },
+    };
+
+    uint64_t seed = 0;
+    for (const Vector& v : vectors)
+        CHECK(xvc::hash_bytes(v.message, std::strlen(v.message), seed++) == v.expected);
+}
+
+// flipping any single bit of the input changes the hash, and no two flips collide, at lengths on
+// both sides of every path boundary
+void testBitFlips()
+{
+    unsigned char buffer[200];
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+    for (unsigned char& byte : buffer)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        byte = static_cast<unsigned char>(state >> 56);
+    }
+
+    for (size_t length : { 1, 2, 3, 4, 7, 8, 15, 16, 17, 32, 33, 47, 48, 49, 96, 97, 200 })
+    {
+        std::unordered_set<uint64_t> seen;
+        seen.insert(xvc::hash_bytes(buffer, length));
+        for (size_t bit = 0; bit < 8 * length; ++bit)
+        {
+            buffer[bit / 8] ^= static_cast<unsigned char>(1u << (bit % 8));
+            CHECK(seen.insert(xvc::hash_bytes(buffer, length)).second);
+            buffer[bit / 8] ^= static_cast<unsigned char>(1u << (bit % 8));
+        }
+    }
+}
+
+// inputs that differ only in length, including runs of zero bytes, hash differently
+void testLengths()
+{
+    unsigned char zeros[300] = {};
+    std::unordered_set<uint64_t> seen;
+    for (size_t length = 0; length <= sizeof(zeros); ++length)
+        CHECK(seen.insert(xvc::hash_bytes(zeros, length)).second);
+
+    // and so do different seeds over the same bytes
+    CHECK(xvc::hash_bytes(zeros, 16, 1) != xvc::hash_bytes(zeros, 16, 2));
+}
+
+void testStdHash()
+{
+    // unique object representations hash the buffer
+    const XVector<int> ints = { 1, 2, 3 };
+    CHECK(std::hash<XVector<int>>{}(ints) == static_cast<size_t>(xvc::hash_bytes(ints.data(), 3 * sizeof(int))));
+
+    // floating point hashes per element, so values that compare equal hash equal
+    CHECK(std::hash<XVector<double>>{}(XVector<double>{ -0.0 }) == std::hash<XVector<double>>{}(XVector<double>{ 0.0 }));
+    CHECK(std::hash<XVector<double>>{}(XVector<double>{ 1.0, -0.0 }) == std::hash<XVector<double>>{}(XVector<double>{ 1.0, 0.0 }));
+    CHECK(std::hash<XVector<double>>{}(XVector<double>{ 0.0 }) != std::hash<XVector<double>>{}(XVector<double>{ 0.0, 0.0 }));
+}
+
+int main()
+{
+    testReferenceVectors();
+    testBitFlips();
+    testLengths();
+    testStdHash();
+    return xtestFailures;
+}
@@ -0,0 +1,385 @@
+#include <xvc/XParallel.h>
+#include "XTest.h"
+
+#include <stddef.h>    // size_t
+#include <algorithm>   // std::min, std::max
+#include <atomic>      // std::atomic
+#include <stdexcept>   // std::runtime_error, std::length_error
+#include <string>      // std::string, std::to_string
+#include <vector>      // std::vector
+
+using xvc::XVector;
+using xvc::ThreadPool;
+
+// a pool with workers, so the tasks really run concurrently even on a single core
+ThreadPool& workers()
+{
+    static ThreadPool pool(3);
+    return pool;
+}
+
+// an element that counts its live instances, to find leaks and double destruction
+struct Counted
+{
+    static inline std::atomic<long> live{0};
+    std::string payload;
+
+    explicit Counted(int i) : payload(std::string(24, 'c') + std::to_string(i)) { ++live; }
+    Counted(const Counted& other) : payload(other.payload) { ++live; }
+    ~Counted() { --live; }
+};
+
+// the tasks of a partition cover [0, count) in order without gaps or overlap, task 0 takes the
+// lead elements in front of the first cache line boundary of base and every later task starts on one
+template<typename T>
+void checkPartition(const T* base, size_t count, size_t grain, size_t concurrency)
+{
+    const xvc::detail::Partition part = xvc::detail::alignedPartition(base, count, grain, concurrency);
+    const size_t offset = reinterpret_cast<size_t>(base) % 64;
+    const size_t lead = 64 % sizeof(T) == 0 && offset % sizeof(T) == 0 ? (64 - offset) % 64 / sizeof(T) : 0;
+    size_t expectedGrain = grain ? grain : std::max<size_t>(1, count / (4 * concurrency));
+    if (64 % sizeof(T) == 0) expectedGrain = (expectedGrain + 64 / sizeof(T) - 1) / (64 / sizeof(T)) * (64 / sizeof(T));
+
+    CHECK(part.first(0) == 0 && part.last(0) == std::min(count, lead + expectedGrain));
+    bool ok = part.last(part.tasks - 1) == count;
+    for (size_t task = 1; task < part.tasks; ++task)
+    {
+        ok &= part.first(task) == part.last(task - 1) && part.first(task) < part.last(task);
+        ok &= part.last(task) - part.first(task) <= expectedGrain;
+        if (64 % sizeof(T) == 0 && offset % sizeof(T) == 0) ok &= reinterpret_cast<size_t>(base + part.first(task)) % 64 == 0;
+    }
+    CHECK(ok);
+}
+
+struct Triple
+{
+    int a, b, c;
+};
+
+void testAlignedPartition()
+{
+    alignas(64) static int ints[5000];
+    alignas(64) static Triple triples[1000];
+    for (size_t offset = 0; offset < 16; ++offset)
+    {
+        for (size_t count : { 0, 1, 15, 16, 17, 100, 1000, 4000 })
+        {
+            for (size_t grain : { 0, 1, 7, 16, 100 })
+            {
+                checkPartition(ints + offset, count, grain, 1);
+                checkPartition(ints + offset, count, grain, 4);
+                checkPartition(triples + offset, count / 5, grain, 4); // 12 bytes, never on a line
+            }
+        }
+    }
+    // an int that is not aligned to its size leaves no lead
+    checkPartition(reinterpret_cast<const int*>(reinterpret_cast<const char*>(ints) + 2), 1000, 16, 4);
+
+    // task 0 is the lead and one grain: ints + 3 leaves 13 in front of the next line
+    const xvc::detail::Partition part = xvc::detail::alignedPartition(ints + 3, 1000, 32, 4);
+    CHECK(part.lead == 13 && part.grain == 32 && part.last(0) == 45 && part.first(1) == 45 && part.last(1) == 77);
+    CHECK(part.tasks == 1 + (1000 - 45 + 31) / 32);
+}
+
+// every element is visited once, at any alignment, size and grain, on the global pool and on one
+// with workers
+void testForEach()
+{
+    for (ThreadPool* pool : { &ThreadPool::global(), &workers() })
+    {
+        for (size_t count : { 0, 1, 17, 1000, 4099 })
+        {
+            for (size_t grain : { 0, 1, 7, 100 })
+            {
+                XVector<int> v(count + 3, 0);
+                for (size_t offset = 0; offset < 3; ++offset)
+                    xvc::parallel_for_each(v.data() + offset, v.data() + offset + count, [](int& x) { ++x; }, grain, *pool);
+
+                bool ok = true;
+                for (size_t i = 0; i < count + 3; ++i)
+                {
+                    int covering = 0;
+                    for (size_t offset = 0; offset < 3; ++offset) covering += i >= offset && i < offset + count;
+                    ok &= v[i] == covering;
+                }
+                CHECK(ok);
+
+                std::atomic<long> sum{0};
+                const XVector<int>& constant = v;
+                xvc::parallel_for_each(constant, [&](const int& x) { sum += x; }, grain, *pool);
+                long expected = 0;
+                for (int x : v) expected += x;
+                CHECK(sum == expected);
+            }
+        }
+    }
+}
+
+void testTransform()
+{
+    for (ThreadPool* pool : { &ThreadPool::global(), &workers() })
+    {
+        for (size_t grain : { 0, 5 })
+        {
+            XVector<int> v(1000, 0);
+            for (size_t i = 0; i < v.size(); ++i) v[i] = static_cast<int>(i);
+
+            // in place through the pointer form
+            xvc::parallel_transform(v.data() + 1, v.data() + v.size(), v.data() + 1, [](int x) { return 2 * x; }, grain, *pool);
+            bool ok = v[0] == 0;
+            for (size_t i = 1; i < v.size(); ++i) ok &= v[i] == static_cast<int>(2 * i);
+            CHECK(ok);
+
+            // a longer output keeps its tail, a shorter one throws
+            XVector<long> out(1200, -1);
+            xvc::parallel_transform(v, out, [](int x) { return long(x) + 1; }, grain, *pool);
+            CHECK(out[0] == 1 && out[999] == 1999 && out[1000] == -1 && out[1199] == -1);
+            XVector<long> shorter(999, 0);
+            CHECK_THROWS(xvc::parallel_transform(v, shorter, [](int x) { return long(x); }, grain, *pool), std::length_error);
+
+            // to a new vector of another type, and into one that had contents
+            const XVector<std::string> strings = xvc::parallel_transform(v, [](int x) { return std::to_string(x); }, grain, *pool);
+            CHECK(strings.size() == 1000 && strings[0] == "0" && strings[999] == "1998");
+            XVector<std::string> into(5, "old");
+            xvc::transform_into(XVector<int>(), into, [](int x) { return std::to_string(x); }, grain, *pool);
+            CHECK(into.empty());
+
+            // in place, where out is also the input
+            XVector<std::string> same = strings;
+            xvc::transform_into(same, same, [](const std::string& s) { return s + "!"; }, grain, *pool);
+            CHECK(same.size() == 1000 && same[0] == "0!" && same[999] == "1998!");
+        }
+    }
+}
+
+// when f throws, transform_into destroys what the finished tasks and the throwing one built, so out
+// is left empty with nothing alive, and the first exception reaches the caller
+void testTransformThrows()
+{
+    XVector<int> v(2000, 0);
+    for (size_t i = 0; i < v.size(); ++i) v[i] = static_cast<int>(i);
+
+    for (ThreadPool* pool : { &ThreadPool::global(), &workers() })
+    {
+        for (int at : { 0, 1, 700, 1999 })
+        {
+            XVector<Counted> out;
+            out.emplace_back(-1);
+            CHECK_THROWS(xvc::transform_into(v, out, [at](int x) {
+                             if (x == at) throw std::runtime_error("f failed");
+                             return Counted(x);
+                         }, 16, *pool),
+                         std::runtime_error);
+            CHECK(out.empty() && Counted::live == 0);
+        }
+    }
+
+    // with the tasks run in order the first to throw is the lowest element. every task that did not
+    // throw still runs to its end.
+    ThreadPool serial(0);
+    for (ThreadPool* pool : { &serial, &workers() })
+    {
+        std::vector<std::atomic<int>> visited(v.size());
+        std::string message;
+        try
+        {
+            xvc::parallel_for_each(v, [&](const int& x) {
+                if (x % 500 == 250) throw std::runtime_error(std::to_string(x));
+                ++visited[static_cast<size_t>(x)];
+            }, 16, *pool);
+        }
+        catch (const std::runtime_error& e)
+        {
+            message = e.what();
+        }
+
+        const xvc::detail::Partition part = xvc::detail::alignedPartition(v.data(), v.size(), 16, pool->concurrency());
+        bool ok = true;
+        for (size_t task = 0; task < part.tasks; ++task)
+        {
+            bool threw = false;
+            for (size_t i = part.first(task); i < part.last(task); ++i) threw |= i % 500 == 250;
+            for (size_t i = part.first(task); i < part.last(task); ++i) ok &= threw || visited[i] == 1;
+        }
+        CHECK(ok);
+        if (pool == &serial) CHECK(message == "250");
+        else CHECK(message == "250" || message == "750" || message == "1250" || message == "1750");
+    }
+}
+
+// a counted element whose copies and moves start throwing after a countdown. its move is not
+// noexcept, so moving elements out of a vector that must survive an exception has to copy them.
+struct Fragile
+{
+    static inline std::atomic<long> live{0};
+    static inline std::atomic<long> copiesLeft{-1}; // below 0: never throws
+    std::string payload;
+
+    explicit Fragile(int i) : payload(std::string(24, 'f') + std::to_string(i)) { ++live; }
+    Fragile(const Fragile& other) : payload(other.payload)
+    {
+        countDown();
+        ++live;
+    }
+    Fragile(Fragile&& other) : payload(std::move(other.payload))
+    {
+        countDown();
+        ++live;
+    }
+    Fragile& operator=(const Fragile&) = default;
+    Fragile& operator=(Fragile&&) = default;
+    ~Fragile() { --live; }
+
+    static void countDown()
+    {
+        if (copiesLeft >= 0 && copiesLeft-- == 0) throw std::runtime_error("copy failed");
+    }
+};
+
+// element counts on both sides of the 512-element task granule, and grains that give one
+// granule per task, two, and everything in one task
+const size_t filterCounts[] = { 0, 1, 511, 512, 513, 1000, 1537, 5000 };
+const size_t filterGrains[] = { 0, 1, 600, 100000 };
+
+// the survivors in order, across task boundaries, as std::copy_if finds them, and pred is called
+// once per element
+template<typename T, typename Make>
+void checkCopyIf(Make make, ThreadPool& pool)
+{
+    for (size_t count : filterCounts)
+    {
+        for (size_t grain : filterGrains)
+        {
+            XVector<T> in;
+            for (size_t i = 0; i < count; ++i) in.push_back(make(i));
+            // runs of every length, including whole blocks of 64 with none selected
+            auto pick = [](size_t i) { return i % 7 == 0 || (i / 100) % 3 == 1; };
+            std::vector<T> expected;
+            for (size_t i = 0; i < count; ++i)
+                if (pick(i)) expected.push_back(in[i]);
+
+            std::atomic<size_t> calls{0};
+            auto pred = [&](const T& x) {
+                ++calls;
+                return pick(static_cast<size_t>(&x - in.data()));
+            };
+            XVector<T> out;
+            out.push_back(make(12345)); // replaced
+            xvc::parallel_copy_if(in, out, pred, grain, pool);
+            CHECK(std::vector<T>(out.begin(), out.end()) == expected && calls == count);
+
+            const XVector<T> fresh = xvc::parallel_copy_if(in, pred, grain, pool);
+            CHECK(std::vector<T>(fresh.begin(), fresh.end()) == expected);
+
+            // out may be the input
+            XVector<T> same = in;
+            const T* base = same.data();
+            xvc::parallel_copy_if(same, same, [&](const T& x) { return pick(static_cast<size_t>(&x - base)); }, grain, pool);
+            CHECK(std::vector<T>(same.begin(), same.end()) == expected);
+        }
+    }
+}
+
+void testCopyIf()
+{
+    for (ThreadPool* pool : { &ThreadPool::global(), &workers() })
+    {
+        checkCopyIf<int>([](size_t i) { return static_cast<int>(i); }, *pool);
+        checkCopyIf<double>([](size_t i) { return static_cast<double>(i) * 0.5; }, *pool);
+        checkCopyIf<std::string>([](size_t i) { return std::string(20, 's') + std::to_string(i); }, *pool);
+    }
+
+    // a throwing predicate leaves out as it was, and nothing alive
+    XVector<Counted> in;
+    for (int i = 0; i < 3000; ++i) in.emplace_back(i);
+    for (ThreadPool* pool : { &ThreadPool::global(), &workers() })
+    {
+        XVector<Counted> out;
+        out.emplace_back(-1);
+        CHECK_THROWS(xvc::parallel_copy_if(in, out, [&](const Counted& x) {
+                         if (&x - in.data() == 2900) throw std::runtime_error("pred failed");
+                         return true;
+                     }, 1, *pool),
+                     std::runtime_error);
+        CHECK(out.size() == 1 && out[0].payload == std::string(24, 'c') + "-1" && Counted::live == 3001);
+    }
+}
+
+// both sides in their original order, as std::stable_partition leaves them, across task boundaries
+template<typename T, typename Make>
+void checkPartitionOrder(Make make, ThreadPool& pool)
+{
+    for (size_t count : filterCounts)
+    {
+        for (size_t grain : filterGrains)
+        {
+            XVector<T> vec;
+            for (size_t i = 0; i < count; ++i) vec.push_back(make(i));
+            auto pick = [](size_t i) { return i % 5 == 0 || (i / 64) % 4 == 2; };
+            std::vector<T> expected;
+            for (size_t i = 0; i < count; ++i)
+                if (pick(i)) expected.push_back(vec[i]);
+            const size_t survivors = expected.size();
+            for (size_t i = 0; i < count; ++i)
+                if (!pick(i)) expected.push_back(vec[i]);
+
+            const T* base = vec.data();
+            const size_t selected =
+                xvc::parallel_partition(vec, [&](const T& x) { return pick(static_cast<size_t>(&x - base)); }, grain, pool);
+            CHECK(selected == survivors && std::vector<T>(vec.begin(), vec.end()) == expected);
+        }
+    }
+}
+
+void testPartition()
+{
+    for (ThreadPool* pool : { &ThreadPool::global(), &workers() })
+    {
+        checkPartitionOrder<int>([](size_t i) { return static_cast<int>(i); }, *pool);
+        checkPartitionOrder<std::string>([](size_t i) { return std::to_string(i); }, *pool);
+
+        XVector<int> empty;
+        CHECK(xvc::parallel_partition(empty, [](int) { return true; }, 0, *pool) == 0 && empty.empty());
+    }
+
+    // a throwing predicate, or a copy that throws while the elements are placed, leaves vec as it
+    // was with nothing leaked
+    XVector<Fragile> vec;
+    for (int i = 0; i < 3000; ++i) vec.emplace_back(i);
+    const XVector<Fragile> before = vec;
+    auto unchanged = [&] {
+        bool ok = vec.size() == before.size();
+        for (size_t i = 0; ok && i < vec.size(); ++i) ok = vec[i].payload == before[i].payload;
+        return ok && Fragile::live == 6000;
+    };
+    for (ThreadPool* pool : { &ThreadPool::global(), &workers() })
+    {
+        CHECK_THROWS(xvc::parallel_partition(vec, [&](const Fragile& x) {
+                         if (&x - vec.data() == 1500) throw std::runtime_error("pred failed");
+                         return true;
+                     }, 1, *pool),
+                     std::runtime_error);
+        CHECK(unchanged());
+
+        // the first copies are survivors, the later ones the rest
+        for (long copies : { 0L, 100L, 1000L, 2500L })
+        {
+            Fragile::copiesLeft = copies;
+            CHECK_THROWS(xvc::parallel_partition(vec, [](const Fragile& x) { return x.payload.back() % 2 == 0; }, 1, *pool),
+                         std::runtime_error);
+            Fragile::copiesLeft = -1;
+            CHECK(unchanged());
+        }
+    }
+}
+
+int main()
+{
+    testAlignedPartition();
+    testForEach();
+    testTransform();
+    testTransformThrows();
+    testCopyIf();
+    testPartition();
+    return xtestFailures;
+}
@@ -0,0 +1,169 @@
+#include <xvc/XReduce.h>
+#include "XTest.h"
+
+#include <stddef.h> // size_t
+#include <stdint.h> // int8_t, int16_t, int32_t, int64_t, uint64_t
+#include <cmath>    // std::isnan, std::fabs
+#include <limits>   // std::numeric_limits
+#include <string>   // std::string, std::to_string
+#include <utility>  // std::pair
+
+using xvc::XVector;
+
+constexpr double qnan = std::numeric_limits<double>::quiet_NaN();
+
+// pseudo-random values in [-range, range), the same on every run
+template<typename T>
+XVector<T> noise(size_t count, int range, uint64_t seed = 1)
+{
+    XVector<T> v;
+    v.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        v.push_back(static_cast<T>(static_cast<int>((seed >> 33) % (2 * range)) - range));
+    }
+    return v;
+}
+
+// the kernels against the scalar loops at every start offset within a vector and every length
+// up to a few full unrolled loops plus a tail
+template<typename T, typename Sum, typename Extreme, typename MinMax>
+void testKernel(Sum sum, Extreme lowest, Extreme highest, MinMax minMax)
+{
+    const XVector<T> data = noise<T>(64 + 600, 100);
+    for (size_t offset = 0; offset < 64 / sizeof(T); ++offset)
+    {
+        bool ok = true;
+        for (size_t n = 0; n <= 600; n += n < 300 ? 1 : 37)
+        {
+            const T* p = data.data() + offset;
+            const T init = xvc::detail::extremeInit<false, T>();
+            ok &= sum(p, n) == xvc::simd::sumScalar<xvc::sum_t<T>>(p, n);
+            ok &= lowest(p, n, init) == xvc::simd::extremeScalar<false>(p, n, init);
+            ok &= highest(p, n, T(-1000)) == xvc::simd::extremeScalar<true>(p, n, T(-1000));
+
+            T lo = init, hi = T(-1000);
+            minMax(p, n, lo, hi);
+            ok &= lo == xvc::simd::extremeScalar<false>(p, n, init) && hi == xvc::simd::extremeScalar<true>(p, n, T(-1000));
+        }
+        CHECK(ok);
+    }
+}
+
+template<typename T>
+void testKernels()
+{
+    using namespace xvc::simd;
+    using Acc = xvc::sum_t<T>;
+    testKernel<T>(sumScalar<Acc, T>, extremeScalar<false, T>, extremeScalar<true, T>, [](const T* p, size_t n, T& lo, T& hi) {
+        lo = extremeScalar<false>(p, n, lo);
+        hi = extremeScalar<true>(p, n, hi);
+    });
+#if XVECTOR_SIMD_X86
+    const Isa isa = detectIsa();
+    if (isa >= Isa::sse2) testKernel<T>(sumSse2<Acc, T>, extremeSse2<false, T>, extremeSse2<true, T>, minMaxSse2<T>);
+    if (isa >= Isa::avx2) testKernel<T>(sumAvx2<Acc, T>, extremeAvx2<false, T>, extremeAvx2<true, T>, minMaxAvx2<T>);
+    if (isa >= Isa::avx512) testKernel<T>(sumAvx512<Acc, T>, extremeAvx512<false, T>, extremeAvx512<true, T>, minMaxAvx512<T>);
+#endif
+}
+
+void testSum()
+{
+    CHECK(xvc::sum(XVector<int>()) == 0 && xvc::sum(XVector<double>()) == 0.0);
+    CHECK(xvc::sum(XVector<double>{ 2.5 }) == 2.5 && xvc::sum(XVector<int8_t>{ -3 }) == -3);
+
+    // integers widen to 64 bits, and wrap there
+    CHECK(xvc::sum(XVector<int8_t>(1000, 127)) == 127000);
+    CHECK(xvc::sum(XVector<uint16_t>(100000, 65535)) == 6553500000ull);
+    CHECK(xvc::sum(XVector<uint64_t>{ ~uint64_t(0), 2 }) == 1);
+
+    // the same exact sum in every mode, then one only the compensated sum gets right: 2^24 + 1
+    // is not a float, so adding ones to 2^24 one at a time keeps losing them
+    const XVector<double> halves(1001, 0.5);
+    for (xvc::Summation mode : { xvc::Summation::fast, xvc::Summation::pairwise, xvc::Summation::kahan })
+        CHECK(xvc::sum(halves, mode) == 500.5);
+    XVector<float> ones(20000, 1.0f);
+    ones[0] = 16777216.0f;
+    CHECK(xvc::sum(ones, xvc::Summation::kahan) == 16777216.0f + 19999.0f);
+
+    // NaN propagates
+    CHECK(std::isnan(xvc::sum(XVector<double>{ 1.0, qnan, 2.0 })));
+
+    // the parallel sum matches the serial one
+    const XVector<int64_t> ints = noise<int64_t>(100000, 1 << 20);
+    CHECK(xvc::sum(xvc::par, ints) == xvc::sum(xvc::seq, ints));
+    const XVector<double> doubles = noise<double>(100000, 1 << 20);
+    CHECK(std::fabs(xvc::sum(xvc::par, doubles, xvc::Summation::kahan) - xvc::sum(xvc::seq, doubles, xvc::Summation::kahan)) < 1e-6);
+
+    // anything with + adds up from T{}
+    CHECK(xvc::sum(XVector<std::string>{ "ab", "c", "" }) == "abc");
+}
+
+// min, max, minmax, argmin and argmax agree on one input, serially and in parallel
+template<typename T>
+void checkExtremes(const XVector<T>& v, const T& lo, const T& hi, size_t loAt, size_t hiAt)
+{
+    CHECK(xvc::min(v) == lo && xvc::min(xvc::par, v) == lo);
+    CHECK(xvc::max(v) == hi && xvc::max(xvc::par, v) == hi);
+    CHECK(xvc::minmax(v) == std::make_pair(lo, hi) && xvc::minmax(xvc::par, v) == std::make_pair(lo, hi));
+    CHECK(xvc::argmin(v) == loAt && xvc::argmin(xvc::par, v) == loAt);
+    CHECK(xvc::argmax(v) == hiAt && xvc::argmax(xvc::par, v) == hiAt);
+}
+
+void testExtremes()
+{
+    // one element, and the integer limits themselves
+    checkExtremes(XVector<int>{ 4 }, 4, 4, 0, 0);
+    checkExtremes(XVector<int64_t>{ 0, INT64_MAX, INT64_MIN, 5 }, INT64_MIN, INT64_MAX, 2, 1);
+    checkExtremes(XVector<uint8_t>(300, 255), uint8_t(255), uint8_t(255), 0, 0);
+    checkExtremes(XVector<double>(7, std::numeric_limits<double>::infinity()), std::numeric_limits<double>::infinity(),
+                  std::numeric_limits<double>::infinity(), 0, 0);
+
+    // ties give the first position
+    checkExtremes(XVector<int>{ 3, 1, 9, 1, 9 }, 1, 9, 1, 2);
+
+    // NaN is skipped wherever it is, and only NaN gives NaN
+    checkExtremes(XVector<double>{ qnan, 2.0, -1.0, qnan, 8.0, qnan }, -1.0, 8.0, 2, 4);
+    const XVector<double> nans(5, qnan);
+    CHECK(std::isnan(xvc::min(nans)) && std::isnan(xvc::max(nans)));
+    CHECK(std::isnan(xvc::minmax(nans).first) && std::isnan(xvc::minmax(nans).second));
+    CHECK(xvc::argmin(nans) == 0 && xvc::argmax(nans) == 0);
+
+    // empty: argmin and argmax give 0, the others expect elements
+    CHECK(xvc::argmin(XVector<int>()) == 0 && xvc::argmax(XVector<double>()) == 0);
+
+    // types without numeric limits start from their first element
+    checkExtremes(XVector<std::string>{ "pear", "apple", "zebra", "apple" }, std::string("apple"), std::string("zebra"), 1, 2);
+    checkExtremes(XVector<std::string>{ "one" }, std::string("one"), std::string("one"), 0, 0);
+
+    // large enough to be split across tasks, with the extremes in the last task and NaNs around
+    for (size_t n : { size_t(5000), size_t(100003) })
+    {
+        XVector<double> doubles = noise<double>(n, 1000);
+        doubles[0] = qnan;
+        doubles[n / 2] = qnan;
+        doubles[n - 2] = -5000.0;
+        doubles[n - 1] = 5000.0;
+        checkExtremes(doubles, -5000.0, 5000.0, n - 2, n - 1);
+
+        XVector<std::string> strings;
+        for (size_t i = 0; i < n; ++i) strings.push_back("m" + std::to_string(i % 1000));
+        strings[n - 2] = "a";
+        strings[n - 1] = "z";
+        checkExtremes(strings, std::string("a"), std::string("z"), n - 2, n - 1);
+    }
+}
+
+int main()
+{
+    testKernels<int8_t>();
+    testKernels<int16_t>();
+    testKernels<int32_t>();
+    testKernels<int64_t>();
+    testKernels<float>();
+    testKernels<double>();
+    testSum();
+    testExtremes();
+    return xtestFailures;
+}
@@ -0,0 +1,76 @@
+#include <xvc/XRingBuffer.h>
+#include "XTest.h"
+
+#include <memory> // std::shared_ptr, std::make_shared
+#include <string> // std::string, std::to_string
+
+using xvc::XRingBuffer;
+using xvc::RingOverflow;
+
+// on a full overwrite buffer the pushed element may be the oldest one, which is dropped for it
+void testPushFrontOnFull()
+{
+    XRingBuffer<std::shared_ptr<std::string>> rb(4, RingOverflow::overwrite);
+    for (int i = 0; i < 4; ++i)
+        rb.push_back(std::make_shared<std::string>(std::string(24, 'r') + std::to_string(i)));
+    CHECK(rb.full());
+
+    for (int round = 0; round < 10; ++round)
+    {
+        const std::string oldest = *rb.front();
+        CHECK(rb.push_back(rb.front()));
+        CHECK(rb.size() == 4);
+        CHECK(*rb.back() == oldest);
+    }
+
+    XRingBuffer<std::string> strings(4, RingOverflow::overwrite);
+    for (int i = 0; i < 4; ++i) strings.push_back(std::string(24, 's') + std::to_string(i));
+    const std::string oldest = strings.front();
+    CHECK(strings.emplace_back(strings.front()));
+    CHECK(strings.back() == oldest);
+    CHECK(strings.front() == std::string(24, 's') + "1");
+}
+
+// linearize with the oldest element at every slot and every fill level keeps the order and
+// rearranges the elements within the same buffer
+template<typename T, typename Make>
+void testLinearize(Make make)
+{
+    constexpr size_t capacity = 16;
+    for (size_t head = 0; head < capacity; ++head)
+    {
+        for (size_t size = 0; size <= capacity; ++size)
+        {
+            XRingBuffer<T> rb(capacity);
+            const T* buffer = rb.linearize();
+            for (size_t i = 0; i < head; ++i) rb.push_back(make(1000 + i));
+            for (size_t i = 0; i < head; ++i) rb.pop_front();
+            for (size_t i = 0; i < size; ++i) rb.push_back(make(i));
+
+            const T* first = rb.linearize();
+            CHECK(rb.size() == size);
+            CHECK(first == (head + size <= capacity ? buffer + head : buffer));
+            CHECK(rb.array_one().second == size);
+            CHECK(rb.array_two().second == 0);
+            for (size_t i = 0; i < size; ++i)
+                CHECK(first[i] == make(i));
+
+            // and the ring keeps working from the new head
+            if (size)
+            {
+                rb.pop_front();
+                CHECK(rb.push_back(make(size)));
+                for (size_t i = 0; i < size; ++i)
+                    CHECK(rb[i] == make(i + 1));
+            }
+        }
+    }
+}
+
+int main()
+{
+    testPushFrontOnFull();
+    testLinearize<int>([](size_t i) { return static_cast<int>(i); });
+    testLinearize<std::string>([](size_t i) { return std::string(24, 'l') + std::to_string(i); });
+    return xtestFailures;
+}
@@ -0,0 +1,221 @@
+#include <xvc/XSearch.h>
+#include "XTest.h"
+
+#include <stddef.h> // size_t
+#include <stdint.h> // int8_t, int16_t, int32_t, int64_t
+#include <limits>   // std::numeric_limits
+
+using xvc::XVector;
+
+constexpr size_t maxOffset = 64;
+constexpr size_t maxLength = 257;
+
+// every kernel at every start offset from a 64-byte boundary and every length up to a few full
+// vectors plus a tail. the elements just before and after the range hold the needle, so a kernel
+// that reads past either end finds it where it should not.
+template<typename T, typename FindAny, typename CountEqual>
+void testKernel(FindAny findAny, CountEqual countEqual)
+{
+    const T filler = T(1);
+    const T needle = T(7);
+    const T values[] = { T(5), T(9), needle }; // needle last, so every compare is exercised
+    const T notOf[] = { filler, T(3) };
+
+    alignas(64) T buffer[maxOffset + maxLength + maxOffset];
+    for (size_t offset = 0; offset < maxOffset; ++offset)
+    {
+        T* data = buffer + offset;
+        for (size_t length = 0; length <= maxLength; ++length)
+        {
+            auto reset = [&] {
+                for (T& x : buffer) x = needle;
+                for (size_t i = 0; i < length; ++i) data[i] = i % 2 ? T(3) : filler;
+            };
+
+            reset();
+            CHECK(findAny(data, length, &needle, 1, false) == length);
+            CHECK(findAny(data, length, values, 3, false) == length);
+            CHECK(findAny(data, length, notOf, 2, true) == length);
+            CHECK(countEqual(data, length, needle) == 0);
+            CHECK(countEqual(data, length, filler) == (length + 1) / 2);
+            if (length == 0) continue;
+
+            // the needle at the last few positions, which is where the scalar tail or the masked
+            // final vector takes over
+            for (size_t back = 1; back <= 3 && back <= length; ++back)
+            {
+                const size_t at = length - back;
+                reset();
+                data[at] = needle;
+                CHECK(findAny(data, length, &needle, 1, false) == at);
+                CHECK(findAny(data, length, values, 3, false) == at);
+                CHECK(findAny(data, length, notOf, 2, true) == at);
+                CHECK(findAny(data, length, &filler, 1, true) == (at == 0 ? 0 : 1));
+                CHECK(countEqual(data, length, needle) == 1);
+            }
+
+            // a full range of needles counts each one exactly once
+            for (T& x : buffer) x = needle;
+            CHECK(countEqual(data, length, needle) == length);
+            CHECK(findAny(data, length, &needle, 1, true) == length);
+        }
+    }
+}
+
+// the public functions over an XVector, with the needle in the tail
+template<typename T>
+void testFunctions()
+{
+    for (size_t length = 1; length <= maxLength; ++length)
+    {
+        XVector<T> vec(length, T(1));
+        vec[length - 1] = T(7);
+        const XVector<T>& view = vec;
+
+        CHECK(xvc::find(vec, T(7)) == vec.data() + length - 1);
+        CHECK(xvc::find(view, T(9)) == view.end());
+        CHECK(xvc::find_if_equal(vec, { T(3), T(5), T(7) }) == vec.data() + length - 1);
+        CHECK(xvc::find_if_equal(view, { T(3), T(5) }) == view.end());
+        CHECK(xvc::count(view, T(7)) == 1);
+        CHECK(xvc::count(view, T(1)) == length - 1);
+        CHECK(xvc::contains(view, T(7)));
+        CHECK(!xvc::contains(view, T(9)));
+        CHECK(xvc::find_first_not_of(vec, T(1)) == vec.data() + length - 1);
+        CHECK(xvc::find_first_not_of(view, { T(1), T(7) }) == view.end());
+    }
+
+    const XVector<T> empty;
+    CHECK(xvc::find(empty, T(7)) == empty.end());
+    CHECK(xvc::count(empty, T(7)) == 0);
+    CHECK(!xvc::contains(empty, T(7)));
+    CHECK(xvc::find_first_not_of(empty, T(7)) == empty.end());
+}
+
+// the mismatch kernels at every offset and length like testKernel, with the two ranges at
+// different offsets from each other. past either end the ranges differ, so a kernel that reads
+// too far finds a difference where there is none.
+template<typename T, typename Mismatch>
+void testMismatchKernel(Mismatch mismatch)
+{
+    alignas(64) T left[maxOffset + maxLength + maxOffset];
+    alignas(64) T right[maxOffset + maxLength + maxOffset];
+    for (size_t offset = 0; offset < maxOffset; offset += offset < 8 ? 1 : 19)
+    {
+        T* a = left + offset;
+        T* b = right + (offset * 3) % maxOffset;
+        for (size_t length = 0; length <= maxLength; ++length)
+        {
+            auto reset = [&] {
+                for (T& x : left) x = T(1);
+                for (T& x : right) x = T(2);
+                for (size_t i = 0; i < length; ++i) a[i] = b[i] = T(i % 5);
+            };
+
+            reset();
+            bool ok = mismatch(a, b, length) == length;
+            for (size_t at : { size_t(0), length / 2, length - 3, length - 2, length - 1 })
+            {
+                if (at >= length) continue;
+                reset();
+                b[at] = T(9);
+                ok &= mismatch(a, b, length) == at;
+                ok &= mismatch(b, a, length) == at;
+            }
+            CHECK(ok);
+        }
+    }
+}
+
+// float and double compare as values, here in the vector part and in the tail
+template<typename T, typename Mismatch>
+void testMismatchFloat(Mismatch mismatch)
+{
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+    for (size_t length : { size_t(3), size_t(64), size_t(67) })
+    {
+        XVector<T> a(length, T(0.0)), b(length, T(-0.0));
+        CHECK(mismatch(a.data(), b.data(), length) == length);
+        a[length - 2] = b[length - 2] = nan;
+        CHECK(mismatch(a.data(), b.data(), length) == length - 2);
+        CHECK(mismatch(a.data(), a.data(), length) == length - 2);
+    }
+}
+
+template<typename T>
+void testMismatch()
+{
+    using namespace xvc::simd;
+    testMismatchKernel<T>([](const T* a, const T* b, size_t n) { return mismatchScalar(a, b, n); });
+#if XVECTOR_SIMD_X86
+    const Isa isa = detectIsa();
+    if (isa >= Isa::sse2) testMismatchKernel<T>([](const T* a, const T* b, size_t n) { return mismatchSse2(a, b, n); });
+    if (isa >= Isa::avx2) testMismatchKernel<T>([](const T* a, const T* b, size_t n) { return mismatchAvx2(a, b, n); });
+    if (isa >= Isa::avx512) testMismatchKernel<T>([](const T* a, const T* b, size_t n) { return mismatchAvx512(a, b, n); });
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        if (isa >= Isa::sse2) testMismatchFloat<T>([](const T* a, const T* b, size_t n) { return mismatchSse2(a, b, n); });
+        if (isa >= Isa::avx2) testMismatchFloat<T>([](const T* a, const T* b, size_t n) { return mismatchAvx2(a, b, n); });
+        if (isa >= Isa::avx512) testMismatchFloat<T>([](const T* a, const T* b, size_t n) { return mismatchAvx512(a, b, n); });
+    }
+#endif
+
+    // the public function stops at the shorter vector
+    XVector<T> a(100, T(1)), b(70, T(1));
+    CHECK(xvc::mismatch(a, b).first == a.data() + 70 && xvc::mismatch(a, b).second == b.data() + 70);
+    b[69] = T(2);
+    const XVector<T>& view = a;
+    CHECK(xvc::mismatch(view, static_cast<const XVector<T>&>(b)).first == view.data() + 69);
+    CHECK(xvc::mismatch(XVector<T>(), b).second == b.data());
+}
+
+template<typename T>
+void testType()
+{
+    testKernel<T>([](const T* d, size_t n, const T* v, size_t k, bool negate) { return xvc::simd::findAnyScalar(d, n, v, k, negate); },
+                  [](const T* d, size_t n, const T& v) {
+                      size_t found = 0;
+                      for (size_t i = 0; i < n; ++i) found += d[i] == v;
+                      return found;
+                  });
+#if XVECTOR_SIMD_X86
+    using xvc::simd::Isa;
+    const Isa isa = xvc::simd::detectIsa();
+    if (isa >= Isa::sse2)
+        testKernel<T>([](const T* d, size_t n, const T* v, size_t k, bool negate) { return xvc::simd::findAnySse2(d, n, v, k, negate); },
+                      [](const T* d, size_t n, const T& v) { return xvc::simd::countEqualSse2(d, n, v); });
+    if (isa >= Isa::avx2)
+        testKernel<T>([](const T* d, size_t n, const T* v, size_t k, bool negate) { return xvc::simd::findAnyAvx2(d, n, v, k, negate); },
+                      [](const T* d, size_t n, const T& v) { return xvc::simd::countEqualAvx2(d, n, v); });
+    if (isa >= Isa::avx512)
+        testKernel<T>([](const T* d, size_t n, const T* v, size_t k, bool negate) { return xvc::simd::findAnyAvx512(d, n, v, k, negate); },
+                      [](const T* d, size_t n, const T& v) { return xvc::simd::countEqualAvx512(d, n, v); });
+#endif
+    testFunctions<T>();
+    testMismatch<T>();
+}
+
+// float and double compare as values: -0.0 finds 0.0 and NaN finds nothing
+template<typename T>
+void testFloatEquality()
+{
+    XVector<T> vec(100, T(1));
+    vec[90] = T(-0.0);
+    vec[95] = std::numeric_limits<T>::quiet_NaN();
+    CHECK(xvc::find(vec, T(0.0)) == vec.data() + 90);
+    CHECK(xvc::count(vec, T(0.0)) == 1);
+    CHECK(!xvc::contains(vec, std::numeric_limits<T>::quiet_NaN()));
+    CHECK(xvc::find_first_not_of(vec, { T(1), T(0.0) }) == vec.data() + 95);
+}
+
+int main()
+{
+    testType<int8_t>();
+    testType<int16_t>();
+    testType<int32_t>();
+    testType<int64_t>();
+    testType<float>();
+    testType<double>();
+    testFloatEquality<float>();
+    testFloatEquality<double>();
+    return xtestFailures;
+}
@@ -0,0 +1,491 @@
+#include <xvc/XSort.h>
+#include "XTest.h"
+
+#include <stddef.h>   // size_t
+#include <stdint.h>   // int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t, uint64_t
+#include <algorithm>  // std::sort, std::stable_sort, std::is_sorted, std::merge
+#include <cmath>      // std::signbit, std::isnan
+#include <functional> // std::greater
+#include <limits>     // std::numeric_limits
+#include <stdexcept>  // std::length_error
+#include <string>     // std::string, std::to_string, std::stoi
+#include <vector>     // std::vector
+
+using xvc::XVector;
+using xvc::ThreadPool;
+
+// a pool with workers, so the parallel sorts really run concurrently even on a single core
+ThreadPool& workers()
+{
+    static ThreadPool pool(3);
+    return pool;
+}
+
+// pseudo-random keys over the full range of T, or below range when it is not 0, the same on every run
+template<typename T>
+XVector<T> randomKeys(size_t count, uint64_t range = 0, uint64_t seed = 1)
+{
+    XVector<T> keys;
+    keys.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        const uint64_t bits = range ? (seed >> 20) % range : seed ^ (seed >> 29);
+        if constexpr (std::is_floating_point_v<T>)
+            keys.push_back(range ? static_cast<T>(bits) - static_cast<T>(range / 2) : static_cast<T>(static_cast<int64_t>(bits)) * T(1e-9));
+        else
+            keys.push_back(static_cast<T>(bits));
+    }
+    return keys;
+}
+
+// the order radix_sort promises, as a comparator
+struct RadixLess
+{
+    template<typename T>
+    bool operator()(T a, T b) const { return xvc::detail::radixKey(a) < xvc::detail::radixKey(b); }
+};
+
+// every key maps to an unsigned integer in the order of the list
+template<typename T>
+void checkKeyOrder(const std::vector<T>& ascending)
+{
+    bool ok = true;
+    for (size_t i = 1; i < ascending.size(); ++i)
+        ok &= xvc::detail::radixKey(ascending[i - 1]) < xvc::detail::radixKey(ascending[i]);
+    CHECK(ok);
+}
+
+template<typename T>
+void testFloatKeys()
+{
+    using L = std::numeric_limits<T>;
+    const T nan = L::quiet_NaN();
+    checkKeyOrder<T>({ -nan, -L::infinity(), -L::max(), T(-1), -L::min(), -L::denorm_min(), T(-0.0), T(0.0),
+                       L::denorm_min(), L::min(), T(1), L::max(), L::infinity(), nan });
+}
+
+void testKeys()
+{
+    testFloatKeys<float>();
+    testFloatKeys<double>();
+    checkKeyOrder<int8_t>({ INT8_MIN, -1, 0, 1, INT8_MAX });
+    checkKeyOrder<int16_t>({ INT16_MIN, -300, -1, 0, 1, 300, INT16_MAX });
+    checkKeyOrder<int32_t>({ INT32_MIN, -70000, -1, 0, 1, 70000, INT32_MAX });
+    checkKeyOrder<int64_t>({ INT64_MIN, INT64_MIN + 1, -(int64_t(1) << 40), -1, 0, 1, int64_t(1) << 40, INT64_MAX });
+    checkKeyOrder<uint64_t>({ 0, 1, uint64_t(1) << 63, UINT64_MAX });
+}
+
+// radix_sort against std::sort at sizes around the insertion sort limit and the digit width
+// switches, with the buffer from spare capacity, from a scratch vector and from a temporary
+template<typename T>
+void testSortType()
+{
+    const size_t sizes[] = { 0, 1, 2, 63, 64, 65, 1000, (size_t(1) << 14) + 3, (size_t(1) << 16) + 5 };
+    for (size_t n : sizes)
+    {
+        for (uint64_t range : { uint64_t(0), uint64_t(10) })
+        {
+            XVector<T> keys = randomKeys<T>(n, range, n + range);
+            if (n > 4 && std::is_integral_v<T>)
+            {
+                keys[0] = std::numeric_limits<T>::max();
+                keys[n / 2] = std::numeric_limits<T>::lowest();
+            }
+            XVector<T> expected = keys;
+            std::sort(expected.begin(), expected.end(), RadixLess());
+
+            XVector<T> temporary = keys;
+            xvc::radix_sort(temporary);
+            CHECK(temporary == expected);
+
+            // room for another n elements: sorts in the spare capacity and leaves scratch alone
+            XVector<T> spare;
+            spare.reserve(2 * n);
+            spare.append(keys.data(), n);
+            const T* inPlace = spare.data();
+            XVector<T> scratch;
+            const T* untouched = scratch.data();
+            xvc::radix_sort(spare, scratch);
+            CHECK(spare == expected && spare.data() == inPlace && scratch.data() == untouched);
+
+            // no room: the scratch buffer is grown once and then reused
+            XVector<T> tight = keys;
+            tight.shrink_to_fit();
+            xvc::radix_sort(tight, scratch);
+            CHECK(tight == expected && scratch.capacity() >= (n > 64 ? n : 0));
+            const T* reused = scratch.data();
+            tight = keys;
+            tight.shrink_to_fit();
+            xvc::radix_sort(tight, scratch);
+            CHECK(tight == expected && scratch.data() == reused);
+        }
+    }
+}
+
+// -0.0 sorts before 0.0, negative NaNs first and positive NaNs last
+template<typename T>
+void testSortFloat()
+{
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+    for (size_t n : { size_t(20), size_t(5000) })
+    {
+        XVector<T> keys = randomKeys<T>(n, 100);
+        keys[1] = T(0.0);
+        keys[2] = T(-0.0);
+        keys[3] = nan;
+        keys[4] = -nan;
+        keys[5] = std::numeric_limits<T>::infinity();
+        xvc::radix_sort(keys);
+        CHECK(std::isnan(keys[0]) && std::signbit(keys[0]) && std::isnan(keys[n - 1]) && !std::signbit(keys[n - 1]));
+        CHECK(keys[n - 2] == std::numeric_limits<T>::infinity());
+        CHECK(std::is_sorted(keys.begin() + 1, keys.end() - 1));
+
+        size_t zero = 0;
+        while (!(keys[zero] == T(0))) ++zero;
+        CHECK(std::signbit(keys[zero]) && !std::signbit(keys[zero + 1]));
+    }
+}
+
+// a record sorted by one of its fields, which remembers where it started
+struct Record
+{
+    uint32_t key;
+    uint32_t position;
+};
+
+struct NamedRecord
+{
+    float key;
+    std::string name; // not trivially copyable, takes the std::stable_sort fallback
+};
+
+// the key overload is stable: among equal keys the positions stay ascending. the keys either use
+// few distinct values, or leave whole bytes equal in every key so those passes are skipped, each
+// pattern giving a different parity of passes that run.
+void testSortByKey()
+{
+    for (size_t n : { size_t(10), size_t(64), size_t(65), size_t(3000), (size_t(1) << 14) + 1 })
+    {
+        for (uint32_t mask : { 0x7u, 0x700u, 0x70000u, 0x7000000u, 0x7007u, 0x70707u, 0u })
+        {
+            XVector<Record> records;
+            const XVector<uint32_t> keys = randomKeys<uint32_t>(n, 0, n ^ mask);
+            for (size_t i = 0; i < n; ++i) records.push_back({ (keys[i] & mask) | 0x10101010u, static_cast<uint32_t>(i) });
+
+            xvc::radix_sort(records, [](const Record& r) { return r.key; });
+            bool ok = true;
+            for (size_t i = 1; i < n; ++i)
+                ok &= records[i - 1].key < records[i].key ||
+                      (records[i - 1].key == records[i].key && records[i - 1].position < records[i].position);
+            CHECK(ok);
+        }
+    }
+
+    // a key of another type than the record's field, with a scratch vector
+    XVector<Record> records;
+    XVector<Record> scratch;
+    for (uint32_t i = 0; i < 500; ++i) records.push_back({ i * 2654435761u, i });
+    xvc::radix_sort(records, [](const Record& r) { return -static_cast<int64_t>(r.key); }, scratch);
+    bool descending = true;
+    for (size_t i = 1; i < records.size(); ++i) descending &= records[i - 1].key >= records[i].key;
+    CHECK(descending);
+
+    // not trivially copyable: the same order and stability through the fallback
+    XVector<NamedRecord> named;
+    for (int i = 0; i < 300; ++i) named.push_back({ static_cast<float>(i % 5) - 2.0f, std::to_string(i) });
+    named[7].key = -0.0f;
+    xvc::radix_sort(named, [](const NamedRecord& r) { return r.key; });
+    bool ok = true;
+    for (size_t i = 1; i < named.size(); ++i)
+    {
+        ok &= RadixLess()(named[i - 1].key, named[i].key) ||
+              (named[i - 1].key == named[i].key && std::signbit(named[i - 1].key) == std::signbit(named[i].key) &&
+               std::stoi(named[i - 1].name) < std::stoi(named[i].name));
+    }
+    CHECK(ok);
+}
+
+// an element ordered by key alone, which remembers where it started
+struct Tagged
+{
+    int key;
+    int position;
+};
+
+struct ByKey
+{
+    bool operator()(const Tagged& a, const Tagged& b) const { return a.key < b.key; }
+};
+
+// the split at every diagonal matches what std::merge takes from the first run, ties included
+void testMergeSplit()
+{
+    const int aKeys[] = { 1, 2, 2, 2, 5, 7, 7, 9 };
+    const int bKeys[] = { 0, 2, 2, 3, 7, 7, 7, 8, 10, 11 };
+    for (size_t na : { size_t(0), size_t(1), size_t(4), size_t(8) })
+    {
+        for (size_t nb : { size_t(0), size_t(3), size_t(10) })
+        {
+            std::vector<Tagged> a, b, merged(na + nb);
+            for (size_t i = 0; i < na; ++i) a.push_back({ aKeys[i], 0 });
+            for (size_t i = 0; i < nb; ++i) b.push_back({ bKeys[i], 1 });
+            std::merge(a.begin(), a.end(), b.begin(), b.end(), merged.begin(), ByKey());
+
+            ByKey comp;
+            size_t fromA = 0;
+            for (size_t d = 0; d <= na + nb; ++d)
+            {
+                CHECK(xvc::detail::mergeSplit(a.data(), na, b.data(), nb, d, comp) == fromA);
+                if (d < na + nb && merged[d].position == 0) ++fromA;
+            }
+        }
+    }
+}
+
+// element counts that give every thread of the pool a run, fewer runs than threads, an odd run
+// left over for a round and a short last run, on both sides of the parallel minimum
+template<typename T>
+std::vector<size_t> parallelSizes()
+{
+    const size_t chunk = xvc::detail::parallelMinChunk<T>();
+    return { 0, 1, 100, 2 * chunk - 1, 2 * chunk, 2 * chunk + chunk / 2, 3 * chunk + 5, 5 * chunk, 9 * chunk + 7 };
+}
+
+template<typename T, typename Compare>
+void checkParallelSort(Compare comp, ThreadPool& pool)
+{
+    for (size_t n : parallelSizes<T>())
+    {
+        const XVector<T> keys = randomKeys<T>(n, 0, n);
+        XVector<T> expected = keys;
+        std::sort(expected.begin(), expected.end(), comp);
+
+        XVector<T> sorted = keys;
+        xvc::parallel_sort(sorted, comp, pool);
+        CHECK(sorted == expected);
+
+        sorted = keys;
+        xvc::parallel_stable_sort(sorted, comp, pool);
+        CHECK(sorted == expected);
+
+        XVector<T> scratch;
+        sorted = keys;
+        sorted.shrink_to_fit();
+        xvc::parallel_sort(sorted, scratch, comp, pool);
+        CHECK(sorted == expected);
+    }
+}
+
+// the radix path under std::less, the merge path under anything else, on a pool of four threads
+// and on one of three, whose runs do not pair up
+void testParallelSort()
+{
+    ThreadPool three(2);
+    for (ThreadPool* pool : { &workers(), &three })
+    {
+        checkParallelSort<int32_t>(std::less<>(), *pool);
+        checkParallelSort<int64_t>(std::less<int64_t>(), *pool);
+        checkParallelSort<uint16_t>(std::less<>(), *pool);
+        checkParallelSort<int32_t>(std::greater<>(), *pool);
+        checkParallelSort<double>(std::less<>(), *pool);
+    }
+
+    // the global pool, which may have no workers
+    XVector<int32_t> keys = randomKeys<int32_t>(100000);
+    xvc::parallel_sort(keys);
+    CHECK(std::is_sorted(keys.begin(), keys.end()));
+}
+
+// equal keys keep their order through the runs, the merge path cuts and the merge rounds
+void testParallelStableSort()
+{
+    for (size_t n : parallelSizes<Tagged>())
+    {
+        for (uint64_t distinct : { uint64_t(1), uint64_t(3), uint64_t(1000) })
+        {
+            const XVector<int32_t> keys = randomKeys<int32_t>(n, distinct, n);
+            XVector<Tagged> items;
+            for (size_t i = 0; i < n; ++i) items.push_back({ keys[i], static_cast<int>(i) });
+
+            xvc::parallel_stable_sort(items, ByKey(), workers());
+            bool ok = true;
+            for (size_t i = 1; i < n; ++i)
+                ok &= items[i - 1].key < items[i].key ||
+                      (items[i - 1].key == items[i].key && items[i - 1].position < items[i].position);
+            CHECK(ok);
+        }
+    }
+}
+
+// strings live in a buffer of constructed elements, from a temporary, from a scratch vector that
+// is too short and is grown, and from one that already holds enough
+void testParallelSortStrings()
+{
+    const size_t n = 5 * xvc::detail::parallelMinChunk<std::string>() + 3;
+    const XVector<uint32_t> keys = randomKeys<uint32_t>(n, 50);
+    XVector<std::string> strings;
+    for (size_t i = 0; i < n; ++i) strings.push_back(std::to_string(keys[i]) + ":" + std::to_string(i));
+
+    // by the number before the colon alone, so stability is visible in the rest
+    auto byPrefix = [](const std::string& a, const std::string& b) { return std::stoi(a) < std::stoi(b); };
+    XVector<std::string> expected = strings;
+    std::stable_sort(expected.begin(), expected.end(), byPrefix);
+
+    XVector<std::string> sorted = strings;
+    xvc::parallel_stable_sort(sorted, byPrefix, workers());
+    CHECK(sorted == expected);
+
+    XVector<std::string> scratch(10, std::string("short"));
+    sorted = strings;
+    xvc::parallel_stable_sort(sorted, scratch, byPrefix, workers());
+    CHECK(sorted == expected && scratch.size() == n);
+
+    sorted = strings;
+    xvc::parallel_stable_sort(sorted, scratch, byPrefix, workers());
+    CHECK(sorted == expected && scratch.size() == n);
+
+    XVector<std::string> unstable = strings;
+    xvc::parallel_sort(unstable, std::less<>(), workers());
+    std::sort(expected.begin(), expected.end());
+    CHECK(unstable == expected);
+}
+
+// perm is the stable sorting permutation of keys under less
+template<typename T, typename Index, typename Less>
+bool isStableOrder(const XVector<T>& keys, const XVector<Index>& perm, Less less)
+{
+    XVector<Index> expected;
+    for (size_t i = 0; i < keys.size(); ++i) expected.push_back(static_cast<Index>(i));
+    std::stable_sort(expected.begin(), expected.end(), [&](Index a, Index b) { return less(keys[a], keys[b]); });
+    return perm == expected;
+}
+
+// equal keys keep their index order, through the insertion sort and both digit widths
+template<typename T>
+void testArgsortType()
+{
+    for (size_t n : { size_t(0), size_t(1), size_t(50), size_t(64), size_t(65), size_t(1000), size_t(20000) })
+    {
+        for (uint64_t distinct : { uint64_t(1), uint64_t(7), uint64_t(0) })
+        {
+            XVector<T> keys = randomKeys<T>(n, distinct, n + distinct);
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                if (n > 10)
+                {
+                    keys[1] = T(-0.0);
+                    keys[2] = T(0.0);
+                    keys[3] = T(-0.0);
+                    keys[4] = std::numeric_limits<T>::quiet_NaN();
+                    keys[5] = -std::numeric_limits<T>::quiet_NaN();
+                }
+            }
+            CHECK(isStableOrder(keys, xvc::argsort(keys), RadixLess()));
+            CHECK(isStableOrder(keys, xvc::argsort<uint64_t>(keys), RadixLess()));
+            CHECK(isStableOrder(keys, xvc::argsort(keys, std::greater<>()), std::greater<>()));
+        }
+    }
+}
+
+void testArgsort()
+{
+    testArgsortType<int32_t>();
+    testArgsortType<uint8_t>();
+    testArgsortType<int64_t>();
+    testArgsortType<float>();
+    testArgsortType<double>();
+
+    // keys radix_sort cannot take go through the comparison sort, just as stable
+    XVector<std::string> words;
+    for (int i = 0; i < 300; ++i) words.push_back(std::string(1, static_cast<char>('a' + i % 5)));
+    CHECK(isStableOrder(words, xvc::argsort(words), std::less<>()));
+
+    // the index type has to reach n - 1
+    XVector<int> keys(256, 1);
+    CHECK(xvc::argsort<uint8_t>(keys).size() == 256);
+    keys.push_back(0);
+    CHECK_THROWS(xvc::argsort<uint8_t>(keys), std::length_error);
+    CHECK_THROWS(xvc::argsort<uint8_t>(keys, std::less<>()), std::length_error);
+}
+
+// every vector ends with vec[i] equal to the old vec[perm[i]]
+void checkPermutation(const XVector<uint32_t>& perm)
+{
+    const size_t n = perm.size();
+    XVector<int> ints;
+    XVector<double> doubles;
+    XVector<std::string> strings;
+    for (size_t i = 0; i < n; ++i)
+    {
+        ints.push_back(static_cast<int>(i));
+        doubles.push_back(static_cast<double>(i) * 0.5);
+        strings.push_back(std::string(20, 's') + std::to_string(i));
+    }
+    const XVector<std::string> before = strings;
+
+    xvc::apply_permutation(perm, ints, doubles, strings);
+    bool ok = true;
+    for (size_t i = 0; i < n; ++i)
+        ok &= ints[i] == static_cast<int>(perm[i]) && doubles[i] == static_cast<double>(perm[i]) * 0.5 &&
+              strings[i] == before[perm[i]];
+    CHECK(ok);
+}
+
+void testApplyPermutation()
+{
+    // the identity, every element its own cycle
+    XVector<uint32_t> perm;
+    checkPermutation(perm);
+    for (uint32_t i = 0; i < 100; ++i) perm.push_back(i);
+    checkPermutation(perm);
+
+    // cycles of three, two and four around fixed points: (0 3 5)(1 2)(6 9 8 7)
+    checkPermutation({ 3, 2, 1, 5, 4, 0, 9, 6, 7, 8 });
+
+    // one cycle through everything, and a random permutation with many cycles
+    perm.clear();
+    for (uint32_t i = 0; i < 1000; ++i) perm.push_back((i + 1) % 1000);
+    checkPermutation(perm);
+    const XVector<uint32_t> shuffle = randomKeys<uint32_t>(1000);
+    for (size_t i = perm.size() - 1; i > 0; --i) std::swap(perm[i], perm[shuffle[i] % (i + 1)]);
+    checkPermutation(perm);
+
+    // an argsort result sorts its keys and the column beside them together
+    XVector<float> keys = randomKeys<float>(500, 20);
+    XVector<int> column;
+    for (float key : keys) column.push_back(static_cast<int>(key) * 3);
+    xvc::apply_permutation(xvc::argsort(keys), keys, column);
+    bool ok = std::is_sorted(keys.begin(), keys.end());
+    for (size_t i = 0; i < keys.size(); ++i) ok &= column[i] == static_cast<int>(keys[i]) * 3;
+    CHECK(ok);
+
+    XVector<int> shorter(9, 0);
+    XVector<int> matching(10, 0);
+    CHECK_THROWS(xvc::apply_permutation(XVector<uint32_t>{ 3, 2, 1, 5, 4, 0, 9, 6, 7, 8 }, matching, shorter), std::length_error);
+}
+
+int main()
+{
+    testKeys();
+    testSortType<int8_t>();
+    testSortType<uint8_t>();
+    testSortType<int16_t>();
+    testSortType<uint16_t>();
+    testSortType<int32_t>();
+    testSortType<uint32_t>();
+    testSortType<int64_t>();
+    testSortType<uint64_t>();
+    testSortType<float>();
+    testSortType<double>();
+    testSortFloat<float>();
+    testSortFloat<double>();
+    testSortByKey();
+    testMergeSplit();
+    testParallelSort();
+    testParallelStableSort();
+    testParallelSortStrings();
+    testArgsort();
+    testApplyPermutation();
+    return xtestFailures;
+}
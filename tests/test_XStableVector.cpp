@@ -0,0 +1,72 @@
+#include <xvc/XStableVector.h>
+#include "XTest.h"
+
+#include <string> // std::string, std::to_string
+
+using xvc::XStableVector;
+
+// appending a vector to itself reads only the elements it had before
+template<typename T, typename Make>
+void testSelfConcatenate(Make make)
+{
+    for (size_t n : {0, 1, 7, 8, 9, 100, 1000, 5000})
+    {
+        XStableVector<T> s;
+        for (size_t i = 0; i < n; ++i) s.push_back(make(i));
+        const T* first = n ? &s[0] : nullptr;
+
+        s.concatenate(s);
+        CHECK(s.size() == 2 * n);
+        for (size_t i = 0; i < 2 * n; ++i)
+            CHECK(s[i] == make(i % n));
+        if (n) CHECK(&s[0] == first);
+    }
+}
+
+// resize fills each segment chunk, and can copy one of the vector's own elements
+template<typename T, typename Make>
+void testResize(Make make)
+{
+    XStableVector<T> s;
+    s.push_back(make(1));
+    s.resize(5, make(2));
+    s.resize(1000, s[0]);
+    CHECK(s.size() == 1000);
+    for (size_t i = 0; i < 1000; ++i)
+        CHECK(s[i] == (i >= 1 && i < 5 ? make(2) : make(1)));
+
+    s.resize(3);
+    CHECK(s.size() == 3);
+    CHECK(s[2] == make(2));
+}
+
+// an end() taken while the vector is full still reaches the elements appended after it
+template<typename T, typename Make>
+void testEndAtCapacity(Make make)
+{
+    XStableVector<T> s;
+    while (s.size() < 16 || s.size() < s.capacity()) s.push_back(make(s.size()));
+    CHECK(s.size() == s.capacity());
+
+    typename XStableVector<T>::iterator it = s.end();
+    const size_t full = s.size();
+    for (size_t i = 0; i < 40; ++i) s.push_back(make(full + i));
+
+    for (size_t i = 0; i < 40; ++i, ++it)
+    {
+        CHECK(*it == make(full + i));
+        CHECK(&*it == &s[full + i]);
+    }
+    CHECK(it == s.end());
+}
+
+int main()
+{
+    testSelfConcatenate<int>([](size_t i) { return static_cast<int>(i); });
+    testSelfConcatenate<std::string>([](size_t i) { return std::string(24, 'x') + std::to_string(i); });
+    testResize<int>([](size_t i) { return static_cast<int>(i); });
+    testResize<std::string>([](size_t i) { return std::string(24, 'x') + std::to_string(i); });
+    testEndAtCapacity<int>([](size_t i) { return static_cast<int>(i); });
+    testEndAtCapacity<std::string>([](size_t i) { return std::string(24, 'x') + std::to_string(i); });
+    return xtestFailures;
+}
@@ -0,0 +1,851 @@
+#include <xvc/XVector.h>
+#include "XTest.h"
+
+#include <stddef.h>     // size_t, ptrdiff_t
+#include <stdint.h>     // uint8_t, uint16_t, uint32_t, uint64_t
+#include <algorithm>    // std::copy, std::count, std::equal, std::lexicographical_compare
+#include <atomic>       // std::atomic
+#include <cstdlib>      // std::malloc, std::free
+#include <cstring>      // std::memcmp, std::memset
+#include <deque>        // std::deque
+#include <forward_list> // std::forward_list
+#include <iterator>     // std::istream_iterator, std::input_iterator_tag
+#include <limits>       // std::numeric_limits
+#include <list>         // std::list
+#include <mutex>        // std::mutex, std::lock_guard
+#include <new>          // std::bad_alloc
+#include <set>          // std::set
+#include <sstream>      // std::istringstream
+#include <stdexcept>    // std::runtime_error
+#include <string>       // std::string, std::to_string
+#include <thread>       // std::this_thread::get_id
+#include <utility>      // std::move
+#include <vector>       // std::vector
+
+using xvc::XVector;
+
+// every allocation of the test is counted, to see how often a constructor allocates
+static std::atomic<size_t> allocations{0};
+
+void* operator new(size_t bytes)
+{
+    ++allocations;
+    if (void* p = std::malloc(bytes ? bytes : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+template<typename T>
+XVector<T> iota(size_t first, size_t count, size_t capacity = 0)
+{
+    XVector<T> v;
+    v.reserve(capacity ? capacity : count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if constexpr (std::is_same_v<T, std::string>)
+            v.push_back(std::string(24, 'j') + std::to_string(first + i));
+        else
+            v.push_back(static_cast<T>(first + i));
+    }
+    return v;
+}
+
+// an empty vector keeps its own buffer when it is the larger one
+void testConcatenateIntoEmpty()
+{
+    XVector<int> e;
+    e.reserve(4096);
+    const int* buffer = e.data();
+    XVector<int> b = iota<int>(0, 100);
+    e.concatenate(std::move(b));
+    CHECK(e.size() == 100 && e.data() == buffer && e[99] == 99);
+
+    XVector<int> small;
+    small.reserve(4);
+    XVector<int> big = iota<int>(0, 10, 1024);
+    const int* bigBuffer = big.data();
+    small.concatenate(std::move(big));
+    CHECK(small.size() == 10 && small.data() == bigBuffer);
+}
+
+// join grows in the part with the largest buffer, wherever that part is
+template<typename T>
+void testJoin()
+{
+    XVector<T> e;
+    e.reserve(4096);
+    const T* buffer = e.data();
+    XVector<T> joined = xvc::join(std::move(e), iota<T>(0, 100), iota<T>(100, 100));
+    CHECK(joined.data() == buffer && joined.capacity() == 4096);
+    CHECK(joined == iota<T>(0, 200));
+
+    XVector<T> a = iota<T>(0, 10, 64);
+    XVector<T> b = iota<T>(10, 10, 4096);
+    XVector<T> c = iota<T>(20, 100, 100);
+    const T* bBuffer = b.data();
+    joined = xvc::join(std::move(a), std::move(b), std::move(c));
+    CHECK(joined.data() == bBuffer);
+    CHECK(joined == iota<T>(0, 120));
+    CHECK(a.empty() && b.empty() && c.empty());
+
+    XVector<XVector<T>> parts;
+    parts.push_back(iota<T>(0, 3));
+    parts.push_back(iota<T>(3, 5, 512));
+    parts.push_back(iota<T>(8, 7));
+    const T* partBuffer = parts[1].data();
+    joined = xvc::join(std::move(parts));
+    CHECK(joined.data() == partBuffer);
+    CHECK(joined == iota<T>(0, 15));
+    CHECK(parts.empty());
+
+    CHECK(xvc::join(XVector<XVector<T>>()).empty());
+}
+
+// one inserter reused across algorithm calls carries on where the previous call stopped
+template<typename T>
+void testBatchInserterReuse()
+{
+    for (size_t chunk : {1, 2, 3, 64})
+    {
+        const XVector<T> a = iota<T>(1, 3);
+        const XVector<T> b = iota<T>(4, 3);
+        const XVector<T> c = iota<T>(7, 1);
+
+        XVector<T> out;
+        {
+            auto it = xvc::batch_inserter(out, chunk);
+            it = std::copy(a.begin(), a.end(), it);
+            std::copy(b.begin(), b.end(), it);
+            *it = c[0];
+        }
+        CHECK(out == iota<T>(1, 7));
+
+        XVector<T> big;
+        {
+            auto it = xvc::batch_inserter(big, chunk);
+            for (int round = 0; round < 50; ++round)
+                std::copy(a.begin(), a.end(), it); // it itself never advances
+        }
+        CHECK(big.size() == 150);
+        for (size_t i = 0; i < big.size(); ++i)
+            CHECK(big[i] == a[i % 3]);
+    }
+}
+
+// a type whose copies throw on demand and which counts its live instances, to find leaks and
+// double destruction. the payload lives on the heap, so leak checkers see lost elements too.
+struct Fragile
+{
+    static inline std::atomic<long> live{0};
+    static inline std::atomic<long> copiesLeft{-1}; // the copy that finds 0 here throws, -1 never
+
+    std::string payload;
+
+    explicit Fragile(size_t i) : payload(std::string(24, 'f') + std::to_string(i)) { ++live; }
+    Fragile(const Fragile& other) : payload((mayThrow(), other.payload)) { ++live; }
+    Fragile& operator=(const Fragile& other)
+    {
+        mayThrow();
+        payload = other.payload;
+        return *this;
+    }
+    ~Fragile() { --live; }
+    bool operator==(const Fragile& other) const { return payload == other.payload; }
+
+    static void mayThrow()
+    {
+        if (copiesLeft.fetch_sub(1) == 0) throw std::runtime_error("copy failed");
+    }
+};
+
+XVector<Fragile> fragiles(size_t first, size_t count)
+{
+    XVector<Fragile> v;
+    v.reserve(count);
+    for (size_t i = 0; i < count; ++i) v.emplace_back(first + i);
+    return v;
+}
+
+// every copying operation, with large copies split across the pool, either finishes or throws
+// leaving no extra element alive and the target unchanged or at least consistent
+void testCopyExceptionSafety()
+{
+    const size_t savedThreshold = xvc::parallel_threshold;
+    xvc::parallel_threshold = 1;
+
+    constexpr size_t n = 20000; // several parallel chunks of Fragile
+    const XVector<Fragile> src = fragiles(0, n);
+    const XVector<Fragile> original = fragiles(n, n / 2);
+    const long baseline = Fragile::live;
+
+    for (long failAt : {0L, 1L, 1000L, 5000L, static_cast<long>(n) - 1})
+    {
+        Fragile::copiesLeft = failAt;
+        CHECK_THROWS(XVector<Fragile>(src), std::runtime_error);
+        CHECK(Fragile::live == baseline);
+
+        Fragile::copiesLeft = failAt;
+        CHECK_THROWS(XVector<Fragile>(n, src[0]), std::runtime_error);
+        CHECK(Fragile::live == baseline);
+
+        // assignment into a buffer that is too small, then into one that is large enough
+        for (size_t room : {size_t(0), 2 * n})
+        {
+            Fragile::copiesLeft = -1;
+            XVector<Fragile> target = original;
+            target.reserve(room);
+            Fragile::copiesLeft = failAt;
+            CHECK_THROWS(target = src, std::runtime_error);
+            Fragile::copiesLeft = -1;
+            CHECK(Fragile::live == baseline + static_cast<long>(target.size()));
+            if (room == 0) CHECK(target == original);
+        }
+
+        {
+            Fragile::copiesLeft = -1;
+            XVector<Fragile> target = original;
+            Fragile::copiesLeft = failAt;
+            CHECK_THROWS(target.resize(n + original.size(), src[0]), std::runtime_error);
+            Fragile::copiesLeft = -1;
+            CHECK(target == original);
+            CHECK(Fragile::live == baseline + static_cast<long>(target.size()));
+        }
+
+        {
+            Fragile::copiesLeft = -1;
+            XVector<Fragile> target = original;
+            Fragile::copiesLeft = failAt;
+            CHECK_THROWS(target.concatenate(src), std::runtime_error);
+            Fragile::copiesLeft = -1;
+            CHECK(target == original);
+            CHECK(Fragile::live == baseline + static_cast<long>(target.size()));
+        }
+    }
+
+    // and without a failure the copies are complete
+    Fragile::copiesLeft = -1;
+    XVector<Fragile> copy(src);
+    CHECK(copy == src);
+    copy.concatenate(src);
+    CHECK(copy.size() == 2 * n && copy[n + 5] == src[5]);
+    copy.resize(3 * n, src[1]);
+    CHECK(copy[3 * n - 1] == src[1]);
+
+    xvc::parallel_threshold = savedThreshold;
+}
+
+// insert, emplace and erase at begin(), end() and in the middle against std::vector, with values
+// taken from the vector itself, which move while the gap opens
+template<typename T>
+void testInsertErase()
+{
+    XVector<T> v = iota<T>(0, 8); // full, so the first insert reallocates
+    std::vector<T> ref(v.begin(), v.end());
+    auto same = [&v, &ref] { return v.size() == ref.size() && std::equal(v.begin(), v.end(), ref.begin()); };
+
+    CHECK(v.insert(v.begin(), v[5]) == v.begin());
+    ref.insert(ref.begin(), T(ref[5]));
+    CHECK(same());
+    CHECK(v.insert(v.begin() + 2, v[7]) == v.begin() + 2); // in place this time
+    ref.insert(ref.begin() + 2, T(ref[7]));
+    CHECK(same());
+    CHECK(v.insert(v.end(), v.front()) == v.end() - 1);
+    ref.insert(ref.end(), T(ref.front()));
+    CHECK(same());
+    v.insert(v.begin() + 3, 4, v.back());
+    ref.insert(ref.begin() + 3, 4, T(ref.back()));
+    CHECK(same());
+    v.insert(v.begin() + 1, std::move(v[6]));
+    T moved = std::move(ref[6]); // std::vector may assume an rvalue is not one of its elements
+    ref.insert(ref.begin() + 1, std::move(moved));
+    CHECK(same());
+    v.emplace(v.begin() + 2, v[9]);
+    ref.emplace(ref.begin() + 2, T(ref[9]));
+    CHECK(same());
+
+    const XVector<T> more = iota<T>(100, 5);
+    v.insert(v.begin() + 4, more.begin(), more.end());
+    ref.insert(ref.begin() + 4, more.begin(), more.end());
+    v.insert(v.end(), { more[0], more[1] });
+    ref.insert(ref.end(), { more[0], more[1] });
+    CHECK(same());
+
+    // a single-pass range is appended and rotated into place
+    std::string words;
+    for (size_t i = 0; i < 40; ++i) words += std::to_string(200 + i) + " ";
+    std::istringstream in(words), refIn(words);
+    CHECK(v.insert(v.begin() + 3, std::istream_iterator<T>(in), std::istream_iterator<T>()) == v.begin() + 3);
+    ref.insert(ref.begin() + 3, std::istream_iterator<T>(refIn), std::istream_iterator<T>());
+    CHECK(same());
+
+    CHECK(v.erase(v.begin() + 5, v.begin() + 20) == v.begin() + 5);
+    ref.erase(ref.begin() + 5, ref.begin() + 20);
+    CHECK(same());
+    CHECK(v.erase(v.begin()) == v.begin());
+    ref.erase(ref.begin());
+    CHECK(v.erase(v.end() - 1) == v.end());
+    ref.erase(ref.end() - 1);
+    CHECK(v.erase(v.begin() + 2, v.begin() + 2) == v.begin() + 2);
+    CHECK(same());
+    v.erase(v.begin(), v.end());
+    CHECK(v.empty());
+}
+
+// every append overload against the same expected contents; sized sources grow the buffer once
+template<typename T>
+void testAppend()
+{
+    const XVector<T> src = iota<T>(0, 100);
+    const std::vector<T> vec(src.begin(), src.end());
+    const std::list<T> list(src.begin(), src.end());
+    const std::set<T> set(src.begin(), src.end()); // in the same order as src for int only
+
+    XVector<T> expected = iota<T>(0, 5);
+    expected.append_range(vec);
+    CHECK(expected.size() == 105 && expected[104] == src[99]);
+
+    XVector<T> a = iota<T>(0, 5);
+    a.append(list.begin(), list.end());
+    CHECK(a == expected && a.capacity() == 128);
+
+    XVector<T> b = iota<T>(0, 5);
+    b.append_range(list);
+    CHECK(b == expected);
+
+    XVector<T> c = iota<T>(0, 5);
+    c.append(src.data(), src.size());
+    CHECK(c == expected);
+
+    XVector<T> d = iota<T>(0, 5);
+    std::string words;
+    for (size_t i = 0; i < src.size(); ++i)
+    {
+        if constexpr (std::is_same_v<T, std::string>) words += src[i] + " ";
+        else words += std::to_string(src[i]) + " ";
+    }
+    std::istringstream in(words);
+    d.append(std::istream_iterator<T>(in), std::istream_iterator<T>());
+    CHECK(d == expected);
+
+    if constexpr (std::is_same_v<T, int>)
+    {
+        XVector<T> e = iota<T>(0, 5);
+        e.append_range(set);
+        CHECK(e == expected);
+    }
+
+    // a vector appended to itself, with and without room
+    XVector<T> self = iota<T>(0, 8);
+    self.append_range(self);
+    CHECK(self.size() == 16);
+    self.append(self.data(), 4);
+    CHECK(self.size() == 20);
+    for (size_t i = 0; i < 20; ++i)
+        CHECK(self[i] == iota<T>(i % 8, 1)[0]);
+
+    XVector<T> empty;
+    empty.append(list.end(), list.end());
+    empty.append_range(std::vector<T>());
+    CHECK(empty.empty());
+}
+
+// unchecked appends and a BackWriter inside reserved capacity
+template<typename T>
+void testUncheckedAppends()
+{
+    const XVector<T> expected = iota<T>(0, 300);
+
+    XVector<T> u;
+    u.reserve(300);
+    const T* buffer = u.data();
+    for (size_t i = 0; i < 100; ++i) u.unchecked_push_back(expected[i]);
+    for (size_t i = 100; i < 200; ++i) u.unchecked_push_back(T(expected[i]));
+    for (size_t i = 200; i < 300; ++i) u.unchecked_emplace_back(expected[i]);
+    CHECK(u == expected && u.data() == buffer);
+
+    XVector<T> w = iota<T>(0, 10);
+    {
+        typename XVector<T>::BackWriter writer = w.back_writer(290);
+        CHECK(writer.remaining() >= 290);
+        for (size_t i = 10; i < 150; ++i) writer.push_back(expected[i]);
+        CHECK(w.size() == 10); // not published yet
+        writer.commit();
+        CHECK(w.size() == 150 && w[149] == expected[149]);
+        for (size_t i = 150; i < 300; ++i) writer.emplace_back(expected[i]);
+    }
+    CHECK(w == expected); // and the rest on destruction
+}
+
+// an iterator that only allows a single pass over a pointer range
+template<typename T>
+struct SinglePass
+{
+    using iterator_category = std::input_iterator_tag;
+    using value_type = T;
+    using difference_type = ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    const T* p;
+    reference operator*() const { return *p; }
+    SinglePass& operator++() { ++p; return *this; }
+    SinglePass operator++(int) { SinglePass tmp = *this; ++p; return tmp; }
+    bool operator==(const SinglePass& other) const { return p == other.p; }
+    bool operator!=(const SinglePass& other) const { return p != other.p; }
+};
+
+// the range constructor from every iterator category: multi-pass ranges are counted first and
+// allocate once, single-pass ones grow as they go
+template<typename T>
+void testRangeConstructor()
+{
+    const XVector<T> expected = iota<T>(0, 1000);
+    const std::vector<T> vec(expected.begin(), expected.end());
+    const std::deque<T> deque(expected.begin(), expected.end());
+    const std::list<T> list(expected.begin(), expected.end());
+    const std::forward_list<T> forward(expected.begin(), expected.end());
+
+    // strings allocate their own characters, so allocations are only counted for int
+    auto check = [&expected](auto first, auto last, bool once) {
+        allocations = 0;
+        const XVector<T> v(first, last);
+        if (once && std::is_same_v<T, int>) CHECK(allocations == 1);
+        CHECK(v == expected && v.capacity() == 1024);
+    };
+    check(expected.data(), expected.data() + expected.size(), true);     // pointers
+    check(vec.begin(), vec.end(), true);                                 // contiguous
+    check(deque.begin(), deque.end(), true);                             // random access
+    check(list.begin(), list.end(), true);                               // bidirectional
+    check(forward.begin(), forward.end(), true);                         // forward
+    check(SinglePass<T>{ expected.data() }, SinglePass<T>{ expected.data() + expected.size() }, false);
+
+    const XVector<T> empty(list.end(), list.end());
+    CHECK(empty.empty());
+}
+
+// every fill kernel the CPU has, with and without streaming stores, for each element width at
+// every element-aligned start within a cache line and every length up to a few vectors past the
+// streaming unrolls. the bytes around the range must stay untouched.
+template<size_t Width, typename Fill>
+void testFillKernel(Fill fill)
+{
+    constexpr size_t maxCount = 257;
+    alignas(64) unsigned char buffer[64 + maxCount * Width + 64];
+    unsigned char value[Width];
+    for (size_t b = 0; b < Width; ++b) value[b] = static_cast<unsigned char>(0x11 * (b + 1));
+    uint64_t pattern = 0;
+    for (size_t b = 0; b < 8; ++b) pattern |= uint64_t(value[b % Width]) << (8 * b);
+
+    for (bool stream : { false, true })
+    {
+        for (size_t offset = 0; offset < 64; offset += Width)
+        {
+            for (size_t count = 0; count <= maxCount; ++count)
+            {
+                std::memset(buffer, 0xEE, sizeof(buffer));
+                unsigned char* dest = buffer + offset;
+                fill(dest, count * Width, pattern, stream);
+
+                bool ok = true;
+                for (size_t i = 0; i < offset; ++i) ok &= buffer[i] == 0xEE;
+                for (size_t i = 0; i < count; ++i) ok &= std::memcmp(dest + i * Width, value, Width) == 0;
+                for (size_t i = offset + count * Width; i < sizeof(buffer); ++i) ok &= buffer[i] == 0xEE;
+                CHECK(ok);
+            }
+        }
+    }
+}
+
+template<typename Fill>
+void testFillKernelWidths(Fill fill)
+{
+    testFillKernel<1>(fill);
+    testFillKernel<2>(fill);
+    testFillKernel<4>(fill);
+    testFillKernel<8>(fill);
+}
+
+struct Rgb
+{
+    unsigned char r, g, b;
+    bool operator==(const Rgb& other) const { return r == other.r && g == other.g && b == other.b; }
+};
+
+// the count constructor, resize and assign over every tail length, through the broadcast fill
+// for 1, 2, 4 and 8-byte types and the doubling memcpy for the others
+template<typename T>
+void testFillAssign(const T& value, const T& other)
+{
+    for (size_t count = 0; count <= 130; ++count)
+    {
+        const XVector<T> made(count, value);
+        XVector<T> resized(3, other);
+        resized.resize(3 + count, value);
+        XVector<T> assigned(200, other);
+        assigned.assign(count, value);
+
+        bool ok = made.size() == count && resized.size() == 3 + count && assigned.size() == count;
+        for (size_t i = 0; i < count; ++i)
+            ok &= made[i] == value && resized[3 + i] == value && assigned[i] == value;
+        ok &= resized[0] == other && resized[2] == other;
+        CHECK(ok);
+    }
+
+    // assigning one of the vector's own elements, within and beyond its capacity
+    XVector<T> v(64, other);
+    v[10] = value;
+    v.assign(50, v[10]);
+    CHECK(v.size() == 50 && std::count(v.begin(), v.end(), value) == 50);
+    v.assign(1000, v[0]);
+    CHECK(v.size() == 1000 && std::count(v.begin(), v.end(), value) == 1000);
+}
+
+void testFill()
+{
+    using namespace xvc::simd;
+    testFillKernelWidths([](unsigned char* d, size_t bytes, uint64_t pattern, bool) { fillScalar(d, bytes, pattern); });
+#if XVECTOR_SIMD_X86
+    const Isa isa = detectIsa();
+    if (isa >= Isa::sse2) testFillKernelWidths(fillSse2);
+    if (isa >= Isa::avx2) testFillKernelWidths(fillAvx2);
+    if (isa >= Isa::avx512) testFillKernelWidths(fillAvx512);
+#endif
+
+    testFillAssign<uint8_t>(0xA5, 1);
+    testFillAssign<uint16_t>(0xA55A, 1);
+    testFillAssign<uint32_t>(0xA55A1234u, 1);
+    testFillAssign<uint64_t>(0xA55A123456789ABCull, 1);
+    testFillAssign<double>(-2.5, 1.0);
+    testFillAssign<Rgb>(Rgb{ 1, 2, 3 }, Rgb{ 9, 9, 9 });
+    testFillAssign<std::string>(std::string(30, 'f'), std::string(30, 'o'));
+}
+
+// an element that counts its destructions in a table by index and records the threads that ran them
+struct Tracked
+{
+    static inline std::vector<std::atomic<int>>* destroyed = nullptr;
+    static inline std::mutex mutex;
+    static inline std::set<std::thread::id> threads;
+
+    size_t index;
+    std::string payload; // keeps the element non-trivially destructible and freeing memory
+
+    Tracked() : index(SIZE_MAX) {} // resize's default value, not counted
+    explicit Tracked(size_t i) : index(i), payload(std::string(24, 't') + std::to_string(i)) {}
+    Tracked(const Tracked&) = default;
+    Tracked& operator=(const Tracked&) = default;
+    ~Tracked()
+    {
+        if (index != SIZE_MAX) (*destroyed)[index].fetch_add(1);
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+    }
+};
+
+// the destructor, clear, a shrinking resize and a shrinking copy assignment destroy every element
+// exactly once on either side of parallel_destroy_threshold, and above it on more than one thread
+// when the pool has any
+void testParallelDestroy()
+{
+    const size_t savedThreshold = xvc::parallel_destroy_threshold;
+    constexpr size_t n = 20000; // several chunks of the pool at 64 KiB each
+    constexpr size_t keep = n / 4;
+    std::vector<std::atomic<int>> destroyed(n);
+    Tracked::destroyed = &destroyed;
+
+    auto make = [](size_t count) {
+        XVector<Tracked> v;
+        v.reserve(count);
+        for (size_t i = 0; i < count; ++i) v.emplace_back(i);
+        return v;
+    };
+    // exactly the elements [first, last) were destroyed, times times each, since the last check
+    auto check = [&](size_t first, size_t last, int times = 1) {
+        bool ok = true;
+        for (size_t i = 0; i < n; ++i)
+            ok &= destroyed[i].exchange(0) == (i >= first && i < last ? times : 0);
+        CHECK(ok);
+    };
+
+    for (size_t threshold : { size_t(0), n - keep - 1, n - keep, n - keep + 1, n + 1, size_t(1) })
+    {
+        xvc::parallel_destroy_threshold = threshold;
+        Tracked::threads.clear();
+        {
+            XVector<Tracked> v = make(n);
+            v.resize(keep);
+            check(keep, n);
+            v.clear();
+            CHECK(v.empty());
+            check(0, keep);
+
+            const XVector<Tracked> shorter = make(keep / 2);
+            v = make(n);
+            v = shorter; // the first keep / 2 are assigned over, the rest destroyed
+            check(keep / 2, n);
+        }
+        check(0, keep / 2, 2); // v, now a copy of shorter, and shorter itself
+        { XVector<Tracked> v = make(n); }
+        check(0, n);
+
+        // the shrinking resize destroys n - keep elements, the rest n or more
+        const bool parallel = threshold != 0 && threshold <= n - keep;
+        if (threshold == 0 || threshold > n) CHECK(Tracked::threads.size() == 1);
+        else if (parallel && xvc::ThreadPool::global().concurrency() > 1) CHECK(Tracked::threads.size() > 1);
+    }
+
+    xvc::parallel_destroy_threshold = savedThreshold;
+    Tracked::destroyed = nullptr;
+}
+
+static_assert(!xvc::is_execution_policy_v<int>, "XVector(count, value) must not take the policy overloads");
+static_assert(xvc::is_execution_policy_v<const xvc::execution::parallel_policy&>, "policies are taken by reference");
+
+// each policy overload gives what the plain call gives, below two pool chunks where par stays on
+// the calling thread and at several chunks where it splits
+template<typename T, typename Policy>
+void testPolicyOverloads(Policy policy)
+{
+    const T value = iota<T>(7, 1)[0];
+    for (size_t n : { size_t(0), size_t(1), size_t(100), 3 * xvc::detail::parallelMinChunk<T>() + 5 })
+    {
+        const XVector<T> src = iota<T>(0, n);
+        const std::list<T> list(src.begin(), src.end());
+
+        CHECK(XVector<T>(policy, n, value) == XVector<T>(n, value));
+        CHECK(XVector<T>(policy, src) == src);
+        CHECK(XVector<T>(policy, src.begin(), src.end()) == src);
+        CHECK(XVector<T>(policy, list.begin(), list.end()) == src);
+
+        XVector<T> v = iota<T>(3, 10);
+        v.assign(policy, n, value);
+        CHECK(v == XVector<T>(n, value));
+        v.resize(policy, 2 * n + 1, value);
+        CHECK(v == XVector<T>(2 * n + 1, value));
+        v.resize(policy, n / 2);
+        CHECK(v.size() == n / 2);
+
+        XVector<T> joined = iota<T>(0, 0);
+        joined.concatenate(policy, src);
+        joined.concatenate(policy, src);
+        CHECK(joined.size() == 2 * n && std::equal(src.begin(), src.end(), joined.begin()) &&
+              std::equal(src.begin(), src.end(), joined.begin() + n));
+
+        // equal agrees with operator== on equal vectors, a different size and a difference at the
+        // front, in the middle and at the back, the last also inside the final chunk
+        CHECK(xvc::equal(policy, src, src) && xvc::equal(policy, src, XVector<T>(src)));
+        CHECK(!xvc::equal(policy, src, iota<T>(0, n + 1)));
+        for (size_t at : { size_t(0), n / 2, n - 1 })
+        {
+            if (at >= n) continue;
+            XVector<T> other = src;
+            other[at] = value;
+            CHECK(xvc::equal(policy, src, other) == (src == other));
+        }
+    }
+}
+
+// equal compares floating point as values: -0.0 equals 0.0 and NaN equals nothing, itself included
+template<typename Policy>
+void testPolicyEqualFloat(Policy policy)
+{
+    const size_t n = 3 * xvc::detail::parallelMinChunk<double>() + 5;
+    XVector<double> zeros(n, 0.0), negativeZeros(n, -0.0);
+    CHECK(xvc::equal(policy, zeros, negativeZeros));
+    zeros[n - 1] = std::numeric_limits<double>::quiet_NaN();
+    CHECK(!xvc::equal(policy, zeros, zeros));
+}
+
+void testExecutionPolicies()
+{
+    testPolicyOverloads<int>(xvc::seq);
+    testPolicyOverloads<int>(xvc::par);
+    testPolicyOverloads<int>(xvc::par_unseq);
+    testPolicyOverloads<std::string>(xvc::seq);
+    testPolicyOverloads<std::string>(xvc::par);
+    testPolicyOverloads<double>(xvc::par_unseq);
+    testPolicyEqualFloat(xvc::seq);
+    testPolicyEqualFloat(xvc::par);
+}
+
+// operator< and, under C++20, operator<=> against the std algorithms over the same elements
+template<typename T>
+void checkOrder(const XVector<T>& a, const XVector<T>& b)
+{
+    const bool less = std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+    const bool greater = std::lexicographical_compare(b.begin(), b.end(), a.begin(), a.end());
+    CHECK((a < b) == less && (a > b) == greater && (a <= b) == !greater && (a >= b) == !less);
+#if __cplusplus >= 202002L
+    CHECK((a <=> b) == std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end()));
+#endif
+}
+
+// equality and ordering on equal vectors, on prefixes of each other and on a single difference at
+// every position of lengths around the vector widths, where the kernels hand over to the tail
+template<typename T>
+void testComparisons()
+{
+    for (size_t length = 0; length <= 70; ++length)
+    {
+        const XVector<T> a = iota<T>(0, length);
+        XVector<T> longer = a;
+        longer.push_back(iota<T>(3, 1)[0]);
+        CHECK(a == a && !(a != a) && a != longer && !(a == longer));
+        checkOrder(a, a);
+        checkOrder(a, longer);
+        checkOrder(longer, a);
+
+        for (size_t at = 0; at < length; at += at < 3 || at + 4 > length ? 1 : 5)
+        {
+            XVector<T> b = a;
+            b[at] = iota<T>(1000, 1)[0];
+            CHECK(a != b && !(a == b));
+            checkOrder(a, b);
+            checkOrder(b, a);
+            b.pop_back();
+            checkOrder(a, b);
+        }
+    }
+}
+
+// float and double: -0.0 equals 0.0 and NaN equals nothing, so a vector holding one is not equal
+// to itself. in an ordering a NaN pair is neither less nor greater and passed over, as with std.
+template<typename T>
+void testFloatComparisons()
+{
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+    for (size_t length : { size_t(1), size_t(7), size_t(16), size_t(33), size_t(100) })
+    {
+        XVector<T> zeros(length, T(0.0)), negativeZeros(length, T(-0.0));
+        CHECK(zeros == negativeZeros && !(zeros < negativeZeros) && !(negativeZeros < zeros));
+
+        XVector<T> withNan = zeros;
+        withNan[length / 2] = nan;
+        CHECK(withNan != withNan && withNan != zeros);
+
+        XVector<T> greater = withNan;
+        greater.back() = T(1);
+        checkOrder(withNan, greater);
+        checkOrder(greater, withNan);
+        checkOrder(withNan, withNan);
+        if (length / 2 != length - 1) CHECK(withNan < greater && !(greater < withNan));
+#if __cplusplus >= 202002L
+        CHECK((withNan <=> withNan) == std::partial_ordering::unordered);
+        CHECK((zeros <=> negativeZeros) == std::partial_ordering::equivalent);
+#endif
+    }
+}
+
+// the streaming copy kernels at every destination alignment within a cache line, a few source
+// misalignments, and lengths around the unrolled loop and the prefetch distance
+template<typename Copy>
+void testStreamCopyKernel(Copy copy)
+{
+    constexpr size_t maxBytes = 2 * xvc::simd::streamPrefetchDistance + 300;
+    static unsigned char src[64 + maxBytes], buffer[64 + maxBytes + 64];
+    for (size_t i = 0; i < sizeof(src); ++i) src[i] = static_cast<unsigned char>(i * 7 + 1);
+
+    std::vector<size_t> lengths;
+    for (size_t n = 0; n <= 300; ++n) lengths.push_back(n);
+    for (size_t n : { size_t(1023), size_t(1024), size_t(1025), size_t(1088), maxBytes }) lengths.push_back(n);
+
+    for (size_t srcOffset : { 0, 1, 7, 33 })
+    {
+        for (size_t offset = 0; offset < 64; ++offset)
+        {
+            for (size_t bytes : lengths)
+            {
+                std::memset(buffer, 0xEE, sizeof(buffer));
+                copy(buffer + offset, src + srcOffset, bytes);
+
+                bool ok = std::memcmp(buffer + offset, src + srcOffset, bytes) == 0;
+                for (size_t i = 0; i < offset; ++i) ok &= buffer[i] == 0xEE;
+                for (size_t i = offset + bytes; i < sizeof(buffer); ++i) ok &= buffer[i] == 0xEE;
+                CHECK(ok);
+            }
+        }
+    }
+}
+
+// copies on either side of stream_copy_threshold and in every stream mode, and fills on either
+// side of simd_stream_threshold, give the same elements. the thresholds are lowered so that
+// small vectors cross them.
+void testStreaming()
+{
+    using namespace xvc::simd;
+    testStreamCopyKernel([](unsigned char* d, const unsigned char* s, size_t n) { streamCopy(d, s, n); });
+#if XVECTOR_SIMD_X86
+    const Isa isa = detectIsa();
+    if (isa >= Isa::sse2) testStreamCopyKernel(streamCopySse2);
+    if (isa >= Isa::avx2) testStreamCopyKernel(streamCopyAvx2);
+    if (isa >= Isa::avx512) testStreamCopyKernel(streamCopyAvx512);
+#endif
+
+    const size_t savedCopy = xvc::stream_copy_threshold;
+    const size_t savedFill = xvc::simd_stream_threshold;
+    const XVector<uint32_t> src = iota<uint32_t>(0, 1000);
+    const size_t bytes = src.size() * sizeof(uint32_t);
+    for (size_t threshold : { bytes - 1, bytes, bytes + 1 })
+    {
+        xvc::stream_copy_threshold = threshold;
+        for (xvc::StreamMode mode : { xvc::StreamMode::automatic, xvc::StreamMode::always, xvc::StreamMode::never })
+        {
+            XVector<uint32_t> from = src;
+            from.set_stream_mode(mode);
+            const XVector<uint32_t> copied(from);
+            XVector<uint32_t> assigned = iota<uint32_t>(5, 3);
+            assigned.set_stream_mode(mode);
+            assigned = from;
+            XVector<uint32_t> joined = iota<uint32_t>(0, 0);
+            joined.set_stream_mode(mode);
+            joined.concatenate(from);
+            joined.reserve(4096); // reallocates
+            CHECK(copied == src && assigned == src && joined == src);
+        }
+
+        xvc::simd_stream_threshold = threshold;
+        const XVector<uint32_t> filled(1000, 0xC0FFEEu);
+        CHECK(std::count(filled.begin(), filled.end(), 0xC0FFEEu) == 1000);
+    }
+    xvc::stream_copy_threshold = savedCopy;
+    xvc::simd_stream_threshold = savedFill;
+
+    // and at the default thresholds, a fill of 4 MiB streams
+    const XVector<uint64_t> large(size_t(1) << 19, 0x0123456789ABCDEFull);
+    CHECK(size_t(std::count(large.begin(), large.end(), 0x0123456789ABCDEFull)) == large.size());
+    const XVector<uint64_t> copy = large;
+    CHECK(copy == large);
+}
+
+int main()
+{
+    testConcatenateIntoEmpty();
+    testJoin<int>();
+    testJoin<std::string>();
+    testBatchInserterReuse<int>();
+    testBatchInserterReuse<std::string>();
+    testCopyExceptionSafety();
+    testInsertErase<int>();
+    testInsertErase<std::string>();
+    testAppend<int>();
+    testAppend<std::string>();
+    testUncheckedAppends<int>();
+    testUncheckedAppends<std::string>();
+    testRangeConstructor<int>();
+    testRangeConstructor<std::string>();
+    testFill();
+    testStreaming();
+    testParallelDestroy();
+    testExecutionPolicies();
+    testComparisons<int8_t>();
+    testComparisons<uint16_t>();
+    testComparisons<int32_t>();
+    testComparisons<uint64_t>();
+    testComparisons<float>();
+    testComparisons<double>();
+    testComparisons<std::string>();
+    testFloatComparisons<float>();
+    testFloatComparisons<double>();
+    return xtestFailures;
+}